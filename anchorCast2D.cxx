@@ -0,0 +1,67 @@
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkGrayscaleDilateImageFilter.h"
+#include "itkGrayscaleMorphologicalOpeningImageFilter.h"
+#include "itkFlatStructuringElement.h"
+#include "itkSimpleFilterWatcher.h"
+
+
+int main(int, char * argv[])
+{
+  const int dim = 2;
+  // the anchor and vHGW filters write their last pass directly in
+  // the output image, which has a different pixel type than the input
+  typedef float PType;
+  typedef itk::Image< PType, dim >    IType;
+  typedef unsigned char OPType;
+  typedef itk::Image< OPType, dim >    OIType;
+  
+  // read the input image
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+  
+  typedef itk::FlatStructuringElement<dim> SRType;
+  SRType::RadiusType radius;
+  radius.Fill( 4 );
+  SRType kernel = SRType::Box( radius );
+  
+  typedef itk::GrayscaleDilateImageFilter< IType, OIType, SRType > DilateType;
+  DilateType::Pointer dilate = DilateType::New();
+  dilate->SetInput( reader->GetOutput() );
+  dilate->SetKernel( kernel );
+  
+  itk::SimpleFilterWatcher watcher(dilate, "dilate");
+
+  typedef itk::GrayscaleMorphologicalOpeningImageFilter< IType, OIType, SRType > OpenType;
+  OpenType::Pointer open = OpenType::New();
+  open->SetInput( reader->GetOutput() );
+  open->SetKernel( kernel );
+  
+  itk::SimpleFilterWatcher watcher2(open, "open");
+
+  typedef itk::ImageFileWriter< OIType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+
+  writer->SetInput( dilate->GetOutput() );
+
+  dilate->SetAlgorithm( DilateType::ANCHOR );
+  writer->SetFileName( argv[2] );
+  writer->Update();
+
+  dilate->SetAlgorithm( DilateType::VHGW );
+  writer->SetFileName( argv[3] );
+  writer->Update();
+
+  writer->SetInput( open->GetOutput() );
+
+  open->SetAlgorithm( OpenType::ANCHOR );
+  writer->SetFileName( argv[4] );
+  writer->Update();
+
+  open->SetAlgorithm( OpenType::VHGW );
+  writer->SetFileName( argv[5] );
+  writer->Update();
+
+  return 0;
+}
@@ -0,0 +1,62 @@
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkGrayscaleDilateImageFilter.h"
+#include "itkGrayscaleErodeImageFilter.h"
+#include "itkFlatStructuringElement.h"
+#include "itkCastImageFilter.h"
+#include "itkSimpleFilterWatcher.h"
+
+
+int main(int, char * argv[])
+{
+  const int dim = 2;
+  // the real types use the monotonic wedge in the anchor filters
+  typedef float PType;
+  typedef itk::Image< PType, dim >    IType;
+  typedef unsigned char OPType;
+  typedef itk::Image< OPType, dim >    OIType;
+  
+  // read the input image
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+  
+  typedef itk::FlatStructuringElement<dim> SRType;
+  SRType::RadiusType radius;
+  radius.Fill( 4 );
+  SRType kernel = SRType::Box( radius );
+  
+  typedef itk::GrayscaleDilateImageFilter< IType, IType, SRType > DilateType;
+  DilateType::Pointer dilate = DilateType::New();
+  dilate->SetInput( reader->GetOutput() );
+  dilate->SetKernel( kernel );
+  dilate->SetAlgorithm( DilateType::ANCHOR );
+  
+  itk::SimpleFilterWatcher watcher(dilate, "dilate");
+
+  typedef itk::GrayscaleErodeImageFilter< IType, IType, SRType > ErodeType;
+  ErodeType::Pointer erode = ErodeType::New();
+  erode->SetInput( reader->GetOutput() );
+  erode->SetKernel( kernel );
+  erode->SetAlgorithm( ErodeType::ANCHOR );
+  
+  itk::SimpleFilterWatcher watcher2(erode, "erode");
+
+  typedef itk::CastImageFilter< IType, OIType > CastType;
+  CastType::Pointer cast = CastType::New();
+
+  typedef itk::ImageFileWriter< OIType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( cast->GetOutput() );
+
+  cast->SetInput( dilate->GetOutput() );
+  writer->SetFileName( argv[2] );
+  writer->Update();
+
+  cast->SetInput( erode->GetOutput() );
+  writer->SetFileName( argv[3] );
+  writer->Update();
+
+  return 0;
+}
+
@@ -0,0 +1,120 @@
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkCastImageFilter.h"
+#include "itkAnchorDilateImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkFlatStructuringElement.h"
+#include "itkSimpleFilterWatcher.h"
+
+
+// update the reused filter and a new one on the region, and compare their
+// outputs. The reused filter keeps its line objects and its buffers from
+// the previous updates.
+template< class TFilter >
+bool SameOutputsOnRegion( TFilter * filter, const typename TFilter::KernelType & kernel,
+                          const typename TFilter::OutputImageRegionType & region )
+{
+  typedef typename TFilter::OutputImageType ImageType;
+
+  typename TFilter::Pointer reference = TFilter::New();
+  reference->SetInput( filter->GetInput() );
+  reference->SetKernel( kernel );
+  reference->GetOutput()->SetRequestedRegion( region );
+  reference->Update();
+
+  // the output of the previous update may already contain the region
+  filter->Modified();
+  filter->GetOutput()->SetRequestedRegion( region );
+  filter->Update();
+
+  typedef itk::ImageRegionConstIterator< ImageType > IteratorType;
+  IteratorType refIt( reference->GetOutput(), region );
+  IteratorType it( filter->GetOutput(), region );
+  for( refIt.GoToBegin(), it.GoToBegin(); !refIt.IsAtEnd(); ++refIt, ++it )
+    {
+    if( refIt.Get() != it.Get() )
+      { return false; }
+    }
+  return true;
+}
+
+
+// run the filter on a small region, on the whole image, and then on the
+// small region again
+template< class TFilter >
+bool SameOutputsOnGrowingAndShrinkingRegions( TFilter * filter, const typename TFilter::KernelType & kernel )
+{
+  typedef typename TFilter::OutputImageRegionType RegionType;
+  filter->UpdateOutputInformation();
+  const RegionType largest = filter->GetOutput()->GetLargestPossibleRegion();
+
+  RegionType small = largest;
+  for( unsigned int i=0; i<RegionType::ImageDimension; i++ )
+    {
+    small.SetIndex( i, largest.GetIndex()[i] + largest.GetSize()[i] / 4 );
+    small.SetSize( i, largest.GetSize()[i] / 2 );
+    }
+
+  return SameOutputsOnRegion( filter, kernel, small )
+    && SameOutputsOnRegion( filter, kernel, largest )
+    && SameOutputsOnRegion( filter, kernel, small );
+}
+
+
+int main(int, char * argv[])
+{
+  const int dim = 2;
+  typedef unsigned char PType;
+  typedef itk::Image< PType, dim >    IType;
+
+  // read the input image
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+
+  typedef itk::FlatStructuringElement<dim> SRType;
+  SRType::RadiusType radius;
+  radius.Fill( 4 );
+  SRType kernel = SRType::Box( radius );
+
+  // the lines of 8 bits pixels use a vector based histogram
+  typedef itk::AnchorDilateImageFilter< IType, SRType > DilateType;
+  DilateType::Pointer dilate = DilateType::New();
+  dilate->SetInput( reader->GetOutput() );
+  dilate->SetKernel( kernel );
+
+  itk::SimpleFilterWatcher watcher(dilate, "dilate");
+
+  if( !SameOutputsOnGrowingAndShrinkingRegions( dilate.GetPointer(), kernel ) )
+    {
+    std::cerr << "the reused anchor dilation differs from a new one" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  typedef itk::ImageFileWriter< IType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( dilate->GetOutput() );
+  writer->SetFileName( argv[2] );
+  writer->UpdateLargestPossibleRegion();
+
+  // the lines of float pixels use the monotonic wedge
+  typedef itk::Image< float, dim > FloatImageType;
+  typedef itk::CastImageFilter< IType, FloatImageType > CastType;
+  CastType::Pointer cast = CastType::New();
+  cast->SetInput( reader->GetOutput() );
+
+  typedef itk::AnchorDilateImageFilter< FloatImageType, SRType > FloatDilateType;
+  FloatDilateType::Pointer floatDilate = FloatDilateType::New();
+  floatDilate->SetInput( cast->GetOutput() );
+  floatDilate->SetKernel( kernel );
+
+  itk::SimpleFilterWatcher watcher2(floatDilate, "floatDilate");
+
+  if( !SameOutputsOnGrowingAndShrinkingRegions( floatDilate.GetPointer(), kernel ) )
+    {
+    std::cerr << "the reused float anchor dilation differs from a new one" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return 0;
+}
@@ -0,0 +1,93 @@
+#include "itkImage.h"
+#include "itkImageRegionIterator.h"
+#include "itkMovingHistogramDilateImageFilter.h"
+#include "itkNeighborhood.h"
+#include <iostream>
+
+
+int main(int, char * [])
+{
+  const int dim = 3;
+  typedef unsigned char PType;
+  typedef itk::Image< PType, dim >    IType;
+
+  // a small volume, large enough for the cache lines to matter
+  IType::SizeType size;
+  size.Fill( 64 );
+  IType::Pointer image = IType::New();
+  image->SetRegions( size );
+  image->Allocate();
+  itk::ImageRegionIterator< IType > it( image, image->GetLargestPossibleRegion() );
+  PType v = 0;
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    it.Set( v );
+    v = v * 7 + 3;
+    }
+
+  // a neighborhood is never decomposed
+  typedef itk::Neighborhood<bool, dim> SRType;
+  typedef itk::MovingHistogramDilateImageFilter< IType, IType, SRType > DilateType;
+  DilateType::Pointer dilate = DilateType::New();
+  dilate->SetInput( image );
+  dilate->SetNumberOfThreads( 1 );
+
+  // flat along y: the translations along y add a lot of pixels, and
+  // along z a few pixels, but each of them in a different cache line
+  SRType kernel;
+  SRType::SizeType radius;
+  radius[0] = 4;
+  radius[1] = 0;
+  radius[2] = 6;
+  kernel.SetRadius( radius );
+  for( SRType::Iterator kit=kernel.Begin(); kit!=kernel.End(); kit++ )
+    { *kit = true; }
+  dilate->SetKernel( kernel );
+
+  // before an update, the axis with the smallest translations is used
+  if( dilate->GetPixelsPerTranslation() != 9 )
+    {
+    std::cerr << "wrong number of pixels per translation after SetKernel(): "
+              << dilate->GetPixelsPerTranslation() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // the 13 pixels added along x are mostly in the cache lines read at the
+  // previous position, while the 9 pixels added along z are in 4 new cache
+  // lines at each step: x is cheaper
+  dilate->Update();
+  if( dilate->GetAxes()[dim - 1] != 0 )
+    {
+    std::cerr << "the lines are not along x: " << dilate->GetAxes() << std::endl;
+    return EXIT_FAILURE;
+    }
+  if( dilate->GetPixelsPerTranslation() != 13 )
+    {
+    std::cerr << "wrong number of pixels per translation after Update(): "
+              << dilate->GetPixelsPerTranslation() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // longer along z: the 11 pixels and 4 new cache lines of the translations
+  // along z are now cheaper than the 21 pixels added along x
+  radius[0] = 5;
+  radius[2] = 10;
+  kernel.SetRadius( radius );
+  for( SRType::Iterator kit=kernel.Begin(); kit!=kernel.End(); kit++ )
+    { *kit = true; }
+  dilate->SetKernel( kernel );
+  dilate->Update();
+  if( dilate->GetAxes()[dim - 1] != 2 )
+    {
+    std::cerr << "the lines are not along z: " << dilate->GetAxes() << std::endl;
+    return EXIT_FAILURE;
+    }
+  if( dilate->GetPixelsPerTranslation() != 11 )
+    {
+    std::cerr << "wrong number of pixels per translation after Update(): "
+              << dilate->GetPixelsPerTranslation() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,89 @@
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkGrayscaleDilateImageFilter.h"
+#include "itkGrayscaleErodeImageFilter.h"
+#include "itkFlatStructuringElement.h"
+#include "itkSimpleFilterWatcher.h"
+
+
+int main(int, char * argv[])
+{
+  const int dim = 2;
+  typedef unsigned char PType;
+  typedef itk::Image< PType, dim >    IType;
+  
+  // read the input image
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+  
+  typedef itk::FlatStructuringElement<dim> SRType;
+  SRType::RadiusType radius;
+  radius.Fill( 4 );
+  SRType kernel = SRType::Box( radius );
+  
+  typedef itk::GrayscaleDilateImageFilter< IType, IType, SRType > DilateType;
+  DilateType::Pointer dilate = DilateType::New();
+  dilate->SetInput( reader->GetOutput() );
+  dilate->SetKernel( kernel );
+  dilate->SetAlgorithm( DilateType::CHORD );
+  
+  itk::SimpleFilterWatcher watcher(dilate, "dilate");
+
+  typedef itk::GrayscaleErodeImageFilter< IType, IType, SRType > ErodeType;
+  ErodeType::Pointer erode = ErodeType::New();
+  erode->SetInput( reader->GetOutput() );
+  erode->SetKernel( kernel );
+  erode->SetAlgorithm( ErodeType::CHORD );
+  
+  itk::SimpleFilterWatcher watcher2(erode, "erode");
+
+  typedef itk::ImageFileWriter< IType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( dilate->GetOutput() );
+  writer->SetFileName( argv[2] );
+  writer->Update();
+
+  writer->SetInput( erode->GetOutput() );
+  writer->SetFileName( argv[3] );
+  writer->Update();
+
+  // a large ball can't be decomposed: the chords must give the same
+  // result than the basic algorithm
+  radius.Fill( 15 );
+  dilate->SetKernel( SRType::Ball( radius ) );
+  writer->SetInput( dilate->GetOutput() );
+
+  // the chords are selected by SetKernel() for the large balls only
+  if( dilate->GetAlgorithm() != DilateType::CHORD )
+    {
+    std::cerr << "The chords should be used for a ball of radius 15." << std::endl;
+    return EXIT_FAILURE;
+    }
+  erode->SetKernel( SRType::Ball( radius ) );
+  if( erode->GetAlgorithm() != ErodeType::CHORD )
+    {
+    std::cerr << "The chords should be used for a ball of radius 15." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  SRType::RadiusType smallRadius;
+  smallRadius.Fill( 1 );
+  erode->SetKernel( SRType::Ball( smallRadius ) );
+  if( erode->GetAlgorithm() != ErodeType::HISTO )
+    {
+    std::cerr << "The histogram should be used for a ball of radius 1." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  dilate->SetAlgorithm( DilateType::BASIC );
+  writer->SetFileName( argv[4] );
+  writer->Update();
+
+  dilate->SetAlgorithm( DilateType::CHORD );
+  writer->SetFileName( argv[5] );
+  writer->Update();
+
+  return 0;
+}
+
@@ -0,0 +1,138 @@
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkGrayscaleDilateImageFilter.h"
+#include "itkGrayscaleErodeImageFilter.h"
+#include "itkColumnHistogramMorphologicalGradientImageFilter.h"
+#include "itkColumnHistogramRankImageFilter.h"
+#include "itkMovingHistogramRankImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkFlatStructuringElement.h"
+#include "itkSimpleFilterWatcher.h"
+
+
+int main(int, char * argv[])
+{
+  const int dim = 2;
+  typedef unsigned char PType;
+  typedef itk::Image< PType, dim >    IType;
+  
+  // read the input image
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+  
+  typedef itk::FlatStructuringElement<dim> SRType;
+  SRType::RadiusType radius;
+  radius.Fill( 4 );
+  SRType kernel = SRType::Box( radius );
+  
+  typedef itk::GrayscaleDilateImageFilter< IType, IType, SRType > DilateType;
+  DilateType::Pointer dilate = DilateType::New();
+  dilate->SetInput( reader->GetOutput() );
+  dilate->SetKernel( kernel );
+  dilate->SetAlgorithm( DilateType::COLUMN );
+  
+  itk::SimpleFilterWatcher watcher(dilate, "dilate");
+
+  typedef itk::GrayscaleErodeImageFilter< IType, IType, SRType > ErodeType;
+  ErodeType::Pointer erode = ErodeType::New();
+  erode->SetInput( reader->GetOutput() );
+  erode->SetKernel( kernel );
+  erode->SetAlgorithm( ErodeType::COLUMN );
+  
+  itk::SimpleFilterWatcher watcher2(erode, "erode");
+
+  typedef itk::ImageFileWriter< IType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( dilate->GetOutput() );
+  writer->SetFileName( argv[2] );
+  writer->Update();
+
+  writer->SetInput( erode->GetOutput() );
+  writer->SetFileName( argv[3] );
+  writer->Update();
+
+  typedef itk::ColumnHistogramMorphologicalGradientImageFilter< IType, IType, SRType > GradientType;
+  GradientType::Pointer gradient = GradientType::New();
+  gradient->SetInput( reader->GetOutput() );
+  gradient->SetKernel( kernel );
+  
+  itk::SimpleFilterWatcher watcher3(gradient, "gradient");
+
+  writer->SetInput( gradient->GetOutput() );
+  writer->SetFileName( argv[4] );
+  writer->Update();
+
+  typedef itk::ColumnHistogramRankImageFilter< IType, IType, SRType > RankType;
+  RankType::Pointer rank = RankType::New();
+  rank->SetInput( reader->GetOutput() );
+  rank->SetKernel( kernel );
+  rank->SetRank( 0.5 );
+  
+  itk::SimpleFilterWatcher watcher4(rank, "rank");
+
+  writer->SetInput( rank->GetOutput() );
+  writer->SetFileName( argv[5] );
+  writer->Update();
+
+  // the median must be the one of the moving histogram rank filter
+  typedef itk::MovingHistogramRankImageFilter< IType, IType, SRType > MovingRankType;
+  MovingRankType::Pointer movingRank = MovingRankType::New();
+  movingRank->SetInput( reader->GetOutput() );
+  movingRank->SetKernel( kernel );
+  movingRank->SetRank( 0.5 );
+  movingRank->Update();
+
+  typedef itk::ImageRegionConstIterator< IType > IteratorType;
+  IteratorType columnIt( rank->GetOutput(), rank->GetOutput()->GetBufferedRegion() );
+  IteratorType movingIt( movingRank->GetOutput(), movingRank->GetOutput()->GetBufferedRegion() );
+  for( columnIt.GoToBegin(), movingIt.GoToBegin(); !columnIt.IsAtEnd(); ++columnIt, ++movingIt )
+    {
+    if( columnIt.Get() != movingIt.Get() )
+      {
+      std::cerr << "the column and moving histogram medians differ" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // a large rectangle which can't be decomposed selects the column
+  // algorithm. The kernel of the box is decomposed in lines: use the anchor
+  // algorithm with it.
+  SRType rectangle;
+  radius.Fill( 20 );
+  rectangle.SetRadius( radius );
+  for( SRType::Iterator kit=rectangle.Begin(); kit!=rectangle.End(); ++kit )
+    { *kit = true; }
+  dilate->SetKernel( rectangle );
+  erode->SetKernel( rectangle );
+  if( dilate->GetAlgorithm() != DilateType::COLUMN || erode->GetAlgorithm() != ErodeType::COLUMN )
+    {
+    std::cerr << "the column algorithm is not selected for a large rectangle" << std::endl;
+    return EXIT_FAILURE;
+    }
+  // and a small one the moving histogram
+  radius.Fill( 2 );
+  rectangle.SetRadius( radius );
+  for( SRType::Iterator kit=rectangle.Begin(); kit!=rectangle.End(); ++kit )
+    { *kit = true; }
+  dilate->SetKernel( rectangle );
+  if( dilate->GetAlgorithm() != DilateType::HISTO )
+    {
+    std::cerr << "the column algorithm is selected for a small rectangle" << std::endl;
+    return EXIT_FAILURE;
+    }
+  radius.Fill( 4 );
+
+  // the column algorithm can't be used with a non rectangular kernel
+  try
+    {
+    dilate->SetKernel( SRType::Ball( radius ) );
+    dilate->SetAlgorithm( DilateType::COLUMN );
+    return EXIT_FAILURE;
+    }
+  catch( ... )
+    { std::cout << "exception succesfully catched" << std::endl; }
+
+  return 0;
+}
+
@@ -0,0 +1,99 @@
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkShiftScaleImageFilter.h"
+#include "itkGrayscaleDilateImageFilter.h"
+#include "itkGrayscaleErodeImageFilter.h"
+#include "itkMovingHistogramDilateImageFilter.h"
+#include "itkFlatStructuringElement.h"
+#include "itkSimpleFilterWatcher.h"
+
+
+int main(int, char * argv[])
+{
+  const int dim = 2;
+  typedef unsigned short PType;
+  typedef itk::Image< PType, dim >    IType;
+  
+  // read the input image
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+  
+  // use the full 16 bits range, so the histogram is sparse
+  typedef itk::ShiftScaleImageFilter< IType, IType > ScaleType;
+  ScaleType::Pointer scale = ScaleType::New();
+  scale->SetInput( reader->GetOutput() );
+  scale->SetScale( 257 );
+
+  typedef itk::FlatStructuringElement<dim> SRType;
+  SRType::RadiusType radius;
+  radius.Fill( 4 );
+  SRType kernel = SRType::Ball( radius);
+  
+  typedef itk::GrayscaleDilateImageFilter< IType, IType, SRType > DilateType;
+  DilateType::Pointer dilate = DilateType::New();
+  dilate->SetInput( scale->GetOutput() );
+  dilate->SetKernel( kernel );
+  
+  itk::SimpleFilterWatcher watcher(dilate, "filter");
+
+  typedef itk::GrayscaleErodeImageFilter< IType, IType, SRType > ErodeType;
+  ErodeType::Pointer erode = ErodeType::New();
+  erode->SetInput( scale->GetOutput() );
+  erode->SetKernel( kernel );
+  
+  itk::SimpleFilterWatcher watcher2(erode, "filter");
+
+  typedef itk::ImageFileWriter< IType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( dilate->GetOutput() );
+
+  dilate->SetAlgorithm( DilateType::BASIC );
+  writer->SetFileName( argv[2] );
+  writer->Update();
+
+  dilate->SetAlgorithm( DilateType::HISTO );
+  writer->SetFileName( argv[3] );
+  writer->Update();
+
+  writer->SetInput( erode->GetOutput() );
+
+  erode->SetAlgorithm( ErodeType::BASIC );
+  writer->SetFileName( argv[4] );
+  writer->Update();
+
+  erode->SetAlgorithm( ErodeType::HISTO );
+  writer->SetFileName( argv[5] );
+  writer->Update();
+
+  // the kernel is small enough for the 16 bits counters
+  if( !dilate->GetUseShortCounters() || !erode->GetUseShortCounters() )
+    {
+    std::cerr << "The 16 bits counters are not used with a small kernel." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // a kernel too large for the counters must be rejected
+  typedef itk::MovingHistogramDilateImageFilter< IType, IType, SRType, unsigned char > SmallCounterDilateType;
+  SmallCounterDilateType::Pointer small = SmallCounterDilateType::New();
+  small->SetInput( scale->GetOutput() );
+  radius.Fill( 10 );
+  small->SetKernel( SRType::Box( radius ) );
+  bool caught = false;
+  try
+    {
+    small->Update();
+    }
+  catch( itk::ExceptionObject & )
+    {
+    caught = true;
+    }
+  if( !caught )
+    {
+    std::cerr << "No exception with a kernel too large for the counters." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return 0;
+}
+
@@ -0,0 +1,100 @@
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkInvertIntensityImageFilter.h"
+#include "itkBinaryThresholdImageFilter.h"
+#include "itkMovingHistogramDilateImageFilter.h"
+#include "itkMaskedMovingHistogramDilateImageFilter.h"
+#include "itkColumnHistogramDilateImageFilter.h"
+#include "itkFlatStructuringElement.h"
+#include "itkSimpleFilterWatcher.h"
+
+
+// The histograms are kept in the pool of the filter between the updates.
+// Each filter is first run on the inverted image with a larger kernel, so
+// the pooled histograms contain other values than the ones of the second
+// run: the output of the second run must be the one of a new filter.
+int main(int, char * argv[])
+{
+  const int dim = 2;
+  typedef unsigned char PType;
+  typedef itk::Image< PType, dim >    IType;
+  
+  // read the input image
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+  
+  typedef itk::InvertIntensityImageFilter< IType, IType > InvertType;
+  InvertType::Pointer invert = InvertType::New();
+  invert->SetInput( reader->GetOutput() );
+
+  typedef itk::BinaryThresholdImageFilter< IType, IType > ThresholdType;
+  ThresholdType::Pointer fullMask = ThresholdType::New();
+  fullMask->SetInput( reader->GetOutput() );
+  fullMask->SetLowerThreshold( 0 );
+  fullMask->SetUpperThreshold( 255 );
+
+  typedef itk::FlatStructuringElement<dim> SRType;
+  SRType::RadiusType radius;
+  radius.Fill( 6 );
+  SRType firstKernel = SRType::Box( radius );
+  radius.Fill( 4 );
+  SRType kernel = SRType::Box( radius );
+  
+  typedef itk::ImageFileWriter< IType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+
+  typedef itk::MovingHistogramDilateImageFilter< IType, IType, SRType > DilateType;
+  DilateType::Pointer dilate = DilateType::New();
+  dilate->SetNumberOfThreads( 2 );
+  dilate->SetInput( invert->GetOutput() );
+  dilate->SetKernel( firstKernel );
+  dilate->Update();
+  dilate->SetInput( reader->GetOutput() );
+  dilate->SetKernel( kernel );
+
+  itk::SimpleFilterWatcher watcher(dilate, "dilate");
+
+  writer->SetInput( dilate->GetOutput() );
+  writer->SetFileName( argv[2] );
+  writer->Update();
+
+  // the histograms are allocated again after a release
+  dilate->ReleaseScratchMemory();
+  dilate->Modified();
+  writer->SetFileName( argv[3] );
+  writer->Update();
+
+  typedef itk::MaskedMovingHistogramDilateImageFilter< IType, IType, IType, SRType > MaskedDilateType;
+  MaskedDilateType::Pointer masked = MaskedDilateType::New();
+  masked->SetNumberOfThreads( 2 );
+  masked->SetInput( invert->GetOutput() );
+  masked->SetMaskImage( fullMask->GetOutput() );
+  masked->SetKernel( firstKernel );
+  masked->Update();
+  masked->SetInput( reader->GetOutput() );
+  masked->SetKernel( kernel );
+
+  itk::SimpleFilterWatcher watcher2(masked, "masked");
+
+  writer->SetInput( masked->GetOutput() );
+  writer->SetFileName( argv[4] );
+  writer->Update();
+
+  typedef itk::ColumnHistogramDilateImageFilter< IType, IType, SRType > ColumnDilateType;
+  ColumnDilateType::Pointer column = ColumnDilateType::New();
+  column->SetNumberOfThreads( 2 );
+  column->SetInput( invert->GetOutput() );
+  column->SetKernel( firstKernel );
+  column->Update();
+  column->SetInput( reader->GetOutput() );
+  column->SetKernel( kernel );
+
+  itk::SimpleFilterWatcher watcher3(column, "column");
+
+  writer->SetInput( column->GetOutput() );
+  writer->SetFileName( argv[5] );
+  writer->Update();
+
+  return 0;
+}
@@ -5,14 +5,14 @@
 
 namespace itk {
 
-template<class TImage, class TKernel>
+template<class TImage, class TKernel, class TOutputImage = TImage>
 class  ITK_EXPORT AnchorCloseImageFilter :
-    public AnchorOpenCloseImageFilter<TImage, TKernel, std::greater<typename TImage::PixelType>, std::less<typename TImage::PixelType>, std::greater_equal<typename TImage::PixelType>, std::less_equal<typename TImage::PixelType> >
+    public AnchorOpenCloseImageFilter<TImage, TKernel, std::greater<typename TImage::PixelType>, std::less<typename TImage::PixelType>, std::greater_equal<typename TImage::PixelType>, std::less_equal<typename TImage::PixelType>, TOutputImage >
 
 {
 public:
   typedef AnchorCloseImageFilter Self;
-  typedef AnchorOpenCloseImageFilter<TImage, TKernel, std::greater<typename TImage::PixelType>, std::less<typename TImage::PixelType>, std::greater_equal<typename TImage::PixelType>, std::less_equal<typename TImage::PixelType> > Superclass;
+  typedef AnchorOpenCloseImageFilter<TImage, TKernel, std::greater<typename TImage::PixelType>, std::less<typename TImage::PixelType>, std::greater_equal<typename TImage::PixelType>, std::less_equal<typename TImage::PixelType>, TOutputImage > Superclass;
 
   typedef SmartPointer<Self>   Pointer;
   typedef SmartPointer<const Self>  ConstPointer;
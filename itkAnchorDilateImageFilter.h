@@ -5,14 +5,14 @@
 
 namespace itk {
 
-template<class TImage, class TKernel>
+template<class TImage, class TKernel, class TOutputImage = TImage>
 class  ITK_EXPORT AnchorDilateImageFilter :
-    public AnchorErodeDilateImageFilter<TImage, TKernel, std::greater<typename TImage::PixelType>, std::greater_equal<typename TImage::PixelType> >
+    public AnchorErodeDilateImageFilter<TImage, TKernel, std::greater<typename TImage::PixelType>, std::greater_equal<typename TImage::PixelType>, TOutputImage >
 
 {
 public:
   typedef AnchorDilateImageFilter Self;
-  typedef AnchorErodeDilateImageFilter<TImage, TKernel, std::less<typename TImage::PixelType>, std::greater_equal<typename TImage::PixelType> > Superclass;
+  typedef AnchorErodeDilateImageFilter<TImage, TKernel, std::greater<typename TImage::PixelType>, std::greater_equal<typename TImage::PixelType>, TOutputImage > Superclass;
 
   /** Runtime information support. */
   itkTypeMacro(AnchorDilateImageFilter, 
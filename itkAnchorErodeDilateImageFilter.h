@@ -4,7 +4,9 @@
 #include "itkImageToImageFilter.h"
 #include "itkProgressReporter.h"
 #include "itkAnchorErodeDilateLine.h"
+#include "itkAnchorErodeDilateWedgeLine.h"
 #include "itkBresenhamLine.h"
+#include "itkMorphologyScratchArena.h"
 
 namespace itk {
 
@@ -16,17 +18,19 @@ namespace itk {
  * The SetBoundary facility isn't necessary for operation of the
  * anchor method but is included for compatability with other
  * morphology classes in itk.
+ * The last pass of the decomposition is written directly in the
+ * output, with a conversion to the pixel type of TOutputImage.
 
 **/
 template<class TImage, class TKernel, 
-	 class TFunction1, class TFunction2>
+	 class TFunction1, class TFunction2, class TOutputImage = TImage>
 class ITK_EXPORT AnchorErodeDilateImageFilter :
-    public ImageToImageFilter<TImage, TImage>
+    public ImageToImageFilter<TImage, TOutputImage>
 {
 public:
   /** Standard class typedefs. */
   typedef AnchorErodeDilateImageFilter Self;
-  typedef ImageToImageFilter<TImage, TImage>
+  typedef ImageToImageFilter<TImage, TOutputImage>
   Superclass;
   typedef SmartPointer<Self>        Pointer;
   typedef SmartPointer<const Self>  ConstPointer;
@@ -43,11 +47,15 @@ public:
   typedef typename TImage::IndexType         IndexType;
   typedef typename TImage::SizeType          SizeType;
 
+  typedef TOutputImage OutputImageType;
+  typedef typename OutputImageType::RegionType     OutputImageRegionType;
+  typedef typename OutputImageType::PixelType      OutputImagePixelType;
+
   /** ImageDimension constants */
   itkStaticConstMacro(InputImageDimension, unsigned int,
                       TImage::ImageDimension);
   itkStaticConstMacro(OutputImageDimension, unsigned int,
-                      TImage::ImageDimension);
+                      TOutputImage::ImageDimension);
 
   /** Standard New method. */
   itkNewMacro(Self);
@@ -56,23 +64,35 @@ public:
   itkTypeMacro(AnchorErodeDilateImageFilter,
                ImageToImageFilter);
 
-  void SetKernel( const KernelType& kernel )
-  {
-    m_Kernel=kernel;
-    m_KernelSet = true;
-  }
+  /** Set the kernel, and select the width of the counters of the line
+   * histograms from the length of the longest line of its decomposition. */
+  void SetKernel( const KernelType& kernel );
+
+  /** Get whether the line histograms use 16 bits counters. They halve the
+   * memory of the histograms of the 16 bits images. */
+  itkGetMacro(UseShortCounters, bool);
 
   /** Set/Get the boundary value. */
   void SetBoundary( const InputImagePixelType value );
   itkGetMacro(Boundary, InputImagePixelType);
 
+  /** Free the internal image, the line buffers and the line objects kept
+   * between the updates. They are allocated again by the next update. */
+  void ReleaseScratchMemory()
+    {
+    m_Scratch.Release();
+    }
+
 protected:
   AnchorErodeDilateImageFilter();
   ~AnchorErodeDilateImageFilter() {};
   void PrintSelf(std::ostream& os, Indent indent) const;
 
+  /** Make room for the working memory of the threads */
+  void BeforeThreadedGenerateData();
+
   /** Multi-thread version GenerateData. */
-  void  ThreadedGenerateData (const InputImageRegionType& outputRegionForThread,
+  void  ThreadedGenerateData (const OutputImageRegionType& outputRegionForThread,
                               int threadId) ;
 
   /** GrayscaleMorphologicalOpeningImageFilter need to make sure they request enough of an
@@ -91,10 +111,42 @@ private:
 
   TKernel m_Kernel;
   bool m_KernelSet;
+  bool m_UseShortCounters;
   typedef BresenhamLine<TImage::ImageDimension> BresType;
 
-  // the class that operates on lines
-  typedef AnchorErodeDilateLine<InputImagePixelType, TFunction1, TFunction2> AnchorLineType;
+  // the class that operates on lines: the anchor line with a vector based
+  // histogram, or the monotonic wedge for the other pixel types. The
+  // vector based histogram exists with 32 bits and 16 bits counters.
+  typedef typename AnchorErodeDilateLineTraits<InputImagePixelType, TFunction1, TFunction2>::LineType AnchorLineType;
+  typedef typename AnchorHistogramTraits<InputImagePixelType, TFunction1, unsigned short>::HistogramType ShortHistogramType;
+  typedef typename AnchorErodeDilateLineTraits<InputImagePixelType, TFunction1, TFunction2, ShortHistogramType>::LineType ShortAnchorLineType;
+
+  // the line objects of a thread. The vector based histograms are
+  // allocated by their constructor, so only the line with the counters
+  // used by the kernel is created, by the first update which needs it.
+  struct ThreadLines
+    {
+    std::vector< AnchorLineType > m_Line;
+    std::vector< ShortAnchorLineType > m_ShortLine;
+    };
+
+  template <class TLine>
+  static TLine & GetThreadLine( std::vector< TLine > & line )
+    {
+    if( line.empty() )
+      { line.resize( 1 ); }
+    return line[0];
+    }
+
+  // the internal image, the line buffers and the line objects of the
+  // threads
+  MorphologyScratchArena<TImage, 2, ThreadLines> m_Scratch;
+
+  /** Process the lines of the decomposition on the region of a thread with
+   * the given line object. */
+  template <class TLine>
+  void ThreadedGenerateDataWithLine(const OutputImageRegionType& outputRegionForThread,
+                                    int threadId, TLine & AnchorLine);
 
 } ; // end of class
 
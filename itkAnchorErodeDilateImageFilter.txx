@@ -7,27 +7,63 @@
 //#include "itkNeighborhoodAlgorithm.h"
 
 #include "itkAnchorUtilities.h"
+#include <algorithm>
 namespace itk {
 
-template <class TImage, class TKernel, class TFunction1, class TFunction2>
-AnchorErodeDilateImageFilter<TImage, TKernel, TFunction1, TFunction2>
+template <class TImage, class TKernel, class TFunction1, class TFunction2, class TOutputImage>
+AnchorErodeDilateImageFilter<TImage, TKernel, TFunction1, TFunction2, TOutputImage>
 ::AnchorErodeDilateImageFilter()
 {
   m_KernelSet = false;
+  m_UseShortCounters = false;
 }
 
-template <class TImage, class TKernel, class TFunction1, class TFunction2>
+template <class TImage, class TKernel, class TFunction1, class TFunction2, class TOutputImage>
 void
-AnchorErodeDilateImageFilter<TImage, TKernel, TFunction1, TFunction2>
+AnchorErodeDilateImageFilter<TImage, TKernel, TFunction1, TFunction2, TOutputImage>
+::SetKernel(const KernelType& kernel)
+{
+  m_Kernel = kernel;
+  m_KernelSet = true;
+
+  // a line histogram holds at most the pixels of the longest line plus
+  // the extreme value carried from the previous window. The 16 bits
+  // counters are only useful for the vector based histograms.
+  const typename KernelType::DecompType & decomposition = m_Kernel.GetLines();
+  unsigned long maximumCount = 0;
+  for (unsigned i = 0; i < decomposition.size(); i++)
+    {
+    unsigned long SELength = getLinePixels<typename KernelType::LType>(decomposition[i]);
+    if (!(SELength%2))
+      ++SELength;
+    maximumCount = std::max(maximumCount, SELength + 2);
+    }
+  typedef typename AnchorHistogramTraits<InputImagePixelType, TFunction1>::HistogramType HistogramType;
+  m_UseShortCounters = ShortHistogramType::GetCountLimit() < HistogramType::GetCountLimit()
+    && maximumCount <= ShortHistogramType::GetCountLimit();
+  this->Modified();
+}
+
+template <class TImage, class TKernel, class TFunction1, class TFunction2, class TOutputImage>
+void
+AnchorErodeDilateImageFilter<TImage, TKernel, TFunction1, TFunction2, TOutputImage>
 ::SetBoundary(const InputImagePixelType value)
 {
   m_Boundary = value;
 }
 
-template <class TImage, class TKernel, class TFunction1, class TFunction2>
+template <class TImage, class TKernel, class TFunction1, class TFunction2, class TOutputImage>
 void
-AnchorErodeDilateImageFilter<TImage, TKernel, TFunction1, TFunction2>
-::ThreadedGenerateData (const InputImageRegionType& outputRegionForThread,
+AnchorErodeDilateImageFilter<TImage, TKernel, TFunction1, TFunction2, TOutputImage>
+::BeforeThreadedGenerateData()
+{
+  m_Scratch.SetNumberOfThreads(this->GetNumberOfThreads());
+}
+
+template <class TImage, class TKernel, class TFunction1, class TFunction2, class TOutputImage>
+void
+AnchorErodeDilateImageFilter<TImage, TKernel, TFunction1, TFunction2, TOutputImage>
+::ThreadedGenerateData (const OutputImageRegionType& outputRegionForThread,
 			int threadId)
 {
 
@@ -45,15 +81,35 @@ AnchorErodeDilateImageFilter<TImage, TKernel, TFunction1, TFunction2>
   // TFunction1 will be < for erosions
   // TFunction2 will be <=
 
-  AnchorLineType AnchorLine;
+  // the width of the counters has been chosen in SetKernel(). The line
+  // objects are kept between the updates, with their histogram.
+  ThreadLines & lines = m_Scratch.GetThreadObject(threadId);
+  if (m_UseShortCounters)
+    {
+    this->template ThreadedGenerateDataWithLine<ShortAnchorLineType>(outputRegionForThread, threadId,
+                                                                     GetThreadLine(lines.m_ShortLine));
+    }
+  else
+    {
+    this->template ThreadedGenerateDataWithLine<AnchorLineType>(outputRegionForThread, threadId,
+                                                                GetThreadLine(lines.m_Line));
+    }
+}
 
+template <class TImage, class TKernel, class TFunction1, class TFunction2, class TOutputImage>
+template <class TLine>
+void
+AnchorErodeDilateImageFilter<TImage, TKernel, TFunction1, TFunction2, TOutputImage>
+::ThreadedGenerateDataWithLine (const OutputImageRegionType& outputRegionForThread,
+				int threadId, TLine & AnchorLine)
+{
   // the initial version will adopt the methodology of loading a line
   // at a time into a buffer vector, carrying out the opening or
   // closing, and then copy the result to the output. Hopefully this
   // will improve cache performance when working along non raster
   // directions.
 
-  ProgressReporter progress(this, threadId, m_Kernel.GetLines().size() + 1);
+  ProgressReporter progress(this, threadId, m_Kernel.GetLines().size());
 
   InputImageConstPointer input = this->GetInput();
 
@@ -61,14 +117,8 @@ AnchorErodeDilateImageFilter<TImage, TKernel, TFunction1, TFunction2>
   IReg.PadByRadius( m_Kernel.GetRadius() );
   IReg.Crop( this->GetInput()->GetRequestedRegion() );
 
-   // allocate an internal buffer
-  typename InputImageType::Pointer internalbuffer = InputImageType::New();
-  internalbuffer->SetRegions(IReg);
-  internalbuffer->Allocate();
-  InputImagePointer output = internalbuffer;
-
   // get the region size
-  InputImageRegionType OReg = outputRegionForThread;
+  OutputImageRegionType OReg = outputRegionForThread;
   // maximum buffer length is sum of dimensions
   unsigned int bufflength = 0;
   for (unsigned i = 0; i<TImage::ImageDimension; i++)
@@ -80,17 +130,27 @@ AnchorErodeDilateImageFilter<TImage, TKernel, TFunction1, TFunction2>
   bufflength += 2;
 
 
-  InputImagePixelType * buffer = new InputImagePixelType[bufflength];
-  InputImagePixelType * inbuffer = new InputImagePixelType[bufflength];
+  InputImagePixelType * buffer = m_Scratch.GetLine(threadId, 0, bufflength);
+  InputImagePixelType * inbuffer = m_Scratch.GetLine(threadId, 1, bufflength);
 
   // iterate over all the structuring elements
   typename KernelType::DecompType decomposition = m_Kernel.GetLines();
   BresType BresLine;
 
+  // all the passes but the last one are done in the internal buffer.
+  // The internal buffer and the line buffers are kept between the
+  // updates: they are only allocated when the region grows
+  InputImagePointer internalbuffer;
+  if (decomposition.size() > 1)
+    {
+    internalbuffer = m_Scratch.GetImage(threadId, IReg);
+    }
+
   for (unsigned i = 0; i < decomposition.size(); i++)
     {
     typename KernelType::LType ThisLine = decomposition[i];
-    typename BresType::OffsetArray TheseOffsets = BresLine.buildLine(ThisLine, bufflength);
+    typename BresType::LineConstPointer TheseLine = BresLine.buildLine(ThisLine, bufflength);
+    const typename BresType::OffsetArray & TheseOffsets = TheseLine->GetValue();
     unsigned int SELength = getLinePixels<typename KernelType::LType>(ThisLine);
     // want lines to be odd
     if (!(SELength%2))
@@ -100,40 +160,37 @@ AnchorErodeDilateImageFilter<TImage, TKernel, TFunction1, TFunction2>
 
     AnchorLine.SetSize(SELength);
 
-    doFace<TImage, BresType, AnchorLineType, typename KernelType::LType>(input, output, m_Boundary, ThisLine, AnchorLine, 
-									   TheseOffsets, inbuffer, buffer, IReg, BigFace);
-    // after the first pass the input will be taken from the output
-    input = internalbuffer;
+    if (i + 1 < decomposition.size())
+      {
+      doFace<TImage, BresType, TLine, typename KernelType::LType, TImage>(input, internalbuffer, IReg, m_Boundary, ThisLine, AnchorLine, 
+										    TheseOffsets, inbuffer, buffer, IReg, BigFace);
+      // after the first pass the input will be taken from the output
+      input = internalbuffer;
+      }
+    else
+      {
+      // the last pass writes the pixels of the region of the thread
+      // directly in the output
+      doFace<TImage, BresType, TLine, typename KernelType::LType, TOutputImage>(input, this->GetOutput(), OReg, m_Boundary, ThisLine, AnchorLine, 
+											  TheseOffsets, inbuffer, buffer, IReg, BigFace);
+      }
     progress.CompletedPixel();
     }
-
-
-  // copy internal buffer to output
-  typedef typename itk::ImageRegionIterator<InputImageType> IterType;
-  IterType oit(this->GetOutput(), OReg);
-  IterType iit(internalbuffer, OReg);
-  for (oit.GoToBegin(), iit.GoToBegin(); !oit.IsAtEnd(); ++oit, ++iit)
-    {
-    oit.Set(iit.Get());
-    }
-  progress.CompletedPixel();
-  delete [] buffer;
-  delete [] inbuffer;
 }
 
 
-template<class TImage, class TKernel, class TFunction1, class TFunction2>
+template<class TImage, class TKernel, class TFunction1, class TFunction2, class TOutputImage>
 void
-AnchorErodeDilateImageFilter<TImage, TKernel, TFunction1, TFunction2>
+AnchorErodeDilateImageFilter<TImage, TKernel, TFunction1, TFunction2, TOutputImage>
 ::PrintSelf(std::ostream &os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
 }
 
 
-template <class TImage, class TKernel, class TFunction1, class TFunction2>
+template <class TImage, class TKernel, class TFunction1, class TFunction2, class TOutputImage>
 void
-AnchorErodeDilateImageFilter<TImage, TKernel, TFunction1, TFunction2>
+AnchorErodeDilateImageFilter<TImage, TKernel, TFunction1, TFunction2, TOutputImage>
 ::GenerateInputRequestedRegion()
 {
   // call the superclass' implementation of this method
@@ -16,7 +16,8 @@ namespace itk {
  * proportion of the time.
 
 **/
-template<class TInputPix, class TFunction1, class TFunction2>
+template<class TInputPix, class TFunction1, class TFunction2,
+	 class THistogram = typename AnchorHistogramTraits<TInputPix, TFunction1>::HistogramType>
 class ITK_EXPORT AnchorErodeDilateLine
 {
 public:
@@ -29,6 +30,9 @@ public:
   void SetSize(unsigned int size)
   {
     m_Size = size;
+    // a window of the line, plus the extreme value carried from the
+    // previous window
+    m_Histo.SetMaximumCount(size + 2);
   }
   //itkGetConstReferenceMacro(Size, unsigned int);
 
@@ -37,7 +41,7 @@ public:
 
   void PrintSelf(std::ostream &os, Indent indent) const;
   AnchorErodeDilateLine();
-  ~AnchorErodeDilateLine() {delete m_Histo;};
+  ~AnchorErodeDilateLine() {};
 
 
 private:
@@ -45,11 +49,9 @@ private:
   TFunction1 m_TF1;
   TFunction2 m_TF2;
 
-  bool m_useVec;
-
-  typedef MorphologyHistogram<InputImagePixelType> Histogram;
-  typedef MorphologyHistogramVec<InputImagePixelType,TFunction1> VHistogram;
-  typedef MorphologyHistogramMap<InputImagePixelType,TFunction1> MHistogram;
+  // the histogram is selected at compile time, so its methods can be
+  // inlined in the line loops
+  typedef THistogram Histogram;
 
   bool startLine(InputImagePixelType * buffer,
 		 InputImagePixelType * inbuffer,
@@ -71,18 +73,7 @@ private:
 		  int &inRightP,
 		  int middle, unsigned bufflength);
 
-  bool useVectorBasedHistogram()
-  {
-    // bool, short and char are acceptable for vector based algorithm: they do not require
-    // too much memory. Other types are not usable with that algorithm
-    return typeid(InputImagePixelType) == typeid(unsigned char)
-        || typeid(InputImagePixelType) == typeid(signed char)
-        || typeid(InputImagePixelType) == typeid(unsigned short)
-        || typeid(InputImagePixelType) == typeid(signed short)
-        || typeid(InputImagePixelType) == typeid(bool);
-    }
-
-  Histogram * m_Histo;
+  Histogram m_Histo;
 
 } ; // end of class
 
@@ -5,25 +5,16 @@
 
 namespace itk {
 
-template <class TInputPix, class TFunction1, class TFunction2>
-AnchorErodeDilateLine<TInputPix, TFunction1, TFunction2>
+template <class TInputPix, class TFunction1, class TFunction2, class THistogram>
+AnchorErodeDilateLine<TInputPix, TFunction1, TFunction2, THistogram>
 ::AnchorErodeDilateLine()
 {
   m_Size=2;
-  // create a histogram
-  if (useVectorBasedHistogram())
-    {
-    m_Histo = new VHistogram;
-    } 
-  else
-    {
-    m_Histo = new MHistogram;
-    }
 }
 
-template <class TInputPix, class TFunction1, class TFunction2>
+template <class TInputPix, class TFunction1, class TFunction2, class THistogram>
 void
-AnchorErodeDilateLine<TInputPix, TFunction1, TFunction2>
+AnchorErodeDilateLine<TInputPix, TFunction1, TFunction2, THistogram>
 ::doLine(InputImagePixelType * buffer, InputImagePixelType * inbuffer, unsigned bufflength)
 {
   // TFunction1 will be < for erosions
@@ -43,7 +34,7 @@ AnchorErodeDilateLine<TInputPix, TFunction1, TFunction2>
     InputImagePixelType Extreme = inbuffer[0];
     for (unsigned i = 0;i < bufflength;i++) 
       {
-      if (m_TF1(Extreme, inbuffer[i]))
+      if (m_TF1(inbuffer[i], Extreme))
 	Extreme = inbuffer[i];
       }
 
@@ -60,19 +51,19 @@ AnchorErodeDilateLine<TInputPix, TFunction1, TFunction2>
   int outLeftP = 0, outRightP = (int)bufflength - 1;
   int inLeftP = 0, inRightP = (int)bufflength - 1;
   InputImagePixelType Extreme;
-  m_Histo->Reset();
+  m_Histo.Reset();
   if (bufflength <= m_Size)
     {
     // basically a standard histogram method
     // Left border, first half of structuring element
     Extreme = inbuffer[inLeftP];
-    m_Histo->AddPixel(Extreme);
+    m_Histo.AddPixel(Extreme);
     for (int i = 0; (i < middle); i++)
       {
       ++inLeftP;
       assert(inLeftP >= 0);
       assert(inLeftP < (int)bufflength);
-      m_Histo->AddPixel(inbuffer[inLeftP]);
+      m_Histo.AddPixel(inbuffer[inLeftP]);
       if (m_TF1(inbuffer[inLeftP], Extreme))
 	{
 	Extreme = inbuffer[inLeftP];
@@ -91,7 +82,7 @@ AnchorErodeDilateLine<TInputPix, TFunction1, TFunction2>
 	{
 	assert(inLeftP >= 0);
 	assert(inLeftP < (int)bufflength);
-	m_Histo->AddPixel(inbuffer[inLeftP]);
+	m_Histo.AddPixel(inbuffer[inLeftP]);
 	if (m_TF1(inbuffer[inLeftP], Extreme))
 	  {
 	  Extreme = inbuffer[inLeftP];
@@ -106,8 +97,8 @@ AnchorErodeDilateLine<TInputPix, TFunction1, TFunction2>
     int left = 0;
     for (;outLeftP < (int)bufflength;outLeftP++, left++)
       {
-      m_Histo->RemovePixel(inbuffer[left]);
-      Extreme = m_Histo->GetValue();
+      m_Histo.RemovePixel(inbuffer[left]);
+      Extreme = m_Histo.GetValue();
       assert(outLeftP >= 0);
       assert(outLeftP < (int)bufflength);
       buffer[outLeftP] = Extreme;
@@ -118,13 +109,13 @@ AnchorErodeDilateLine<TInputPix, TFunction1, TFunction2>
 
   // Left border, first half of structuring element
   Extreme = inbuffer[inLeftP];
-  m_Histo->AddPixel(Extreme);
+  m_Histo.AddPixel(Extreme);
   for (int i = 0; (i < middle); i++)
     {
     ++inLeftP;
     assert(inLeftP >= 0);
     assert(inLeftP < (int)bufflength);
-    m_Histo->AddPixel(inbuffer[inLeftP]);
+    m_Histo.AddPixel(inbuffer[inLeftP]);
     if (m_TF1(inbuffer[inLeftP], Extreme))
       {
       Extreme = inbuffer[inLeftP];
@@ -141,7 +132,7 @@ AnchorErodeDilateLine<TInputPix, TFunction1, TFunction2>
     ++outLeftP;
     assert(inLeftP >= 0);
     assert(inLeftP < (int)bufflength);
-    m_Histo->AddPixel(inbuffer[inLeftP]);
+    m_Histo.AddPixel(inbuffer[inLeftP]);
     if (m_TF1(inbuffer[inLeftP], Extreme))
       {
       Extreme = inbuffer[inLeftP];
@@ -160,11 +151,11 @@ AnchorErodeDilateLine<TInputPix, TFunction1, TFunction2>
     assert((inLeftP - (int)m_Size) >= 0);
     assert((inLeftP - (int)m_Size) < (int)bufflength);
 
-    m_Histo->RemovePixel(inbuffer[inLeftP - (int)m_Size]);
+    m_Histo.RemovePixel(inbuffer[inLeftP - (int)m_Size]);
     assert(inLeftP >= 0);
     assert(inLeftP < (int)bufflength);
-    m_Histo->AddPixel(inbuffer[inLeftP]);
-    Extreme = m_Histo->GetValue();
+    m_Histo.AddPixel(inbuffer[inLeftP]);
+    Extreme = m_Histo.GetValue();
     assert(outLeftP >= 0);
     assert(outLeftP < (int)bufflength);
     buffer[outLeftP] = Extreme;
@@ -173,14 +164,14 @@ AnchorErodeDilateLine<TInputPix, TFunction1, TFunction2>
   assert(outLeftP < (int)bufflength);
   Extreme = buffer[outLeftP];
 
-  while (startLine(buffer, inbuffer, Extreme, *m_Histo, outLeftP, outRightP, inLeftP, inRightP, middle, bufflength)){}
+  while (startLine(buffer, inbuffer, Extreme, m_Histo, outLeftP, outRightP, inLeftP, inRightP, middle, bufflength)){}
 
-  finishLine(buffer, inbuffer, Extreme, *m_Histo, outLeftP, outRightP, inLeftP, inRightP, middle, bufflength);
+  finishLine(buffer, inbuffer, Extreme, m_Histo, outLeftP, outRightP, inLeftP, inRightP, middle, bufflength);
 }
 
-template<class TInputPix, class TFunction1, class TFunction2>
+template<class TInputPix, class TFunction1, class TFunction2, class THistogram>
 bool
-AnchorErodeDilateLine<TInputPix, TFunction1, TFunction2>
+AnchorErodeDilateLine<TInputPix, TFunction1, TFunction2, THistogram>
 ::startLine(InputImagePixelType * buffer,
 	    InputImagePixelType * inbuffer,
 	    InputImagePixelType &Extreme,
@@ -315,9 +306,9 @@ AnchorErodeDilateLine<TInputPix, TFunction1, TFunction2>
   return(false);
 }
 
-template<class TInputPix, class TFunction1, class TFunction2>
+template<class TInputPix, class TFunction1, class TFunction2, class THistogram>
 void
-AnchorErodeDilateLine<TInputPix, TFunction1, TFunction2>
+AnchorErodeDilateLine<TInputPix, TFunction1, TFunction2, THistogram>
 ::finishLine(InputImagePixelType * buffer,
 	     InputImagePixelType * inbuffer,
 	     InputImagePixelType &Extreme,
@@ -390,9 +381,9 @@ AnchorErodeDilateLine<TInputPix, TFunction1, TFunction2>
   
 }
 
-template<class TInputPix, class TFunction1, class TFunction2>
+template<class TInputPix, class TFunction1, class TFunction2, class THistogram>
 void
-AnchorErodeDilateLine<TInputPix, TFunction1, TFunction2>
+AnchorErodeDilateLine<TInputPix, TFunction1, TFunction2, THistogram>
 ::PrintSelf(std::ostream &os, Indent indent) const
 {
   os << indent << "Size: " << m_Size << std::endl;
@@ -0,0 +1,91 @@
+#ifndef __itkAnchorErodeDilateWedgeLine_h
+#define __itkAnchorErodeDilateWedgeLine_h
+
+#include "itkAnchorErodeDilateLine.h"
+#include "itkIndent.h"
+#include <vector>
+
+namespace itk {
+
+/** 
+ * \class AnchorErodeDilateWedgeLine
+ * \brief class to implement erosions and dilations of a line with a
+ * monotonic wedge, for the pixel types without a vector based histogram.
+ *
+ * The wedge is the list of the positions of the window which may still
+ * become the extreme value of a later window: the values along the list
+ * are sorted, so the extreme value of the window is always the first one.
+ * A new pixel removes from the end of the list the pixels it
+ * dominates, and the first pixel is removed when it leaves the window.
+ * This is the streaming maximum/minimum algorithm described in
+ * Lemire D., "Streaming Maximum-Minimum Filter Using No More than Three
+ * Comparisons per Element", Nordic Journal of Computing, 13(4), 2006.
+ *
+ * This class has the same interface and produces the same lines as
+ * AnchorErodeDilateLine, but it doesn't need the map based histogram,
+ * which is slow and allocates its nodes, for the real and 32 bits types.
+ * TFunction1 will be < for erosions. TFunction2 is not used: it is only
+ * there to be interchangeable with AnchorErodeDilateLine.
+ *
+ * \sa AnchorErodeDilateLine, AnchorErodeDilateLineTraits
+**/
+template<class TInputPix, class TFunction1, class TFunction2>
+class ITK_EXPORT AnchorErodeDilateWedgeLine
+{
+public:
+  /** Some convenient typedefs. */
+  typedef TInputPix InputImagePixelType;
+
+  void doLine(InputImagePixelType * buffer, InputImagePixelType * inbuffer, 
+	      unsigned bufflength);
+
+  void SetSize(unsigned int size)
+  {
+    m_Size = size;
+  }
+
+  void PrintSelf(std::ostream &os, Indent indent) const;
+  AnchorErodeDilateWedgeLine();
+  ~AnchorErodeDilateWedgeLine() {};
+
+private:
+  unsigned int m_Size;
+  TFunction1 m_TF1;
+
+  // the positions in the wedge. The storage is kept from a line to the
+  // next one, so there is no allocation once the longest line is seen.
+  std::vector<unsigned> m_Wedge;
+
+} ; // end of class
+
+
+/** 
+ * \class AnchorErodeDilateLineTraits
+ * \brief select the line class used by the anchor erosions and dilations
+ *
+ * AnchorErodeDilateLine is used when AnchorHistogramTraits gives a vector
+ * based histogram, and AnchorErodeDilateWedgeLine when it gives a map.
+ */
+template<class TInputPix, class TFunction1, class TFunction2,
+	 class THistogram = typename AnchorHistogramTraits<TInputPix, TFunction1>::HistogramType>
+struct AnchorErodeDilateLineTraits
+{
+  typedef AnchorErodeDilateLine<TInputPix, TFunction1, TFunction2, THistogram> LineType;
+};
+
+template<class TInputPix, class TFunction1, class TFunction2, class THistogramCompare>
+struct AnchorErodeDilateLineTraits<TInputPix, TFunction1, TFunction2,
+				   MorphologyHistogramMap<TInputPix, THistogramCompare> >
+{
+  typedef AnchorErodeDilateWedgeLine<TInputPix, TFunction1, TFunction2> LineType;
+};
+
+} // end namespace itk
+
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkAnchorErodeDilateWedgeLine.txx"
+#endif
+
+#endif
+
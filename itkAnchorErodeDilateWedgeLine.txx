@@ -0,0 +1,73 @@
+#ifndef __itkAnchorErodeDilateWedgeLine_txx
+#define __itkAnchorErodeDilateWedgeLine_txx
+
+#include "itkAnchorErodeDilateWedgeLine.h"
+
+namespace itk {
+
+template <class TInputPix, class TFunction1, class TFunction2>
+AnchorErodeDilateWedgeLine<TInputPix, TFunction1, TFunction2>
+::AnchorErodeDilateWedgeLine()
+{
+  m_Size=2;
+}
+
+template <class TInputPix, class TFunction1, class TFunction2>
+void
+AnchorErodeDilateWedgeLine<TInputPix, TFunction1, TFunction2>
+::doLine(InputImagePixelType * buffer, InputImagePixelType * inbuffer, unsigned bufflength)
+{
+  // the output pixel i is the extreme value of the input pixels from
+  // i - middle to i + right, like in AnchorErodeDilateLine
+  const int middle = (int)m_Size/2;
+  const int right = (int)m_Size - middle - 1;
+  const int length = (int)bufflength;
+
+  // each position enters the wedge once, so the wedge never needs more
+  // than bufflength elements, and head and tail never wrap
+  if (m_Wedge.size() < bufflength)
+    {
+    m_Wedge.resize(bufflength);
+    }
+  unsigned * wedge = &m_Wedge[0];
+  int head = 0, tail = 0;
+
+  for (int i = 0; i < length + right; i++)
+    {
+    if (i < length)
+      {
+      // the pixels dominated by the new one can't be the extreme value
+      // of any later window
+      while (tail > head && !m_TF1(inbuffer[wedge[tail - 1]], inbuffer[i]))
+	{
+	--tail;
+	}
+      wedge[tail++] = i;
+      }
+
+    const int out = i - right;
+    if (out >= 0)
+      {
+      // drop the first pixel if it is no more in the window
+      while ((int)wedge[head] < out - middle)
+	{
+	++head;
+	}
+      buffer[out] = inbuffer[wedge[head]];
+      }
+    }
+}
+
+template<class TInputPix, class TFunction1, class TFunction2>
+void
+AnchorErodeDilateWedgeLine<TInputPix, TFunction1, TFunction2>
+::PrintSelf(std::ostream &os, Indent indent) const
+{
+  os << indent << "Size: " << m_Size << std::endl;
+}
+
+
+} // end namespace itk
+
+#endif
+
@@ -5,36 +5,32 @@
 #include <vector>
 #include <map>
 #include "itkIndent.h"
+#include "itkHistogramCounterArray.h"
 namespace itk {
 
-// a simple histogram class hierarchy. One subclass will be maps, the
-// other vectors
+// the histograms used by the anchor line classes. One implementation
+// uses a map, the other a vector. They share the same interface
+//   void Reset()
+//   void AddBoundary() / void RemoveBoundary()
+//   void AddPixel(const TInputPixel &p) / void RemovePixel(const TInputPixel &p)
+//   TInputPixel GetValue()
+//   void SetMaximumCount(unsigned long)
+//   static unsigned long GetCountLimit()
+// but there is no virtual method: the implementation is a template
+// parameter of the line classes, selected by AnchorHistogramTraits, so
+// the calls can be inlined in the line loops.
 template <class TInputPixel>
 class MorphologyHistogram
 {
 public:
   MorphologyHistogram() {}
-  virtual ~MorphologyHistogram(){}
-
-  virtual void Reset(){}
-  
-  virtual void AddBoundary(){}
-
-  virtual void RemoveBoundary(){}
-  
-  virtual void AddPixel(const TInputPixel &p){}
-
-  virtual void RemovePixel(const TInputPixel &p){}
- 
-  virtual TInputPixel GetValue()
-  {
-    return(m_Boundary);  // a dummy return
-  }
+  ~MorphologyHistogram(){}
 
   void SetBoundary( const TInputPixel & val )
   {
     m_Boundary = val; 
   }
+
 protected:
   TInputPixel  m_Boundary;
 
@@ -58,6 +54,14 @@ public:
   {
     m_Map.clear();
   }
+
+  // the map has no counter to size
+  void SetMaximumCount(unsigned long){}
+
+  static unsigned long GetCountLimit()
+  {
+    return NumericTraits< unsigned long >::max();
+  }
   
   void AddBoundary()
   {
@@ -108,13 +112,17 @@ public:
 
 };
 
-template <class TInputPixel, class TCompare>
+template <class TInputPixel, class TCompare, class TCounter = unsigned int>
 class MorphologyHistogramVec : public MorphologyHistogram<TInputPixel>
 {
 private:
-  typedef typename std::vector<unsigned long> VecType;
+  typedef Function::HistogramCounterArray< TCounter > VecType;
   
   VecType m_Vec;
+  // the blocks of bins modified since the histogram was empty, so Reset()
+  // doesn't have to clear all the bins of the 16 bits types after a short
+  // line
+  Function::HistogramChangedBlocks m_Changes;
   unsigned int m_Size;
   TCompare m_Compare;
   TInputPixel m_CurrentValue;
@@ -126,8 +134,8 @@ public:
   {
     m_Size = static_cast<unsigned int>( NumericTraits< TInputPixel >::max() - 
 					NumericTraits< TInputPixel >::NonpositiveMin() + 1 );
-    m_Vec.resize(m_Size, 0 );
-    std::fill(m_Vec.begin(), m_Vec.end(),0);
+    m_Vec.Initialize(m_Size);
+    m_Changes.Initialize(m_Size);
     if( m_Compare( NumericTraits< TInputPixel >::max(), 
 		   NumericTraits< TInputPixel >::NonpositiveMin() ) )
       {
@@ -147,9 +155,19 @@ public:
     m_CurrentValue = m_InitVal;
     if (m_Entries != 0)
       {
-      std::fill(m_Vec.begin(), m_Vec.end(),0);
+      m_Vec.ClearBlocks(m_Changes);
       m_Entries = 0;
       }
+    m_Changes.Clear();
+  }
+
+  // the histogram holds at most a line segment of the structuring element:
+  // the width of the counters is checked by the filter with GetCountLimit()
+  void SetMaximumCount(unsigned long){}
+
+  static unsigned long GetCountLimit()
+  {
+    return VecType::GetCountLimit();
   }
   
   void AddBoundary()
@@ -166,7 +184,9 @@ public:
   void AddPixel(const TInputPixel &p)
   {
     
-    m_Vec[ (long unsigned int)(p - NumericTraits< TInputPixel >::NonpositiveMin())  ]++;
+    const unsigned long bin = (long unsigned int)(p - NumericTraits< TInputPixel >::NonpositiveMin());
+    m_Vec.Increment( bin );
+    m_Changes.Set( bin );
     if (m_Compare(p, m_CurrentValue))
       {
       m_CurrentValue = p;
@@ -179,7 +199,7 @@ public:
     assert((int)p - (int)NumericTraits< TInputPixel >::NonpositiveMin() >= 0);
     assert(((int)p - (int)NumericTraits< TInputPixel >::NonpositiveMin()) < (int)m_Vec.size());
     assert(m_Entries >= 1);
-    m_Vec[ (long unsigned int)(p - NumericTraits< TInputPixel >::NonpositiveMin())  ]--; 
+    m_Vec.Decrement( (long unsigned int)(p - NumericTraits< TInputPixel >::NonpositiveMin()) );
     --m_Entries;
     assert(static_cast<int>((int)m_CurrentValue -                                                                                                                      
 			    (int)NumericTraits< TInputPixel >::NonpositiveMin() ) >= 0);
@@ -207,5 +227,51 @@ public:
 
 };
 
+// select the histogram implementation for a pixel type at compile time:
+// the map by default, and the vector for the types with at most 16 bits,
+// which don't require too much memory. TCounter is the type of the
+// counters of the vector, and is ignored by the map.
+template <class TInputPixel, class TCompare, class TCounter = unsigned int>
+struct AnchorHistogramTraits
+{
+  typedef MorphologyHistogramMap< TInputPixel, TCompare > HistogramType;
+};
+
+template <class TCompare, class TCounter>
+struct AnchorHistogramTraits< bool, TCompare, TCounter >
+{
+  typedef MorphologyHistogramVec< bool, TCompare, TCounter > HistogramType;
+};
+
+template <class TCompare, class TCounter>
+struct AnchorHistogramTraits< char, TCompare, TCounter >
+{
+  typedef MorphologyHistogramVec< char, TCompare, TCounter > HistogramType;
+};
+
+template <class TCompare, class TCounter>
+struct AnchorHistogramTraits< unsigned char, TCompare, TCounter >
+{
+  typedef MorphologyHistogramVec< unsigned char, TCompare, TCounter > HistogramType;
+};
+
+template <class TCompare, class TCounter>
+struct AnchorHistogramTraits< signed char, TCompare, TCounter >
+{
+  typedef MorphologyHistogramVec< signed char, TCompare, TCounter > HistogramType;
+};
+
+template <class TCompare, class TCounter>
+struct AnchorHistogramTraits< unsigned short, TCompare, TCounter >
+{
+  typedef MorphologyHistogramVec< unsigned short, TCompare, TCounter > HistogramType;
+};
+
+template <class TCompare, class TCounter>
+struct AnchorHistogramTraits< signed short, TCompare, TCounter >
+{
+  typedef MorphologyHistogramVec< signed short, TCompare, TCounter > HistogramType;
+};
+
 } // end namespace itk
 #endif
@@ -5,6 +5,7 @@
 #include "itkProgressReporter.h"
 #include "itkAnchorOpenCloseLine.h"
 #include "itkAnchorErodeDilateLine.h"
+#include "itkAnchorErodeDilateWedgeLine.h"
 #include "itkBresenhamLine.h"
 
 namespace itk {
@@ -30,18 +31,22 @@ namespace itk {
  * in more complex template parameters because the appropriate
  * comparison operations need to be passed in. The less
  *
+ * The last pass is written directly in the output, with a conversion
+ * to the pixel type of TOutputImage.
+ *
 **/
 template<class TImage, class TKernel, 
-	 class LessThan, class GreaterThan, class LessEqual, class GreaterEqual>
+	 class LessThan, class GreaterThan, class LessEqual, class GreaterEqual,
+	 class TOutputImage = TImage>
 // 	 class THistogramCompare,
 // 	 class TFunction1, class TFunction2>
 class ITK_EXPORT AnchorOpenCloseImageFilter :
-    public ImageToImageFilter<TImage, TImage>
+    public ImageToImageFilter<TImage, TOutputImage>
 {
 public:
   /** Standard class typedefs. */
   typedef AnchorOpenCloseImageFilter Self;
-  typedef ImageToImageFilter<TImage, TImage>
+  typedef ImageToImageFilter<TImage, TOutputImage>
   Superclass;
   typedef SmartPointer<Self>        Pointer;
   typedef SmartPointer<const Self>  ConstPointer;
@@ -56,11 +61,15 @@ public:
   typedef typename InputImageType::RegionType      InputImageRegionType;
   typedef typename InputImageType::PixelType       InputImagePixelType;
 
+  typedef TOutputImage OutputImageType;
+  typedef typename OutputImageType::RegionType     OutputImageRegionType;
+  typedef typename OutputImageType::PixelType      OutputImagePixelType;
+
   /** ImageDimension constants */
   itkStaticConstMacro(InputImageDimension, unsigned int,
                       TImage::ImageDimension);
   itkStaticConstMacro(OutputImageDimension, unsigned int,
-                      TImage::ImageDimension);
+                      TOutputImage::ImageDimension);
 
   /** Standard New method. */
   itkNewMacro(Self);
@@ -81,7 +90,7 @@ protected:
   void PrintSelf(std::ostream& os, Indent indent) const;
 
   /** Multi-thread version GenerateData. */
-  void  ThreadedGenerateData (const InputImageRegionType& outputRegionForThread,
+  void  ThreadedGenerateData (const OutputImageRegionType& outputRegionForThread,
                               int threadId) ;
 
   /** GrayscaleMorphologicalOpeningImageFilter need to make sure they request enough of an
@@ -108,17 +117,20 @@ private:
 //  typedef AnchorOpenCloseLine<InputImagePixelType, THistogramCompare, TFunction1, TFunction2> AnchorLineOpenType;
   typedef AnchorOpenCloseLine<InputImagePixelType, LessThan, GreaterEqual, LessEqual> AnchorLineOpenType;
 
-  typedef AnchorErodeDilateLine<InputImagePixelType, LessThan, LessEqual> AnchorLineErodeType;
+  typedef typename AnchorErodeDilateLineTraits<InputImagePixelType, LessThan, LessEqual>::LineType AnchorLineErodeType;
   
   // the class that does the dilation
-  typedef AnchorErodeDilateLine<InputImagePixelType, GreaterThan, GreaterEqual> AnchorLineDilateType;
+  typedef typename AnchorErodeDilateLineTraits<InputImagePixelType, GreaterThan, GreaterEqual>::LineType AnchorLineDilateType;
 
+  // only the pixels of output inside OutputRegion are written
+  template <class TOutput>
   void doFaceOpen(InputImageConstPointer input,
-		  InputImagePointer output,
+		  TOutput * output,
+		  const typename TOutput::RegionType OutputRegion,
 		  typename TImage::PixelType border,
 		  typename KernelType::LType line,
 		  AnchorLineOpenType &AnchorLineOpen,
-		  const typename BresType::OffsetArray LineOffsets,
+		  const typename BresType::OffsetArray & LineOffsets,
 		  InputImagePixelType * outbuffer,	      
 		  const InputImageRegionType AllImage, 
 		  const InputImageRegionType face);
@@ -5,20 +5,19 @@
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkAnchorUtilities.h"
-#include <itkImageRegionIterator.h>
 namespace itk {
 
-template <class TImage, class TKernel, class LessThan, class GreaterThan, class LessEqual, class GreaterEqual>
-AnchorOpenCloseImageFilter<TImage, TKernel, LessThan, GreaterThan, LessEqual, GreaterEqual>
+template <class TImage, class TKernel, class LessThan, class GreaterThan, class LessEqual, class GreaterEqual, class TOutputImage>
+AnchorOpenCloseImageFilter<TImage, TKernel, LessThan, GreaterThan, LessEqual, GreaterEqual, TOutputImage>
 ::AnchorOpenCloseImageFilter()
 {
   m_KernelSet = false;
 }
 
-template <class TImage, class TKernel, class LessThan, class GreaterThan, class LessEqual, class GreaterEqual>
+template <class TImage, class TKernel, class LessThan, class GreaterThan, class LessEqual, class GreaterEqual, class TOutputImage>
 void
-AnchorOpenCloseImageFilter<TImage, TKernel, LessThan, GreaterThan, LessEqual, GreaterEqual>
-::ThreadedGenerateData (const InputImageRegionType& outputRegionForThread,
+AnchorOpenCloseImageFilter<TImage, TKernel, LessThan, GreaterThan, LessEqual, GreaterEqual, TOutputImage>
+::ThreadedGenerateData (const OutputImageRegionType& outputRegionForThread,
 			int threadId)
 {
 
@@ -47,7 +46,7 @@ AnchorOpenCloseImageFilter<TImage, TKernel, LessThan, GreaterThan, LessEqual, Gr
 
   AnchorLineOpenType AnchorLineOpen;
 
-  ProgressReporter progress(this, threadId, m_Kernel.GetLines().size()*2 + 1);
+  ProgressReporter progress(this, threadId, m_Kernel.GetLines().size()*2);
 
   InputImageConstPointer input = this->GetInput();
 
@@ -58,14 +57,8 @@ AnchorOpenCloseImageFilter<TImage, TKernel, LessThan, GreaterThan, LessEqual, Gr
   IReg.PadByRadius( m_Kernel.GetRadius() );
   IReg.Crop( this->GetInput()->GetRequestedRegion() );
 
-   // allocate an internal buffer
-  typename InputImageType::Pointer internalbuffer = InputImageType::New();
-  internalbuffer->SetRegions(IReg);
-  internalbuffer->Allocate();
-  InputImagePointer output = internalbuffer;
-
   // get the region size
-  InputImageRegionType OReg = outputRegionForThread;
+  OutputImageRegionType OReg = outputRegionForThread;
   // maximum buffer length is sum of dimensions
   unsigned int bufflength = 0;
   for (unsigned i = 0; i<TImage::ImageDimension; i++)
@@ -82,11 +75,22 @@ AnchorOpenCloseImageFilter<TImage, TKernel, LessThan, GreaterThan, LessEqual, Gr
   typename KernelType::DecompType decomposition = m_Kernel.GetLines();
   BresType BresLine;
 
+  // allocate an internal buffer for all the passes but the last one,
+  // which is written directly in the output
+  InputImagePointer internalbuffer;
+  if (decomposition.size() > 1)
+    {
+    internalbuffer = InputImageType::New();
+    internalbuffer->SetRegions(IReg);
+    internalbuffer->Allocate();
+    }
+
   // first stage -- all of the erosions if we are doing an opening
   for (unsigned i = 0; i < decomposition.size() - 1; i++)
     {
     typename KernelType::LType ThisLine = decomposition[i];
-    typename BresType::OffsetArray TheseOffsets = BresLine.buildLine(ThisLine, bufflength);
+    typename BresType::LineConstPointer TheseLine = BresLine.buildLine(ThisLine, bufflength);
+    const typename BresType::OffsetArray & TheseOffsets = TheseLine->GetValue();
     unsigned int SELength = getLinePixels<typename KernelType::LType>(ThisLine);
     // want lines to be odd
     if (!(SELength%2))
@@ -96,8 +100,8 @@ AnchorOpenCloseImageFilter<TImage, TKernel, LessThan, GreaterThan, LessEqual, Gr
     InputImageRegionType BigFace = mkEnlargedFace<InputImageType, typename KernelType::LType>(input, IReg, ThisLine);
     doFace<TImage, BresType, 
       AnchorLineErodeType, 
-      typename KernelType::LType>(input, output, m_Boundary1, ThisLine, AnchorLineErode, 
-				  TheseOffsets, inbuffer, buffer, IReg, BigFace);
+      typename KernelType::LType, TImage>(input, internalbuffer, IReg, m_Boundary1, ThisLine, AnchorLineErode, 
+					  TheseOffsets, inbuffer, buffer, IReg, BigFace);
     
 
     // after the first pass the input will be taken from the output
@@ -108,7 +112,8 @@ AnchorOpenCloseImageFilter<TImage, TKernel, LessThan, GreaterThan, LessEqual, Gr
   {
   unsigned i = decomposition.size() - 1;
   typename KernelType::LType ThisLine = decomposition[i];
-  typename BresType::OffsetArray TheseOffsets = BresLine.buildLine(ThisLine, bufflength);
+  typename BresType::LineConstPointer TheseLine = BresLine.buildLine(ThisLine, bufflength);
+  const typename BresType::OffsetArray & TheseOffsets = TheseLine->GetValue();
   unsigned int SELength = getLinePixels<typename KernelType::LType>(ThisLine);
   // want lines to be odd
   if (!(SELength%2))
@@ -119,9 +124,20 @@ AnchorOpenCloseImageFilter<TImage, TKernel, LessThan, GreaterThan, LessEqual, Gr
 
   // Now figure out which faces of the image we should be starting
   // from with this line
-  doFaceOpen(input, output, m_Boundary1, ThisLine, AnchorLineOpen,
-	     TheseOffsets, buffer, 
-	     IReg, BigFace);
+  if (decomposition.size() > 1)
+    {
+    doFaceOpen<TImage>(input, internalbuffer, IReg, m_Boundary1, ThisLine, AnchorLineOpen,
+		       TheseOffsets, buffer, 
+		       IReg, BigFace);
+    input = internalbuffer;
+    }
+  else
+    {
+    // the opening is the last pass
+    doFaceOpen<TOutputImage>(input, this->GetOutput(), OReg, m_Boundary1, ThisLine, AnchorLineOpen,
+			     TheseOffsets, buffer, 
+			     IReg, BigFace);
+    }
   // equivalent to two passes
   progress.CompletedPixel();
   progress.CompletedPixel();  
@@ -131,7 +147,8 @@ AnchorOpenCloseImageFilter<TImage, TKernel, LessThan, GreaterThan, LessEqual, Gr
   for (int i = decomposition.size() - 2; i >= 0; --i)
     {
     typename KernelType::LType ThisLine = decomposition[i];
-    typename BresType::OffsetArray TheseOffsets = BresLine.buildLine(ThisLine, bufflength);
+    typename BresType::LineConstPointer TheseLine = BresLine.buildLine(ThisLine, bufflength);
+    const typename BresType::OffsetArray & TheseOffsets = TheseLine->GetValue();
     unsigned int SELength = getLinePixels<typename KernelType::LType>(ThisLine);
     // want lines to be odd
     if (!(SELength%2))
@@ -140,38 +157,41 @@ AnchorOpenCloseImageFilter<TImage, TKernel, LessThan, GreaterThan, LessEqual, Gr
     AnchorLineDilate.SetSize(SELength);
 
     InputImageRegionType BigFace = mkEnlargedFace<InputImageType, typename KernelType::LType>(input, IReg, ThisLine);
-    doFace<TImage, BresType, 
-      AnchorLineDilateType, 
-      typename KernelType::LType>(input, output, m_Boundary2, ThisLine, AnchorLineDilate, 
-				  TheseOffsets, inbuffer, buffer, IReg, BigFace);
-
+    if (i > 0)
+      {
+      doFace<TImage, BresType, 
+	AnchorLineDilateType, 
+	typename KernelType::LType, TImage>(input, internalbuffer, IReg, m_Boundary2, ThisLine, AnchorLineDilate, 
+					    TheseOffsets, inbuffer, buffer, IReg, BigFace);
+      }
+    else
+      {
+      // the last dilation writes the pixels of the region of the
+      // thread directly in the output
+      doFace<TImage, BresType, 
+	AnchorLineDilateType, 
+	typename KernelType::LType, TOutputImage>(input, this->GetOutput(), OReg, m_Boundary2, ThisLine, AnchorLineDilate, 
+						  TheseOffsets, inbuffer, buffer, IReg, BigFace);
+      }
     
     progress.CompletedPixel();
     }
 
-  // copy internal buffer to output
-  typedef typename itk::ImageRegionIterator<InputImageType> IterType;
-  IterType oit(this->GetOutput(), OReg);
-  IterType iit(internalbuffer, OReg);
-  for (oit.GoToBegin(), iit.GoToBegin(); !oit.IsAtEnd(); ++oit, ++iit)
-    {
-    oit.Set(iit.Get());
-    }
-  progress.CompletedPixel();
-
   delete [] buffer;
   delete [] inbuffer;
 }
 
-template<class TImage, class TKernel, class LessThan, class GreaterThan, class LessEqual, class GreaterEqual>
+template<class TImage, class TKernel, class LessThan, class GreaterThan, class LessEqual, class GreaterEqual, class TOutputImage>
+template <class TOutput>
 void
-AnchorOpenCloseImageFilter<TImage, TKernel, LessThan, GreaterThan, LessEqual, GreaterEqual>
+AnchorOpenCloseImageFilter<TImage, TKernel, LessThan, GreaterThan, LessEqual, GreaterEqual, TOutputImage>
 ::doFaceOpen(InputImageConstPointer input,
-	     InputImagePointer output,
+	     TOutput * output,
+	     const typename TOutput::RegionType OutputRegion,
 	     typename TImage::PixelType border,
 	     typename KernelType::LType line,
 	     AnchorLineOpenType &AnchorLineOpen,
-	     typename BresType::OffsetArray LineOffsets,
+	     const typename BresType::OffsetArray & LineOffsets,
 	     InputImagePixelType * outbuffer,	      
 	     const InputImageRegionType AllImage, 
 	     const InputImageRegionType face)
@@ -199,24 +219,24 @@ AnchorOpenCloseImageFilter<TImage, TKernel, LessThan, GreaterThan, LessEqual, Gr
       outbuffer[0]=border;
       outbuffer[len+1]=border;
       AnchorLineOpen.doLine(outbuffer,len+2);  // compat
-      copyLineToImage<TImage, BresType>(output, Ind, LineOffsets, outbuffer, start, end);
+      copyLineToRegion<TImage, BresType, TOutput>(output, OutputRegion, Ind, LineOffsets, outbuffer, start, end);
       }
     ++it;
     }
 }
 
-template<class TImage, class TKernel, class LessThan, class GreaterThan, class LessEqual, class GreaterEqual>
+template<class TImage, class TKernel, class LessThan, class GreaterThan, class LessEqual, class GreaterEqual, class TOutputImage>
 void
-AnchorOpenCloseImageFilter<TImage, TKernel, LessThan, GreaterThan, LessEqual, GreaterEqual>
+AnchorOpenCloseImageFilter<TImage, TKernel, LessThan, GreaterThan, LessEqual, GreaterEqual, TOutputImage>
 ::PrintSelf(std::ostream &os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
 }
 
 
-template<class TImage, class TKernel, class LessThan, class GreaterThan, class LessEqual, class GreaterEqual>
+template<class TImage, class TKernel, class LessThan, class GreaterThan, class LessEqual, class GreaterEqual, class TOutputImage>
 void
-AnchorOpenCloseImageFilter<TImage, TKernel, LessThan, GreaterThan, LessEqual, GreaterEqual>
+AnchorOpenCloseImageFilter<TImage, TKernel, LessThan, GreaterThan, LessEqual, GreaterEqual, TOutputImage>
 ::GenerateInputRequestedRegion()
 {
   // call the superclass' implementation of this method
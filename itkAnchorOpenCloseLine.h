@@ -17,14 +17,15 @@ namespace itk {
 
 **/
 template<class TInputPix, class THistogramCompare,
-	 class TFunction1, class TFunction2>
+	 class TFunction1, class TFunction2,
+	 class THistogram = typename AnchorHistogramTraits<TInputPix, THistogramCompare>::HistogramType>
 class ITK_EXPORT AnchorOpenCloseLine
 {
 public:
   /** Some convenient typedefs. */
   typedef TInputPix InputImagePixelType;
   AnchorOpenCloseLine();
-  ~AnchorOpenCloseLine() {delete m_Histo;};
+  ~AnchorOpenCloseLine() {};
   void PrintSelf(std::ostream& os, Indent indent) const;
 
   /** Single-threaded version of GenerateData.  This filter delegates
@@ -34,6 +35,9 @@ public:
   void SetSize(unsigned int size)
   {
     m_Size = size;
+    // a window of the line, plus the extreme value carried from the
+    // previous window
+    m_Histo.SetMaximumCount(size + 2);
   }
 
 private:
@@ -41,9 +45,9 @@ private:
   TFunction1 m_TF1;
   TFunction2 m_TF2;
 
-  typedef MorphologyHistogram<InputImagePixelType> Histogram;
-  typedef MorphologyHistogramVec<InputImagePixelType,THistogramCompare> VHistogram;
-  typedef MorphologyHistogramMap<InputImagePixelType,THistogramCompare> MHistogram;
+  // the histogram is selected at compile time, so its methods can be
+  // inlined in the line loops
+  typedef THistogram Histogram;
 
   bool startLine(InputImagePixelType * buffer,
 		 InputImagePixelType &Extreme,
@@ -58,18 +62,7 @@ private:
 		  unsigned &outRightP, 
 		  unsigned bufflength);
 
-  bool useVectorBasedHistogram()
-  {
-    // bool, short and char are acceptable for vector based algorithm: they do not require
-    // too much memory. Other types are not usable with that algorithm
-    return typeid(InputImagePixelType) == typeid(unsigned char)
-        || typeid(InputImagePixelType) == typeid(signed char)
-        || typeid(InputImagePixelType) == typeid(unsigned short)
-        || typeid(InputImagePixelType) == typeid(signed short)
-        || typeid(InputImagePixelType) == typeid(bool);
-  }
-
-  Histogram * m_Histo;
+  Histogram m_Histo;
 
 } ; // end of class
 
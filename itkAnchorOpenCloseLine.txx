@@ -5,24 +5,16 @@
 
 namespace itk {
 
-template <class TInputPix, class THistogramCompare, class TFunction1, class TFunction2>
-AnchorOpenCloseLine<TInputPix, THistogramCompare, TFunction1, TFunction2>
+template <class TInputPix, class THistogramCompare, class TFunction1, class TFunction2, class THistogram>
+AnchorOpenCloseLine<TInputPix, THistogramCompare, TFunction1, TFunction2, THistogram>
 ::AnchorOpenCloseLine()
 {
   m_Size=2;
-  if (useVectorBasedHistogram())
-    {
-    m_Histo = new VHistogram;
-    } 
-  else
-    {
-    m_Histo = new MHistogram;
-    }
 }
 
-template <class TInputPix, class THistogramCompare, class TFunction1, class TFunction2>
+template <class TInputPix, class THistogramCompare, class TFunction1, class TFunction2, class THistogram>
 void
-AnchorOpenCloseLine<TInputPix, THistogramCompare, TFunction1, TFunction2>
+AnchorOpenCloseLine<TInputPix, THistogramCompare, TFunction1, TFunction2, THistogram>
 ::doLine(InputImagePixelType * buffer, unsigned bufflength)
 {
   // TFunction1 will be >= for openings
@@ -53,7 +45,7 @@ AnchorOpenCloseLine<TInputPix, THistogramCompare, TFunction1, TFunction2>
     return;
     }
 
-  m_Histo->Reset();
+  m_Histo.Reset();
   // start the real work - everything here will be done with index
   // arithmetic rather than pointer arithmetic
   unsigned outLeftP = 0, outRightP = bufflength - 1;
@@ -69,7 +61,7 @@ AnchorOpenCloseLine<TInputPix, THistogramCompare, TFunction1, TFunction2>
     --outRightP;
     }
   InputImagePixelType Extreme;
-  while (startLine(buffer, Extreme, *m_Histo, outLeftP, outRightP, bufflength)){}
+  while (startLine(buffer, Extreme, m_Histo, outLeftP, outRightP, bufflength)){}
   
   finishLine(buffer, Extreme, outLeftP, outRightP, bufflength);
   // this section if to make the edge behaviour the same as the more
@@ -105,9 +97,9 @@ AnchorOpenCloseLine<TInputPix, THistogramCompare, TFunction1, TFunction2>
   
 }
 
-template<class TInputPix, class THistogramCompare, class TFunction1, class TFunction2>
+template<class TInputPix, class THistogramCompare, class TFunction1, class TFunction2, class THistogram>
 bool
-AnchorOpenCloseLine<TInputPix, THistogramCompare, TFunction1, TFunction2>
+AnchorOpenCloseLine<TInputPix, THistogramCompare, TFunction1, TFunction2, THistogram>
 ::startLine(InputImagePixelType * buffer,
 	    InputImagePixelType &Extreme,
 	    Histogram &histo,
@@ -267,9 +259,9 @@ AnchorOpenCloseLine<TInputPix, THistogramCompare, TFunction1, TFunction2>
   return(false);
 }
 
-template<class TInputPix, class THistogramCompare, class TFunction1, class TFunction2>
+template<class TInputPix, class THistogramCompare, class TFunction1, class TFunction2, class THistogram>
 void
-AnchorOpenCloseLine<TInputPix,  THistogramCompare, TFunction1, TFunction2>
+AnchorOpenCloseLine<TInputPix,  THistogramCompare, TFunction1, TFunction2, THistogram>
 ::finishLine(InputImagePixelType * buffer,
 	     InputImagePixelType &Extreme,
 	     unsigned &outLeftP,
@@ -307,9 +299,9 @@ AnchorOpenCloseLine<TInputPix,  THistogramCompare, TFunction1, TFunction2>
     }
 }
 
-template<class TInputPix, class THistogramCompare, class TFunction1, class TFunction2>
+template<class TInputPix, class THistogramCompare, class TFunction1, class TFunction2, class THistogram>
 void
-AnchorOpenCloseLine<TInputPix, THistogramCompare, TFunction1, TFunction2>
+AnchorOpenCloseLine<TInputPix, THistogramCompare, TFunction1, TFunction2, THistogram>
 ::PrintSelf(std::ostream &os, Indent indent) const
 {
   os << indent << "Size: " << m_Size << std::endl;
@@ -21,7 +21,7 @@ int fillLineBuffer(typename TImage::ConstPointer input,
 		   const typename TImage::IndexType StartIndex,
 		   const TLine line,
 		   const float tol,
-		   const typename TBres::OffsetArray LineOffsets,
+		   const typename TBres::OffsetArray & LineOffsets,
 		   const typename TImage::RegionType AllImage, 
 		   typename TImage::PixelType * inbuffer,
 		   unsigned &start,
@@ -32,17 +32,21 @@ template <class TImage, class TBres, class TLine>
 int computeStartEnd(const typename TImage::IndexType StartIndex,
 		    const TLine line,
 		    const float tol,
-		    const typename TBres::OffsetArray LineOffsets,
+		    const typename TBres::OffsetArray & LineOffsets,
 		    const typename TImage::RegionType AllImage, 
 		    unsigned &start,
 		    unsigned &end);
-template <class TImage, class TBres, class TAnchor, class TLine>
+// process the lines of a face. Only the pixels of output inside
+// OutputRegion are written, so the last pass of a decomposition can
+// write in the output of the filter.
+template <class TImage, class TBres, class TAnchor, class TLine, class TOutputImage>
 void doFace(typename TImage::ConstPointer input,
-	    typename TImage::Pointer output,
+	    TOutputImage * output,
+	    const typename TOutputImage::RegionType OutputRegion,
 	    typename TImage::PixelType border,
 	    TLine line,
 	    TAnchor &AnchorLine,
-	    const typename TBres::OffsetArray LineOffsets,
+	    const typename TBres::OffsetArray & LineOffsets,
 	    typename TImage::PixelType * inbuffer,
 	    typename TImage::PixelType * outbuffer,	      
 	    const typename TImage::RegionType AllImage, 
@@ -20,7 +20,7 @@ int fillLineBuffer(typename TImage::ConstPointer input,
 		   const typename TImage::IndexType StartIndex,
 		   const TLine line,  // unit vector
 		   const float tol,
-		   const typename TBres::OffsetArray LineOffsets,
+		   const typename TBres::OffsetArray & LineOffsets,
 		   const typename TImage::RegionType AllImage, 
 		   typename TImage::PixelType * inbuffer,
 		   unsigned &start,
@@ -68,13 +68,14 @@ int fillLineBuffer(typename TImage::ConstPointer input,
 }
 #endif
 
-template <class TImage, class TBres, class TAnchor, class TLine>
+template <class TImage, class TBres, class TAnchor, class TLine, class TOutputImage>
 void doFace(typename TImage::ConstPointer input,
-	    typename TImage::Pointer output,
+	    TOutputImage * output,
+	    const typename TOutputImage::RegionType OutputRegion,
 	    typename TImage::PixelType border,
 	    TLine line,
 	    TAnchor &AnchorLine,
-	    const typename TBres::OffsetArray LineOffsets,
+	    const typename TBres::OffsetArray & LineOffsets,
 	    typename TImage::PixelType * inbuffer,
 	    typename TImage::PixelType * outbuffer,	      
 	    const typename TImage::RegionType AllImage, 
@@ -102,7 +103,7 @@ void doFace(typename TImage::ConstPointer input,
 
 #if 1
       AnchorLine.doLine(outbuffer, inbuffer, len + 2);  // compat
-      copyLineToImage<TImage, TBres>(output, Ind, LineOffsets, outbuffer, start, end);
+      copyLineToRegion<TImage, TBres, TOutputImage>(output, OutputRegion, Ind, LineOffsets, outbuffer, start, end);
 #else
       // test the decomposition
       copyLineToImage<TImage, TBres>(output, Ind, LineOffsets, inbuffer, start, end);
@@ -5,6 +5,8 @@
 #include "itkOffset.h"
 #include "itkIndex.h"
 #include <vector>
+#include <utility>
+#include "itkKernelCache.h"
 
 namespace itk {
 
@@ -25,11 +27,26 @@ public:
 
   typedef typename IndexType::IndexValueType IndexValueType;
 
+private:
+  typedef std::pair< std::vector<float>, unsigned int > LineKeyType;
+  typedef KernelCache< LineKeyType, OffsetArray > LineCacheType;
+
+public:
+  // a line shared with the cache. The offsets are read with GetValue().
+  typedef typename LineCacheType::EntryConstPointer LineConstPointer;
+
   // constructurs
   BresenhamLine(){}
   ~BresenhamLine(){}
 
-  OffsetArray buildLine(LType Direction, unsigned int length);
+  // the lines are stored in a process wide cache: the anchor and vHGW
+  // filters build the same lines in each thread and for each run. The
+  // line is shared, not copied.
+  LineConstPointer buildLine(LType Direction, unsigned int length);
+
+private:
+
+  OffsetArray computeLine(LType Direction, unsigned int length);
 
 };
 
@@ -6,8 +6,27 @@
 namespace itk {
 
 template<unsigned int VDimension>
-typename BresenhamLine<VDimension>::OffsetArray BresenhamLine<VDimension>
+typename BresenhamLine<VDimension>::LineConstPointer BresenhamLine<VDimension>
 ::buildLine(LType Direction, unsigned int length)
+{
+  LineKeyType key;
+  key.first.assign(Direction.Begin(), Direction.End());
+  key.second = length;
+
+  LineConstPointer result;
+  if (!LineCacheType::Find(key, result))
+    {
+    typename LineCacheType::EntryPointer line = LineCacheType::EntryType::New();
+    line->GetValue() = computeLine(Direction, length);
+    LineCacheType::Insert(key, line);
+    result = line.GetPointer();
+    }
+  return(result);
+}
+
+template<unsigned int VDimension>
+typename BresenhamLine<VDimension>::OffsetArray BresenhamLine<VDimension>
+::computeLine(LType Direction, unsigned int length)
 {
   // copied from the line iterator
   /** Variables that drive the Bresenham-Algorithm */
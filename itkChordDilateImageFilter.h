@@ -0,0 +1,83 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkChordDilateImageFilter.h,v $
+  Language:  C++
+  Date:      $Date: 2006/04/28 12:00:00 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkChordDilateImageFilter_h
+#define __itkChordDilateImageFilter_h
+
+#include "itkChordErodeDilateImageFilter.h"
+#include <functional>
+
+namespace itk {
+
+/**
+ * \class ChordDilateImageFilter
+ * \brief gray scale dilation of an image with the chord algorithm
+ *
+ * Dilate an image using grayscale morphology. Dilation takes the
+ * maximum of all the pixels identified by the structuring element.
+ *
+ * The structuring element is decomposed in chords: see
+ * ChordErodeDilateImageFilter.
+ *
+ * \sa MovingHistogramDilateImageFilter, ChordErodeDilateImageFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+
+template<class TInputImage, class TOutputImage, class TKernel>
+class ITK_EXPORT ChordDilateImageFilter :
+    public ChordErodeDilateImageFilter<TInputImage, TOutputImage, TKernel,
+      std::greater<typename TInputImage::PixelType> >
+{
+public:
+  /** Standard class typedefs. */
+  typedef ChordDilateImageFilter Self;
+  typedef ChordErodeDilateImageFilter<TInputImage, TOutputImage, TKernel,
+      std::greater<typename TInputImage::PixelType> >  Superclass;
+  typedef SmartPointer<Self>        Pointer;
+  typedef SmartPointer<const Self>  ConstPointer;
+
+  /** Standard New method. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(ChordDilateImageFilter,
+               ChordErodeDilateImageFilter);
+
+  /** Image related typedefs. */
+  typedef TInputImage InputImageType;
+  typedef TOutputImage OutputImageType;
+  typedef typename TInputImage::PixelType PixelType ;
+
+  /** Image related typedefs. */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TInputImage::ImageDimension);
+
+protected:
+  ChordDilateImageFilter()
+  {
+    this->m_Boundary = itk::NumericTraits< PixelType >::NonpositiveMin();
+  }
+  ~ChordDilateImageFilter() {};
+
+private:
+  ChordDilateImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+} ; // end of class
+
+} // end namespace itk
+
+#endif
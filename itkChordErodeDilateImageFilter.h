@@ -0,0 +1,182 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkChordErodeDilateImageFilter.h,v $
+  Language:  C++
+  Date:      $Date: 2006/04/28 12:00:00 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkChordErodeDilateImageFilter_h
+#define __itkChordErodeDilateImageFilter_h
+
+#include "itkKernelImageFilter.h"
+#include "itkNumericTraits.h"
+#include <vector>
+
+namespace itk {
+
+/**
+ * \class ChordErodeDilateImageFilter
+ * \brief base class for ChordDilateImageFilter and ChordErodeImageFilter
+ *
+ * This filter implements the algorithm described in
+ * Urbach E.R., Wilkinson M.H.F., "Efficient 2-D Grayscale Morphological
+ * Transformations With Arbitrary Flat Structuring Elements",
+ * IEEE Transactions on Image Processing, 17(1), 2008.
+ *
+ * The kernel is encoded as a set of chords: the runs of consecutive
+ * active elements along the first axis. For each line of the input
+ * image, the filter computes a table of the extrema of all the segments
+ * of the line with a power of two length, up to the length of the longest
+ * chord. The extremum of a chord of length L is then the extremum of two
+ * overlapping segments of length 2^floor(log2(L)) taken in the table, so
+ * the cost per pixel depends on the number of chords of the kernel, and
+ * not on its number of pixels. The tables of a line are kept as long as
+ * the kernel covers it.
+ *
+ * This filter can be used with any kernel, but it is most useful for the
+ * large kernels which can't be decomposed in lines, like the balls, the
+ * annulus, or the kernels read from an image.
+ *
+ * The elements of the kernel > 0 are used. TCompare is the functor
+ * used to choose between two values: std::greater for a dilation, and
+ * std::less for an erosion.
+ *
+ * \sa ChordDilateImageFilter, ChordErodeImageFilter, MovingHistogramImageFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+
+template<class TInputImage, class TOutputImage, class TKernel, class TCompare>
+class ITK_EXPORT ChordErodeDilateImageFilter :
+    public KernelImageFilter<TInputImage, TOutputImage, TKernel>
+{
+public:
+  /** Standard class typedefs. */
+  typedef ChordErodeDilateImageFilter Self;
+  typedef KernelImageFilter<TInputImage, TOutputImage, TKernel>  Superclass;
+  typedef SmartPointer<Self>        Pointer;
+  typedef SmartPointer<const Self>  ConstPointer;
+
+  /** Standard New method. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(ChordErodeDilateImageFilter,
+               KernelImageFilter);
+
+  /** Image related typedefs. */
+  typedef TInputImage InputImageType;
+  typedef TOutputImage OutputImageType;
+  typedef typename TInputImage::RegionType RegionType ;
+  typedef typename TInputImage::SizeType SizeType ;
+  typedef typename TInputImage::IndexType IndexType ;
+  typedef typename TInputImage::PixelType PixelType ;
+  typedef typename TInputImage::OffsetType OffsetType ;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+  typedef typename TOutputImage::PixelType OutputPixelType ;
+
+  /** Image related typedefs. */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TInputImage::ImageDimension);
+
+  /** Kernel typedef. */
+  typedef TKernel KernelType;
+
+  /** A run of active elements of the kernel along the first axis */
+  struct ChordType
+    {
+    // the position of the line of the chord in the kernel, with 0 on the
+    // first axis
+    OffsetType m_LineOffset;
+    // the position of the first element on the first axis
+    long m_Start;
+    unsigned long m_Length;
+    // floor(log2(m_Length)): the table used to compute the chord
+    unsigned int m_Level;
+    };
+  typedef std::vector< ChordType > ChordArrayType;
+
+  /** Set/Get the boundary value. */
+  itkSetMacro(Boundary, PixelType);
+  itkGetMacro(Boundary, PixelType);
+
+  /** Decompose the kernel in chords, in the order of the lines in
+   * memory. */
+  static void ComputeChords( const KernelType & kernel, ChordArrayType & chords );
+
+  /** Return the estimated number of operations per pixel: the number
+   * of chords, plus the number of tables to compute for each line.
+   * It can be compared with the number of pixels per translation of the
+   * moving histogram. */
+  static double EstimateCost( const KernelType & kernel );
+
+protected:
+  ChordErodeDilateImageFilter()
+    {
+    // default m_boundary should be set by subclasses. Just provide a default
+    // value to always get the same behavior if it is not done
+    m_Boundary = itk::NumericTraits< PixelType >::Zero;
+    m_NumberOfLevels = 0;
+    }
+  ~ChordErodeDilateImageFilter() {};
+
+  void PrintSelf(std::ostream& os, Indent indent) const;
+
+  /** Decompose the kernel in chords */
+  void BeforeThreadedGenerateData();
+
+  /** Multi-thread version GenerateData. */
+  void  ThreadedGenerateData (const OutputImageRegionType&
+                              outputRegionForThread,
+                              int threadId) ;
+
+  PixelType m_Boundary;
+
+private:
+  ChordErodeDilateImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  typedef std::vector< PixelType > TableType;
+
+  /** Fill the tables of the input line starting at lineStart. The tables
+   * begin at the position first on the first axis, and contain length
+   * pixels for each level. */
+  void BuildTables( const IndexType & lineStart, long first, long length, TableType & tables ) const;
+
+  inline PixelType Extremum( const PixelType & a, const PixelType & b ) const
+    {
+    return m_Compare( a, b ) ? a : b;
+    }
+
+  static unsigned int Log2Floor( unsigned long value )
+    {
+    unsigned int level = 0;
+    while( value > 1 )
+      {
+      value >>= 1;
+      level++;
+      }
+    return level;
+    }
+
+  ChordArrayType m_Chords;
+  unsigned int m_NumberOfLevels;
+  TCompare m_Compare;
+
+} ; // end of class
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkChordErodeDilateImageFilter.txx"
+#endif
+
+#endif
@@ -0,0 +1,239 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkChordErodeDilateImageFilter.txx,v $
+  Language:  C++
+  Date:      $Date: 2006/04/28 12:00:00 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkChordErodeDilateImageFilter_txx
+#define __itkChordErodeDilateImageFilter_txx
+
+#include "itkChordErodeDilateImageFilter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkOffsetLexicographicCompare.h"
+#include "itkProgressReporter.h"
+#include <map>
+#include <algorithm>
+
+namespace itk {
+
+
+template<class TInputImage, class TOutputImage, class TKernel, class TCompare>
+void
+ChordErodeDilateImageFilter<TInputImage, TOutputImage, TKernel, TCompare>
+::ComputeChords( const KernelType & kernel, ChordArrayType & chords )
+{
+  chords.clear();
+  // the elements of the kernel are stored with the first axis varying
+  // first, so the chords are found with a single pass on the kernel
+  const unsigned long size = kernel.Size();
+  unsigned long i = 0;
+  while( i < size )
+    {
+    if( !( kernel[i] > 0 ) )
+      {
+      i++;
+      continue;
+      }
+    const OffsetType start = kernel.GetOffset( i );
+    unsigned long length = 1;
+    for( i++; i < size && kernel[i] > 0 && kernel.GetOffset( i )[0] == start[0] + static_cast<long>( length ); i++ )
+      { length++; }
+
+    ChordType chord;
+    chord.m_LineOffset = start;
+    chord.m_LineOffset[0] = 0;
+    chord.m_Start = start[0];
+    chord.m_Length = length;
+    chord.m_Level = Log2Floor( length );
+    chords.push_back( chord );
+    }
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel, class TCompare>
+double
+ChordErodeDilateImageFilter<TInputImage, TOutputImage, TKernel, TCompare>
+::EstimateCost( const KernelType & kernel )
+{
+  ChordArrayType chords;
+  ComputeChords( kernel, chords );
+  unsigned int levels = 0;
+  for( unsigned long i=0; i<chords.size(); i++ )
+    { levels = std::max( levels, chords[i].m_Level + 1 ); }
+  return chords.size() + levels;
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel, class TCompare>
+void
+ChordErodeDilateImageFilter<TInputImage, TOutputImage, TKernel, TCompare>
+::BeforeThreadedGenerateData()
+{
+  ComputeChords( this->GetKernel(), m_Chords );
+  if( m_Chords.empty() )
+    { itkExceptionMacro( << "The kernel must contain at least one active element." ); }
+
+  m_NumberOfLevels = 0;
+  for( unsigned long i=0; i<m_Chords.size(); i++ )
+    { m_NumberOfLevels = std::max( m_NumberOfLevels, m_Chords[i].m_Level + 1 ); }
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel, class TCompare>
+void
+ChordErodeDilateImageFilter<TInputImage, TOutputImage, TKernel, TCompare>
+::BuildTables( const IndexType & lineStart, long first, long length, TableType & tables ) const
+{
+  const InputImageType* inputImage = this->GetInput();
+  const RegionType inputRegion = inputImage->GetRequestedRegion();
+  const long regionBegin = inputRegion.GetIndex()[0];
+  const long regionEnd = regionBegin + static_cast<long>( inputRegion.GetSize()[0] );
+
+  IndexType idx = lineStart;
+  idx[0] = regionBegin;
+  const PixelType * inputPointer = inputImage->GetBufferPointer() + inputImage->ComputeOffset( idx );
+
+  tables.resize( m_NumberOfLevels * length );
+
+  // level 0 is the line itself, padded with the boundary value
+  const long begin = lineStart[0] + first;
+  for( long i=0; i<length; i++ )
+    {
+    const long x = begin + i;
+    if( x >= regionBegin && x < regionEnd )
+      { tables[i] = inputPointer[x - regionBegin]; }
+    else
+      { tables[i] = m_Boundary; }
+    }
+
+  // the segments of length 2^level are made of two segments of the
+  // previous level. The last values of each level are not used.
+  for( unsigned int level=1; level<m_NumberOfLevels; level++ )
+    {
+    const long step = 1L << ( level - 1 );
+    const PixelType * previous = &tables[( level - 1 ) * length];
+    PixelType * current = &tables[level * length];
+    for( long i=0; i<length - step; i++ )
+      { current[i] = Extremum( previous[i], previous[i + step] ); }
+    }
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel, class TCompare>
+void
+ChordErodeDilateImageFilter<TInputImage, TOutputImage, TKernel, TCompare>
+::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                       int threadId)
+{
+  OutputImageType* outputImage = this->GetOutput();
+  const InputImageType* inputImage = this->GetInput();
+  const RegionType inputRegion = inputImage->GetRequestedRegion();
+
+  const long nx = outputRegionForThread.GetSize()[0];
+
+  ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels() / nx);
+
+  // the extent of the chords on the first axis gives the part of the
+  // input lines stored in the tables, and the line of the kernel which is
+  // the first one in memory gives the oldest input line still used
+  long first = m_Chords[0].m_Start;
+  long last = m_Chords[0].m_Start + m_Chords[0].m_Length - 1;
+  OffsetType lowest = m_Chords[0].m_LineOffset;
+  OffsetMemoryOrderCompare< ImageDimension > memoryOrder;
+  for( unsigned long c=1; c<m_Chords.size(); c++ )
+    {
+    first = std::min( first, m_Chords[c].m_Start );
+    last = std::max( last, static_cast<long>( m_Chords[c].m_Start + m_Chords[c].m_Length - 1 ) );
+    if( memoryOrder( m_Chords[c].m_LineOffset, lowest ) )
+      { lowest = m_Chords[c].m_LineOffset; }
+    }
+  const long length = nx + last - first;
+
+  // the tables of the input lines, indexed by the position of the line.
+  // The output lines are visited in memory order, and the translation by
+  // the kernel keeps that order, so the tables of the lines before the
+  // oldest line used by the current output line can be dropped.
+  typedef std::map< OffsetType, TableType, OffsetMemoryOrderCompare< ImageDimension > > TableMapType;
+  TableMapType tables;
+  std::vector< PixelType > values( nx );
+
+  IndexType zero;
+  zero.Fill( 0 );
+
+  RegionType lineRegion = outputRegionForThread;
+  SizeType lineSize = lineRegion.GetSize();
+  lineSize[0] = 1;
+  lineRegion.SetSize( lineSize );
+
+  ImageRegionConstIteratorWithIndex< OutputImageType > lineIt( outputImage, lineRegion );
+  for( lineIt.GoToBegin(); !lineIt.IsAtEnd(); ++lineIt )
+    {
+    const IndexType lineStart = lineIt.GetIndex();
+    tables.erase( tables.begin(), tables.lower_bound( ( lineStart - zero ) + lowest ) );
+
+    for( unsigned long c=0; c<m_Chords.size(); c++ )
+      {
+      const ChordType & chord = m_Chords[c];
+      IndexType inputLineStart = lineStart + chord.m_LineOffset;
+
+      // the lines outside the input image contain only the boundary value
+      IndexType inside = inputLineStart;
+      inside[0] = inputRegion.GetIndex()[0];
+      if( !inputRegion.IsInside( inside ) )
+        {
+        for( long x=0; x<nx; x++ )
+          { values[x] = ( c == 0 ) ? m_Boundary : Extremum( values[x], m_Boundary ); }
+        continue;
+        }
+
+      TableType & lineTables = tables[ inputLineStart - zero ];
+      if( lineTables.empty() )
+        { this->BuildTables( inputLineStart, first, length, lineTables ); }
+
+      // the chord is covered by two segments of length 2^level, which
+      // overlap when the length of the chord is not a power of 2
+      const PixelType * segments = &lineTables[chord.m_Level * length + chord.m_Start - first];
+      const long shift = chord.m_Length - ( 1L << chord.m_Level );
+      if( c == 0 )
+        {
+        for( long x=0; x<nx; x++ )
+          { values[x] = Extremum( segments[x], segments[x + shift] ); }
+        }
+      else
+        {
+        for( long x=0; x<nx; x++ )
+          { values[x] = Extremum( values[x], Extremum( segments[x], segments[x + shift] ) ); }
+        }
+      }
+
+    OutputPixelType * outputPointer = outputImage->GetBufferPointer() + outputImage->ComputeOffset( lineStart );
+    for( long x=0; x<nx; x++ )
+      { outputPointer[x] = static_cast< OutputPixelType >( values[x] ); }
+    progress.CompletedPixel();
+    }
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel, class TCompare>
+void
+ChordErodeDilateImageFilter<TInputImage, TOutputImage, TKernel, TCompare>
+::PrintSelf(std::ostream &os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Boundary: " << static_cast<typename NumericTraits<PixelType>::PrintType>( m_Boundary ) << std::endl;
+  os << indent << "NumberOfChords: " << m_Chords.size() << std::endl;
+  os << indent << "NumberOfLevels: " << m_NumberOfLevels << std::endl;
+}
+
+}// end namespace itk
+#endif
@@ -0,0 +1,83 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkChordErodeImageFilter.h,v $
+  Language:  C++
+  Date:      $Date: 2006/04/28 12:00:00 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkChordErodeImageFilter_h
+#define __itkChordErodeImageFilter_h
+
+#include "itkChordErodeDilateImageFilter.h"
+#include <functional>
+
+namespace itk {
+
+/**
+ * \class ChordErodeImageFilter
+ * \brief gray scale erosion of an image with the chord algorithm
+ *
+ * Erode an image using grayscale morphology. Erosion takes the
+ * minimum of all the pixels identified by the structuring element.
+ *
+ * The structuring element is decomposed in chords: see
+ * ChordErodeDilateImageFilter.
+ *
+ * \sa MovingHistogramErodeImageFilter, ChordErodeDilateImageFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+
+template<class TInputImage, class TOutputImage, class TKernel>
+class ITK_EXPORT ChordErodeImageFilter :
+    public ChordErodeDilateImageFilter<TInputImage, TOutputImage, TKernel,
+      std::less<typename TInputImage::PixelType> >
+{
+public:
+  /** Standard class typedefs. */
+  typedef ChordErodeImageFilter Self;
+  typedef ChordErodeDilateImageFilter<TInputImage, TOutputImage, TKernel,
+      std::less<typename TInputImage::PixelType> >  Superclass;
+  typedef SmartPointer<Self>        Pointer;
+  typedef SmartPointer<const Self>  ConstPointer;
+
+  /** Standard New method. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(ChordErodeImageFilter,
+               ChordErodeDilateImageFilter);
+
+  /** Image related typedefs. */
+  typedef TInputImage InputImageType;
+  typedef TOutputImage OutputImageType;
+  typedef typename TInputImage::PixelType PixelType ;
+
+  /** Image related typedefs. */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TInputImage::ImageDimension);
+
+protected:
+  ChordErodeImageFilter()
+  {
+    this->m_Boundary = itk::NumericTraits< PixelType >::max();
+  }
+  ~ChordErodeImageFilter() {};
+
+private:
+  ChordErodeImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+} ; // end of class
+
+} // end namespace itk
+
+#endif
@@ -0,0 +1,91 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkColumnHistogramDilateImageFilter.h,v $
+  Language:  C++
+  Date:      $Date: 2006/04/22 12:00:00 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even 
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR 
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkColumnHistogramDilateImageFilter_h
+#define __itkColumnHistogramDilateImageFilter_h
+
+#include "itkColumnHistogramMorphologyImageFilter.h"
+
+namespace itk {
+
+/**
+ * \class ColumnHistogramDilateImageFilter
+ * \brief gray scale dilation of an image with a rectangular kernel
+ *
+ * Dilate an image using grayscale morphology. Dilation takes the
+ * maximum of all the pixels identified by the structuring element.
+ *
+ * The structuring element must be rectangular: see ColumnHistogramImageFilter.
+ * 
+ * \sa MovingHistogramDilateImageFilter, ColumnHistogramImageFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+
+
+template<class TInputImage, class TOutputImage, class TKernel>
+class ITK_EXPORT ColumnHistogramDilateImageFilter : 
+    public ColumnHistogramMorphologyImageFilter<TInputImage, TOutputImage, TKernel,
+      typename Function::MorphologyHistogram < typename TInputImage::PixelType, typename std::greater<typename TInputImage::PixelType> > >
+{
+public:
+  /** Standard class typedefs. */
+  typedef ColumnHistogramDilateImageFilter Self;
+  typedef ColumnHistogramMorphologyImageFilter<TInputImage, TOutputImage, TKernel,
+      typename Function::MorphologyHistogram < typename TInputImage::PixelType, typename std::greater<typename TInputImage::PixelType> > >  Superclass;
+  typedef SmartPointer<Self>        Pointer;
+  typedef SmartPointer<const Self>  ConstPointer;
+  
+  /** Standard New method. */
+  itkNewMacro(Self);  
+
+  /** Runtime information support. */
+  itkTypeMacro(ColumnHistogramDilateImageFilter, 
+               ColumnHistogramMorphologyImageFilter);
+  
+  /** Image related typedefs. */
+  typedef TInputImage InputImageType;
+  typedef TOutputImage OutputImageType;
+  typedef typename TInputImage::RegionType RegionType ;
+  typedef typename TInputImage::SizeType SizeType ;
+  typedef typename TInputImage::IndexType IndexType ;
+  typedef typename TInputImage::PixelType PixelType ;
+  typedef typename TInputImage::OffsetType OffsetType ;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+  typedef typename TOutputImage::PixelType OutputPixelType ;
+  
+  /** Image related typedefs. */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TInputImage::ImageDimension);
+                      
+
+protected:
+  ColumnHistogramDilateImageFilter()
+  {
+    this->m_Boundary = itk::NumericTraits< PixelType >::NonpositiveMin();
+  }
+  ~ColumnHistogramDilateImageFilter() {};
+
+private:
+  ColumnHistogramDilateImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+} ; // end of class
+
+} // end namespace itk
+  
+#endif
+
+
@@ -0,0 +1,192 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkColumnHistogramImageFilter.h,v $
+  Language:  C++
+  Date:      $Date: 2006/04/22 12:00:00 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even 
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR 
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkColumnHistogramImageFilter_h
+#define __itkColumnHistogramImageFilter_h
+
+#include "itkKernelImageFilter.h"
+#include "itkHistogramPool.h"
+#include <vector>
+
+namespace itk {
+
+/**
+ * \class ColumnHistogramImageFilter
+ * \brief Implements a generic algorithm based on column histograms for
+ * rectangular kernels
+ *
+ * This filter computes the same values as MovingHistogramImageFilter, but
+ * only for rectangular kernels (all the elements of the kernel are
+ * > 0), and with a cost per pixel which doesn't depend on the size of the
+ * kernel. It implements the algorithm described in
+ * Perreault S., Hebert P., "Median Filtering in Constant Time",
+ * IEEE Transactions on Image Processing, 16(9), 2007.
+ *
+ * The filter keeps one histogram per column of the image, which contains
+ * the pixels of the column covered by the kernel. When the kernel moves to
+ * the next row, each column histogram gets one new pixel and loses one.
+ * The histogram of the kernel is the sum of the column histograms it
+ * covers: when the kernel moves to the next pixel of the row, one column
+ * histogram is added to it and one is subtracted. The cost of those
+ * operations is proportional to the number of bins of the histograms.
+ *
+ * The column histograms are only used with the 8 bits pixel types. With
+ * 65536 bins, one histogram per column of a 1024 pixels wide image would
+ * use about 256 MB per thread. For the other pixel types, the pixels of
+ * the columns are read in the input image when the kernel moves along the
+ * row: the cost per pixel is proportional to the height of the kernel, as
+ * with MovingHistogramImageFilter. This filter is faster than
+ * MovingHistogramImageFilter for the large kernels on 8 bits images.
+ *
+ * The rows are along the first axis and the columns along the second one.
+ * The kernel must have a size of 1 on the other axes, if any: the slices
+ * of the image are processed independently.
+ *
+ * The histogram class must implement the concept described in
+ * MovingHistogramImageFilter, and also
+ * + void AddHistogram( const HistogramType & other ) adds the pixels of
+ * other to the histogram.
+ * + void SubtractHistogram( const HistogramType & other ) removes the
+ * pixels of other from the histogram. They must all be in the histogram.
+ * Those two methods are only used with the 8 bits pixel types.
+ * Reset() is used to empty the histograms. The histograms are kept
+ * between the updates in a HistogramPool, and freed by
+ * ReleaseScratchMemory().
+ *
+ * \sa MovingHistogramImageFilter, ColumnHistogramMorphologyImageFilter,
+ * ColumnHistogramMorphologicalGradientImageFilter, ColumnHistogramRankImageFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+
+template<class TInputImage, class TOutputImage, class TKernel, class THistogram >
+class ITK_EXPORT ColumnHistogramImageFilter : 
+    public KernelImageFilter<TInputImage, TOutputImage, TKernel>
+{
+public:
+  /** Standard class typedefs. */
+  typedef ColumnHistogramImageFilter Self;
+  typedef KernelImageFilter<TInputImage, TOutputImage, TKernel>  Superclass;
+  typedef SmartPointer<Self>        Pointer;
+  typedef SmartPointer<const Self>  ConstPointer;
+  
+  /** Standard New method. */
+  itkNewMacro(Self);  
+
+  /** Runtime information support. */
+  itkTypeMacro(ColumnHistogramImageFilter, 
+               KernelImageFilter);
+  
+  /** Image related typedefs. */
+  typedef TInputImage InputImageType;
+  typedef TOutputImage OutputImageType;
+  typedef typename TInputImage::RegionType RegionType ;
+  typedef typename TInputImage::SizeType SizeType ;
+  typedef typename TInputImage::IndexType IndexType ;
+  typedef typename TInputImage::PixelType PixelType ;
+  typedef typename TInputImage::OffsetType OffsetType ;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+  typedef typename TOutputImage::PixelType OutputPixelType ;
+  
+  /** Image related typedefs. */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TInputImage::ImageDimension);
+                      
+  /** Kernel typedef. */
+  typedef TKernel KernelType;
+  
+  /** Kernel (structuring element) iterator. */
+  typedef typename KernelType::ConstIterator KernelIteratorType ;
+
+  typedef THistogram HistogramType;
+
+  typedef typename OffsetType::OffsetValueType OffsetValueType;
+
+  /** Set kernel (structuring element). An exception is thrown if the
+   * kernel can't be used by this filter. */
+  void SetKernel( const KernelType& kernel );
+
+  /** Return true if the kernel is rectangular, and can be used by this
+   * filter */
+  static bool IsSupportedKernel( const KernelType& kernel );
+
+  /** Return true if the filter keeps one histogram per column, which is
+   * only the case for the 8 bits pixel types. */
+  static bool UseColumnHistograms()
+    { return sizeof( PixelType ) == 1; }
+
+  /** Free the histograms kept between the updates. They are allocated
+   * again by the next update. */
+  void ReleaseScratchMemory()
+    {
+    m_HistogramPool.Release();
+    }
+
+protected:
+  ColumnHistogramImageFilter() {};
+  ~ColumnHistogramImageFilter() {};
+  
+  /** Verify that the kernel can be used by this filter */
+  void BeforeThreadedGenerateData();
+
+  /** Multi-thread version GenerateData. */
+  void  ThreadedGenerateData (const OutputImageRegionType& 
+                              outputRegionForThread,
+                              int threadId) ;
+
+  /** NewHistogram must return an empty histogram object for the thread.
+   * It's also the good place to pass parameters to the histogram.
+   * A default version is provided which reset an histogram of the pool of
+   * the thread, or create a new Historgram, and return it.
+   */
+  virtual THistogram * NewHistogram( int threadId )
+    { return m_HistogramPool.Get( threadId ); }
+
+private:
+  ColumnHistogramImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  /** add to the histogram count pixels read from p with a step of
+   * stride, and boundaryCount boundary pixels */
+  inline static void AddColumn( HistogramType * histogram, const PixelType * p, OffsetValueType stride,
+                                long count, long boundaryCount )
+    {
+    for( long i=0; i<count; i++, p+=stride )
+      { histogram->AddPixel( *p ); }
+    for( long i=0; i<boundaryCount; i++ )
+      { histogram->AddBoundary(); }
+    }
+
+  inline static void RemoveColumn( HistogramType * histogram, const PixelType * p, OffsetValueType stride,
+                                   long count, long boundaryCount )
+    {
+    for( long i=0; i<count; i++, p+=stride )
+      { histogram->RemovePixel( *p ); }
+    for( long i=0; i<boundaryCount; i++ )
+      { histogram->RemoveBoundary(); }
+    }
+
+  // the histograms not used by the threads, kept between the runs
+  HistogramPool< THistogram > m_HistogramPool;
+
+} ; // end of class
+
+} // end namespace itk
+  
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkColumnHistogramImageFilter.txx"
+#endif
+
+#endif
@@ -0,0 +1,259 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkColumnHistogramImageFilter.txx,v $
+  Language:  C++
+  Date:      $Date: 2006/04/22 12:00:00 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even 
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR 
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkColumnHistogramImageFilter_txx
+#define __itkColumnHistogramImageFilter_txx
+
+#include "itkColumnHistogramImageFilter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkProgressReporter.h"
+#include <algorithm>
+
+namespace itk {
+
+
+template<class TInputImage, class TOutputImage, class TKernel, class THistogram>
+bool
+ColumnHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
+::IsSupportedKernel( const KernelType& kernel )
+{
+  if( ImageDimension < 2 )
+    { return false; }
+  for( unsigned int axis=2; axis<ImageDimension; axis++ )
+    {
+    if( kernel.GetSize()[axis] != 1 )
+      { return false; }
+    }
+  for( KernelIteratorType kernel_it=kernel.Begin(); kernel_it!=kernel.End(); ++kernel_it )
+    {
+    if( !( *kernel_it > 0 ) )
+      { return false; }
+    }
+  return true;
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel, class THistogram>
+void
+ColumnHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
+::SetKernel( const KernelType& kernel )
+{
+  if( !IsSupportedKernel( kernel ) )
+    { itkExceptionMacro( << "The kernel must be rectangular, with a size of 1 after the second axis." ); }
+  Superclass::SetKernel( kernel );
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel, class THistogram>
+void
+ColumnHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
+::BeforeThreadedGenerateData()
+{
+  // the default kernel is not valid in 3D
+  if( !IsSupportedKernel( this->GetKernel() ) )
+    { itkExceptionMacro( << "The kernel must be rectangular, with a size of 1 after the second axis." ); }
+
+  // a column histogram holds a column of the kernel, and the window the
+  // whole kernel plus the column added before the one removed
+  const unsigned long maximumCount = this->GetKernel().Size() + this->GetKernel().GetSize()[1];
+  if( maximumCount > THistogram::GetCountLimit() )
+    {
+    itkExceptionMacro( << "The kernel is too large for the counters of the histogram: "
+                       << maximumCount << " pixels, at most "
+                       << THistogram::GetCountLimit() << " are supported." );
+    }
+
+  // each thread takes its histograms from its own slot of the pool
+  m_HistogramPool.SetNumberOfThreads( this->GetNumberOfThreads() );
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel, class THistogram>
+void
+ColumnHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
+::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                       int threadId) 
+{
+  OutputImageType* outputImage = this->GetOutput();
+  const InputImageType* inputImage = this->GetInput();
+  const RegionType inputRegion = inputImage->GetRequestedRegion();
+  const OffsetValueType * offsetTable = inputImage->GetOffsetTable();
+  const OffsetValueType xStride = offsetTable[0];
+  const OffsetValueType yStride = offsetTable[1];
+
+  // the position of the first pixel of the kernel, relative to its center,
+  // and the size of the kernel
+  const SizeType kernelSize = this->GetKernel().GetSize();
+  const long left = -static_cast<long>( kernelSize[0] / 2 );
+  const long top = -static_cast<long>( kernelSize[1] / 2 );
+  const long width = kernelSize[0];
+  const long height = kernelSize[1];
+
+  const long nx = outputRegionForThread.GetSize()[0];
+  const long ny = outputRegionForThread.GetSize()[1];
+
+  // the columns covered by the kernel on a row of the region. The columns
+  // in [cBegin, cEnd) are in the input image: the other ones only contain
+  // boundary pixels.
+  const long nColumns = nx + width - 1;
+  const long firstColumnIndex = outputRegionForThread.GetIndex()[0] + left;
+  const long cBegin = std::max( 0L, inputRegion.GetIndex()[0] - firstColumnIndex );
+  const long cEnd = std::min( nColumns,
+    inputRegion.GetIndex()[0] + static_cast<long>( inputRegion.GetSize()[0] ) - firstColumnIndex );
+  const long rowBegin = inputRegion.GetIndex()[1];
+  const long rowEnd = rowBegin + static_cast<long>( inputRegion.GetSize()[1] );
+
+  ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels() / nx);
+
+  // the histogram of the kernel, and one histogram for each column when
+  // they are small enough. They are emptied with Reset().
+  const bool useColumnHistograms = UseColumnHistograms();
+  HistogramType * window = this->NewHistogram( threadId );
+  std::vector< HistogramType * > columns;
+  if( useColumnHistograms )
+    {
+    columns.resize( nColumns );
+    for( long c=0; c<nColumns; c++ )
+      { columns[c] = this->NewHistogram( threadId ); }
+    }
+
+  // iterate over the slices of the region
+  RegionType sliceRegion = outputRegionForThread;
+  SizeType sliceSize = sliceRegion.GetSize();
+  sliceSize[0] = 1;
+  sliceSize[1] = 1;
+  sliceRegion.SetSize( sliceSize );
+
+  ImageRegionConstIteratorWithIndex< OutputImageType > sliceIt( outputImage, sliceRegion );
+  for( sliceIt.GoToBegin(); !sliceIt.IsAtEnd(); ++sliceIt )
+    {
+    const IndexType sliceStart = sliceIt.GetIndex();
+
+    for( long y=0; y<ny; y++ )
+      {
+      // the rows of the kernel in the input image, and the first of its
+      // pixels in the first column in the input image
+      const long kernelTop = sliceStart[1] + y + top;
+      const long insideBegin = std::max( kernelTop, rowBegin );
+      const long insideCount = std::max( 0L, std::min( kernelTop + height, rowEnd ) - insideBegin );
+      const long boundaryCount = height - insideCount;
+      IndexType idx = sliceStart;
+      idx[0] = firstColumnIndex + cBegin;
+      idx[1] = insideBegin;
+      const PixelType * columnPointer = inputImage->GetBufferPointer() + inputImage->ComputeOffset( idx );
+
+      if( useColumnHistograms )
+        {
+        if( y == 0 )
+          {
+          // fill the columns for the first row
+          for( long c=0; c<nColumns; c++ )
+            {
+            columns[c]->Reset();
+            if( c >= cBegin && c < cEnd )
+              { AddColumn( columns[c], columnPointer + ( c - cBegin ) * xStride, yStride, insideCount, boundaryCount ); }
+            else
+              { AddColumn( columns[c], columnPointer, yStride, 0, height ); }
+            }
+          }
+        else
+          {
+          // move the columns to the current row: the new pixel is added
+          // before the old one is removed, so the column is never empty.
+          // The columns outside the input image don't change.
+          const long addedRow = kernelTop + height - 1;
+          const long removedRow = kernelTop - 1;
+          const bool addedInside = addedRow >= rowBegin && addedRow < rowEnd;
+          const bool removedInside = removedRow >= rowBegin && removedRow < rowEnd;
+          const PixelType * addedPointer = columnPointer + ( addedRow - insideBegin ) * yStride;
+          const PixelType * removedPointer = columnPointer + ( removedRow - insideBegin ) * yStride;
+          if( addedInside && removedInside )
+            {
+            for( long c=cBegin; c<cEnd; c++, addedPointer+=xStride, removedPointer+=xStride )
+              {
+              columns[c]->AddPixel( *addedPointer );
+              columns[c]->RemovePixel( *removedPointer );
+              }
+            }
+          else if( addedInside || removedInside )
+            {
+            for( long c=cBegin; c<cEnd; c++, addedPointer+=xStride, removedPointer+=xStride )
+              {
+              if( addedInside )
+                { columns[c]->AddPixel( *addedPointer ); }
+              else
+                { columns[c]->AddBoundary(); }
+              if( removedInside )
+                { columns[c]->RemovePixel( *removedPointer ); }
+              else
+                { columns[c]->RemoveBoundary(); }
+              }
+            }
+          }
+        }
+
+      // the histogram of the kernel at the beginning of the row
+      window->Reset();
+      for( long c=0; c<width; c++ )
+        {
+        if( useColumnHistograms )
+          { window->AddHistogram( *columns[c] ); }
+        else if( c >= cBegin && c < cEnd )
+          { AddColumn( window, columnPointer + ( c - cBegin ) * xStride, yStride, insideCount, boundaryCount ); }
+        else
+          { AddColumn( window, columnPointer, yStride, 0, height ); }
+        }
+
+      IndexType rowStart = sliceStart;
+      rowStart[1] = sliceStart[1] + y;
+      const PixelType * inputPointer = inputImage->GetBufferPointer() + inputImage->ComputeOffset( rowStart );
+      OutputPixelType * outputPointer = outputImage->GetBufferPointer() + outputImage->ComputeOffset( rowStart );
+
+      for( long x=0; x<nx; x++ )
+        {
+        outputPointer[x] = static_cast< OutputPixelType >( window->GetValue( inputPointer[x] ) );
+        if( x == nx - 1 )
+          { break; }
+
+        // move the kernel to the next pixel
+        const long added = x + width;
+        const long removed = x;
+        if( useColumnHistograms )
+          {
+          window->AddHistogram( *columns[added] );
+          window->SubtractHistogram( *columns[removed] );
+          continue;
+          }
+        if( added >= cBegin && added < cEnd )
+          { AddColumn( window, columnPointer + ( added - cBegin ) * xStride, yStride, insideCount, boundaryCount ); }
+        else
+          { AddColumn( window, columnPointer, yStride, 0, height ); }
+        if( removed >= cBegin && removed < cEnd )
+          { RemoveColumn( window, columnPointer + ( removed - cBegin ) * xStride, yStride, insideCount, boundaryCount ); }
+        else
+          { RemoveColumn( window, columnPointer, yStride, 0, height ); }
+        }
+      progress.CompletedPixel();
+      }
+    }
+
+  for( unsigned long c=0; c<columns.size(); c++ )
+    { m_HistogramPool.GiveBack( threadId, columns[c] ); }
+  m_HistogramPool.GiveBack( threadId, window );
+}
+
+}// end namespace itk
+#endif
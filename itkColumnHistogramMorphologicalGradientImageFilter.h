@@ -0,0 +1,97 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkColumnHistogramMorphologicalGradientImageFilter.h,v $
+  Language:  C++
+  Date:      $Date: 2006/04/22 12:00:00 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even 
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR 
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkColumnHistogramMorphologicalGradientImageFilter_h
+#define __itkColumnHistogramMorphologicalGradientImageFilter_h
+
+#include "itkColumnHistogramImageFilter.h"
+#include "itkMovingHistogramMorphologicalGradientImageFilter.h"
+
+namespace itk {
+
+/**
+ * \class ColumnHistogramMorphologicalGradientImageFilter
+ * \brief morphological gradient of an image with a rectangular kernel
+ *
+ * The morphological gradient is the difference between the dilation and
+ * the erosion of the image. This filter computes the same values as
+ * MovingHistogramMorphologicalGradientImageFilter, with the same
+ * histograms, but the structuring element must be rectangular: see
+ * ColumnHistogramImageFilter.
+ *
+ * \sa MovingHistogramMorphologicalGradientImageFilter, ColumnHistogramImageFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+
+template<class TInputImage, class TOutputImage, class TKernel>
+class ITK_EXPORT ColumnHistogramMorphologicalGradientImageFilter : 
+    public ColumnHistogramImageFilter<TInputImage, TOutputImage, TKernel,
+      typename Function::MorphologicalGradientHistogram< typename TInputImage::PixelType > >
+{
+public:
+  /** Standard class typedefs. */
+  typedef ColumnHistogramMorphologicalGradientImageFilter Self;
+  typedef ColumnHistogramImageFilter<TInputImage, TOutputImage, TKernel,
+      typename Function::MorphologicalGradientHistogram< typename TInputImage::PixelType > >  Superclass;
+  typedef SmartPointer<Self>        Pointer;
+  typedef SmartPointer<const Self>  ConstPointer;
+  
+  /** Standard New method. */
+  itkNewMacro(Self);  
+
+  /** Runtime information support. */
+  itkTypeMacro(ColumnHistogramMorphologicalGradientImageFilter, 
+               ColumnHistogramImageFilter);
+  
+  /** Image related typedefs. */
+  typedef TInputImage InputImageType;
+  typedef TOutputImage OutputImageType;
+  typedef typename TInputImage::RegionType RegionType ;
+  typedef typename TInputImage::SizeType SizeType ;
+  typedef typename TInputImage::IndexType IndexType ;
+  typedef typename TInputImage::PixelType PixelType ;
+  typedef typename TInputImage::OffsetType OffsetType ;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+  typedef typename TOutputImage::PixelType OutputPixelType ;
+
+  typedef typename Function::MorphologicalGradientHistogram< PixelType > HistogramType;
+  
+  /** Image related typedefs. */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TInputImage::ImageDimension);
+                      
+protected:
+  ColumnHistogramMorphologicalGradientImageFilter() {};
+  ~ColumnHistogramMorphologicalGradientImageFilter() {};
+
+  /** needed to pass the maximum count of the bins to the histogram object */
+  virtual HistogramType * NewHistogram( int threadId )
+    {
+    HistogramType * histogram = Superclass::NewHistogram( threadId );
+    // the kernel and one more column, before the old column is removed
+    histogram->SetMaximumCount( this->GetKernel().Size() + this->GetKernel().GetSize()[1] );
+    return histogram;
+    }
+
+private:
+  ColumnHistogramMorphologicalGradientImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+} ; // end of class
+
+} // end namespace itk
+  
+#endif
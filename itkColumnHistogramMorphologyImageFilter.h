@@ -0,0 +1,112 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkColumnHistogramMorphologyImageFilter.h,v $
+  Language:  C++
+  Date:      $Date: 2006/04/22 12:00:00 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even 
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR 
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkColumnHistogramMorphologyImageFilter_h
+#define __itkColumnHistogramMorphologyImageFilter_h
+
+#include "itkColumnHistogramImageFilter.h"
+#include "itkMovingHistogramMorphologyImageFilter.h"
+
+namespace itk {
+
+/**
+ * \class ColumnHistogramMorphologyImageFilter
+ * \brief base class for ColumnHistogramDilateImageFilter and ColumnHistogramErodeImageFilter
+ *
+ * This class adds the support for the boundaries to ColumnHistogramImageFilter,
+ * and uses the same histograms as MovingHistogramMorphologyImageFilter.
+ * 
+ * \sa ColumnHistogramImageFilter, MovingHistogramMorphologyImageFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+
+template<class TInputImage, class TOutputImage, class TKernel, class THistogram>
+class ITK_EXPORT ColumnHistogramMorphologyImageFilter : 
+    public ColumnHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
+{
+public:
+  /** Standard class typedefs. */
+  typedef ColumnHistogramMorphologyImageFilter Self;
+  typedef ColumnHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram> Superclass;
+  typedef SmartPointer<Self>        Pointer;
+  typedef SmartPointer<const Self>  ConstPointer;
+  
+  /** Standard New method. */
+  itkNewMacro(Self);  
+
+  /** Runtime information support. */
+  itkTypeMacro(ColumnHistogramMorphologyImageFilter, 
+               ColumnHistogramImageFilter);
+  
+  /** Image related typedefs. */
+  typedef TInputImage InputImageType;
+  typedef TOutputImage OutputImageType;
+  typedef typename TInputImage::RegionType RegionType ;
+  typedef typename TInputImage::SizeType SizeType ;
+  typedef typename TInputImage::IndexType IndexType ;
+  typedef typename TInputImage::PixelType PixelType ;
+  typedef typename TInputImage::OffsetType OffsetType ;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+  typedef typename TOutputImage::PixelType OutputPixelType ;
+  
+  /** Image related typedefs. */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TInputImage::ImageDimension);
+                      
+  /** Kernel typedef. */
+  typedef TKernel KernelType;
+
+  /** Set/Get the boundary value. */
+  itkSetMacro(Boundary, PixelType);
+  itkGetMacro(Boundary, PixelType);
+
+protected:
+  ColumnHistogramMorphologyImageFilter()
+    {
+    // default m_boundary should be set by subclasses. Just provide a default
+    // value to always get the same behavior if it is not done
+    m_Boundary = itk::NumericTraits< PixelType >::Zero;
+    }
+  ~ColumnHistogramMorphologyImageFilter() {};
+
+  void PrintSelf(std::ostream& os, Indent indent) const
+    {
+    Superclass::PrintSelf(os, indent);
+    os << indent << "Boundary: " << m_Boundary << std::endl;
+    }
+
+  /** needed to pass the boundary value and the maximum count of the bins
+   * to the histogram object */
+  virtual THistogram * NewHistogram( int threadId )
+    {
+    THistogram * histogram = Superclass::NewHistogram( threadId );
+    histogram->SetBoundary( m_Boundary );
+    // the kernel and one more column, before the old column is removed
+    histogram->SetMaximumCount( this->GetKernel().Size() + this->GetKernel().GetSize()[1] );
+    return histogram;
+    }
+
+  PixelType m_Boundary;
+
+private:
+  ColumnHistogramMorphologyImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+} ; // end of class
+
+} // end namespace itk
+  
+#endif
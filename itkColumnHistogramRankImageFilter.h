@@ -0,0 +1,119 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkColumnHistogramRankImageFilter.h,v $
+  Language:  C++
+  Date:      $Date: 2006/04/22 12:00:00 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even 
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR 
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkColumnHistogramRankImageFilter_h
+#define __itkColumnHistogramRankImageFilter_h
+
+#include "itkColumnHistogramImageFilter.h"
+#include "itkMovingHistogramRankImageFilter.h"
+
+namespace itk {
+
+/**
+ * \class ColumnHistogramRankImageFilter
+ * \brief rank filter of an image with a rectangular kernel
+ *
+ * Each output pixel is the value of the given rank in the neighborhood
+ * defined by the kernel: rank 0 is the lowest value, rank 1 the highest
+ * value, and rank 0.5 the median. This filter computes the same values
+ * as MovingHistogramRankImageFilter, with the same histograms, but the
+ * structuring element must be rectangular: see ColumnHistogramImageFilter.
+ *
+ * The column histograms are only used with 8 bits images: with the other
+ * pixel types, the cost per pixel is the one of
+ * MovingHistogramRankImageFilter.
+ *
+ * \sa MovingHistogramRankImageFilter, ColumnHistogramImageFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+
+template<class TInputImage, class TOutputImage, class TKernel>
+class ITK_EXPORT ColumnHistogramRankImageFilter : 
+    public ColumnHistogramImageFilter<TInputImage, TOutputImage, TKernel,
+      typename Function::RankHistogram< typename TInputImage::PixelType > >
+{
+public:
+  /** Standard class typedefs. */
+  typedef ColumnHistogramRankImageFilter Self;
+  typedef ColumnHistogramImageFilter<TInputImage, TOutputImage, TKernel,
+      typename Function::RankHistogram< typename TInputImage::PixelType > >  Superclass;
+  typedef SmartPointer<Self>        Pointer;
+  typedef SmartPointer<const Self>  ConstPointer;
+  
+  /** Standard New method. */
+  itkNewMacro(Self);  
+
+  /** Runtime information support. */
+  itkTypeMacro(ColumnHistogramRankImageFilter, 
+               ColumnHistogramImageFilter);
+  
+  /** Image related typedefs. */
+  typedef TInputImage InputImageType;
+  typedef TOutputImage OutputImageType;
+  typedef typename TInputImage::RegionType RegionType ;
+  typedef typename TInputImage::SizeType SizeType ;
+  typedef typename TInputImage::IndexType IndexType ;
+  typedef typename TInputImage::PixelType PixelType ;
+  typedef typename TInputImage::OffsetType OffsetType ;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+  typedef typename TOutputImage::PixelType OutputPixelType ;
+
+  typedef typename Function::RankHistogram< PixelType > HistogramType;
+  
+  /** Image related typedefs. */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TInputImage::ImageDimension);
+
+  /** Set/Get the rank, between 0 (the lowest value) and 1 (the highest
+   * value). Default is 0.5, the median. */
+  itkSetClampMacro(Rank, float, 0.0, 1.0);
+  itkGetMacro(Rank, float);
+
+protected:
+  ColumnHistogramRankImageFilter()
+    {
+    m_Rank = 0.5;
+    }
+  ~ColumnHistogramRankImageFilter() {};
+
+  void PrintSelf(std::ostream& os, Indent indent) const
+    {
+    Superclass::PrintSelf(os, indent);
+    os << indent << "Rank: " << m_Rank << std::endl;
+    }
+
+  /** needed to pass the rank and the maximum count of the bins to the
+   * histogram object */
+  virtual HistogramType * NewHistogram( int threadId )
+    {
+    HistogramType * histogram = Superclass::NewHistogram( threadId );
+    histogram->SetRank( m_Rank );
+    // the kernel and one more column, before the old column is removed
+    histogram->SetMaximumCount( this->GetKernel().Size() + this->GetKernel().GetSize()[1] );
+    return histogram;
+    }
+
+  float m_Rank;
+
+private:
+  ColumnHistogramRankImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+} ; // end of class
+
+} // end namespace itk
+  
+#endif
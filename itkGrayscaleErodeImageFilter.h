@@ -22,7 +22,8 @@
 #include "itkBasicErodeImageFilter.h"
 #include "itkAnchorErodeImageFilter.h"
 #include "itkvHGWErodeImageFilter.h"
-#include "itkCastImageFilter.h"
+#include "itkColumnHistogramErodeImageFilter.h"
+#include "itkChordErodeImageFilter.h"
 #include "itkConstantBoundaryCondition.h"
 #include "itkFlatStructuringElement.h"
 #include "itkNeighborhood.h"
@@ -77,11 +78,13 @@ public:
   typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
 
   typedef MovingHistogramErodeImageFilter< TInputImage, TOutputImage, TKernel > HistogramFilterType;
+  typedef MovingHistogramErodeImageFilter< TInputImage, TOutputImage, TKernel, unsigned short > ShortHistogramFilterType;
   typedef BasicErodeImageFilter< TInputImage, TOutputImage, TKernel > BasicFilterType;
   typedef FlatStructuringElement< ImageDimension > FlatKernelType;
-  typedef AnchorErodeImageFilter< TInputImage, FlatKernelType > AnchorFilterType;
-  typedef vHGWErodeImageFilter< TInputImage, FlatKernelType > VHGWFilterType;
-  typedef CastImageFilter< TInputImage, TOutputImage > CastFilterType;
+  typedef AnchorErodeImageFilter< TInputImage, FlatKernelType, TOutputImage > AnchorFilterType;
+  typedef vHGWErodeImageFilter< TInputImage, FlatKernelType, TOutputImage > VHGWFilterType;
+  typedef ColumnHistogramErodeImageFilter< TInputImage, TOutputImage, TKernel > ColumnFilterType;
+  typedef ChordErodeImageFilter< TInputImage, TOutputImage, TKernel > ChordFilterType;
   
   /** Typedef for boundary conditions. */
   typedef ImageBoundaryCondition<InputImageType> *ImageBoundaryConditionPointerType;
@@ -104,6 +107,11 @@ public:
   /** Set/Get the backend filter class. */
   void SetAlgorithm(int algo );
   itkGetMacro(Algorithm, int);
+
+  /** Get whether the histogram algorithm uses 16 bits counters. They are
+   * selected by SetKernel() when the kernel is small enough, and halve
+   * the memory of the histograms. */
+  itkGetMacro(UseShortCounters, bool);
   
   /** GrayscaleErodeImageFilter need to set its internal filters as modified */
   virtual void Modified() const;
@@ -143,6 +151,8 @@ public:
   static const int HISTO = 1;
   static const int ANCHOR = 2;
   static const int VHGW = 3;
+  static const int COLUMN = 4;
+  static const int CHORD = 5;
 
   void SetNumberOfThreads( int nb );
 
@@ -158,17 +168,30 @@ private:
   GrayscaleErodeImageFilter(const Self&); //purposely not implemented
   void operator=(const Self&); //purposely not implemented
 
+  /** Set the kernel of the histogram filters, and select the width of the
+   * counters from the size of the histogram. */
+  void SetHistogramKernel( const KernelType& kernel );
+
+  /** Return true when the chords are expected to be faster than the moving
+   * histogram. SetHistogramKernel() must have been called before. */
+  bool UseChords( const KernelType& kernel ) const;
+
   PixelType m_Boundary;
 
   // the filters used internally
   typename HistogramFilterType::Pointer m_HistogramFilter;
+  typename ShortHistogramFilterType::Pointer m_ShortHistogramFilter;
   typename BasicFilterType::Pointer m_BasicFilter;
   typename AnchorFilterType::Pointer m_AnchorFilter;
   typename VHGWFilterType::Pointer m_VHGWFilter;
+  typename ColumnFilterType::Pointer m_ColumnFilter;
+  typename ChordFilterType::Pointer m_ChordFilter;
 
   // and the name of the filter
   int m_Algorithm;
 
+  bool m_UseShortCounters;
+
   // the boundary condition need to be stored here
   DefaultBoundaryConditionType m_BoundaryCondition;
   
@@ -31,9 +31,13 @@ GrayscaleErodeImageFilter<TInputImage, TOutputImage, TKernel>
 {
   m_BasicFilter = BasicFilterType::New();
   m_HistogramFilter = HistogramFilterType::New();
+  m_ShortHistogramFilter = ShortHistogramFilterType::New();
   m_AnchorFilter = AnchorFilterType::New();
   m_VHGWFilter = VHGWFilterType::New();
+  m_ColumnFilter = ColumnFilterType::New();
+  m_ChordFilter = ChordFilterType::New();
   m_Algorithm = HISTO;
+  m_UseShortCounters = false;
 
   this->SetBoundary( itk::NumericTraits< PixelType >::max() );
 }
@@ -45,8 +49,11 @@ GrayscaleErodeImageFilter< TInputImage, TOutputImage, TKernel>
 {
   Superclass::SetNumberOfThreads( nb );
   m_HistogramFilter->SetNumberOfThreads( nb );
+  m_ShortHistogramFilter->SetNumberOfThreads( nb );
   m_AnchorFilter->SetNumberOfThreads( nb );
   m_VHGWFilter->SetNumberOfThreads( nb );
+  m_ColumnFilter->SetNumberOfThreads( nb );
+  m_ChordFilter->SetNumberOfThreads( nb );
   m_BasicFilter->SetNumberOfThreads( nb );
 }
 
@@ -71,7 +78,23 @@ GrayscaleErodeImageFilter< TInputImage, TOutputImage, TKernel>
     {
     // histogram based filter is as least as good as the basic one, so always use it
     m_Algorithm = HISTO;
-    m_HistogramFilter->SetKernel( kernel );
+    this->SetHistogramKernel( kernel );
+
+    // the column histograms have a constant cost per pixel, which is lower than the
+    // cost of the moving histogram for the large rectangles when the histogram is small.
+    // The threshold on the number of pixels per translation can be checked with
+    // perf_column.
+    if( ColumnFilterType::UseColumnHistograms() && ColumnFilterType::IsSupportedKernel( kernel )
+        && m_HistogramFilter->GetPixelsPerTranslation() > 32 )
+      {
+      m_ColumnFilter->SetKernel( kernel );
+      m_Algorithm = COLUMN;
+      }
+    else if( this->UseChords( kernel ) )
+      {
+      m_ChordFilter->SetKernel( kernel );
+      m_Algorithm = CHORD;
+      }
     }
   else 
     {
@@ -80,7 +103,7 @@ GrayscaleErodeImageFilter< TInputImage, TOutputImage, TKernel>
     // select the histogram for large kernels
 
     // we need to set the kernel on the histogram filter to compare basic and histogram algorithm
-    m_HistogramFilter->SetKernel( kernel );
+    this->SetHistogramKernel( kernel );
 
     if( ( ImageDimension == 2 && this->GetKernel().Size() < m_HistogramFilter->GetPixelsPerTranslation() * 5.4 )
         || ( ImageDimension == 3 && this->GetKernel().Size() < m_HistogramFilter->GetPixelsPerTranslation() * 4.5 ) )
@@ -88,6 +111,11 @@ GrayscaleErodeImageFilter< TInputImage, TOutputImage, TKernel>
       m_BasicFilter->SetKernel( kernel );
       m_Algorithm = BASIC;
       }
+    else if( this->UseChords( kernel ) )
+      {
+      m_ChordFilter->SetKernel( kernel );
+      m_Algorithm = CHORD;
+      }
     else
       {
       m_Algorithm = HISTO;
@@ -97,6 +125,41 @@ GrayscaleErodeImageFilter< TInputImage, TOutputImage, TKernel>
   Superclass::SetKernel( kernel );
 }
 
+template< class TInputImage, class TOutputImage, class TKernel>
+bool
+GrayscaleErodeImageFilter< TInputImage, TOutputImage, TKernel>
+::UseChords( const KernelType& kernel ) const
+{
+  // each translation of the histogram adds and removes
+  // GetPixelsPerTranslation() pixels, while the chords only need a lookup
+  // in a table per chord. The chord tables are not worth their setup cost
+  // for the small kernels: the thresholds can be checked with the ball and
+  // annulus sweep of perf_strel_size.
+  const double pixelsPerTranslation = m_HistogramFilter->GetPixelsPerTranslation();
+  return pixelsPerTranslation > 20
+    && ChordFilterType::EstimateCost( kernel ) < pixelsPerTranslation * 2;
+}
+
+template< class TInputImage, class TOutputImage, class TKernel>
+void
+GrayscaleErodeImageFilter< TInputImage, TOutputImage, TKernel>
+::SetHistogramKernel( const KernelType& kernel )
+{
+  m_HistogramFilter->SetKernel( kernel );
+
+  // the 16 bits counters are only useful for the histograms with an array
+  // of counters, and can only be used if the kernel is small enough. The
+  // kernel is preprocessed only once: the second filter finds it in the
+  // kernel cache.
+  m_UseShortCounters =
+    ShortHistogramFilterType::HistogramType::GetCountLimit() < HistogramFilterType::HistogramType::GetCountLimit()
+    && m_HistogramFilter->GetMaximumHistogramCount() <= ShortHistogramFilterType::HistogramType::GetCountLimit();
+  if( m_UseShortCounters )
+    {
+    m_ShortHistogramFilter->SetKernel( kernel );
+    }
+}
+
 template< class TInputImage, class TOutputImage, class TKernel>
 void
 GrayscaleErodeImageFilter< TInputImage, TOutputImage, TKernel>
@@ -104,8 +167,11 @@ GrayscaleErodeImageFilter< TInputImage, TOutputImage, TKernel>
 {
   m_Boundary = value;
   m_HistogramFilter->SetBoundary( value );
+  m_ShortHistogramFilter->SetBoundary( value );
   m_AnchorFilter->SetBoundary(value);
   m_VHGWFilter->SetBoundary(value);
+  m_ColumnFilter->SetBoundary( value );
+  m_ChordFilter->SetBoundary( value );
   m_BoundaryCondition.SetConstant( value );
   m_BasicFilter->OverrideBoundaryCondition( &m_BoundaryCondition );
 }
@@ -129,7 +195,7 @@ GrayscaleErodeImageFilter< TInputImage, TOutputImage, TKernel>
       }
     else if( algo == HISTO )
       {
-      m_HistogramFilter->SetKernel( this->GetKernel() );
+      this->SetHistogramKernel( this->GetKernel() );
       }
     else if( flatKernel != NULL && flatKernel->GetDecomposable() && algo == ANCHOR )
       {
@@ -139,6 +205,14 @@ GrayscaleErodeImageFilter< TInputImage, TOutputImage, TKernel>
       {
       m_VHGWFilter->SetKernel( *flatKernel );
       }
+    else if( algo == COLUMN && ColumnFilterType::IsSupportedKernel( this->GetKernel() ) )
+      {
+      m_ColumnFilter->SetKernel( this->GetKernel() );
+      }
+    else if( algo == CHORD )
+      {
+      m_ChordFilter->SetKernel( this->GetKernel() );
+      }
     else
       { itkExceptionMacro( << "Invalid algorithm" ); }
 
@@ -171,6 +245,16 @@ GrayscaleErodeImageFilter<TInputImage, TOutputImage, TKernel>
     m_BasicFilter->Update();
     this->GraftOutput( m_BasicFilter->GetOutput() );
     }
+  else if( m_Algorithm == HISTO && m_UseShortCounters )
+    {
+    itkDebugMacro("Running MovingHistogramErodeImageFilter with 16 bits counters");
+    m_ShortHistogramFilter->SetInput( this->GetInput() );
+    progress->RegisterInternalFilter( m_ShortHistogramFilter, 1.0f );
+    
+    m_ShortHistogramFilter->GraftOutput( this->GetOutput() );
+    m_ShortHistogramFilter->Update();
+    this->GraftOutput( m_ShortHistogramFilter->GetOutput() );
+    }
   else if( m_Algorithm == HISTO )
     {
     itkDebugMacro("Running MovingHistogramErodeImageFilter");
@@ -181,33 +265,45 @@ GrayscaleErodeImageFilter<TInputImage, TOutputImage, TKernel>
     m_HistogramFilter->Update();
     this->GraftOutput( m_HistogramFilter->GetOutput() );
     }
+  else if( m_Algorithm == COLUMN )
+    {
+    itkDebugMacro("Running ColumnHistogramErodeImageFilter");
+    m_ColumnFilter->SetInput( this->GetInput() );
+    progress->RegisterInternalFilter( m_ColumnFilter, 1.0f );
+    
+    m_ColumnFilter->GraftOutput( this->GetOutput() );
+    m_ColumnFilter->Update();
+    this->GraftOutput( m_ColumnFilter->GetOutput() );
+    }
+  else if( m_Algorithm == CHORD )
+    {
+    itkDebugMacro("Running ChordErodeImageFilter");
+    m_ChordFilter->SetInput( this->GetInput() );
+    progress->RegisterInternalFilter( m_ChordFilter, 1.0f );
+    
+    m_ChordFilter->GraftOutput( this->GetOutput() );
+    m_ChordFilter->Update();
+    this->GraftOutput( m_ChordFilter->GetOutput() );
+    }
   else if( m_Algorithm == ANCHOR )
     {
     itkDebugMacro("Running AnchorErodeImageFilter");
     m_AnchorFilter->SetInput( this->GetInput() );
-    progress->RegisterInternalFilter( m_AnchorFilter, 0.9f );
-
-    typename CastFilterType::Pointer cast = CastFilterType::New();
-    cast->SetInput( m_AnchorFilter->GetOutput() );
-    progress->RegisterInternalFilter( cast, 0.1f );
+    progress->RegisterInternalFilter( m_AnchorFilter, 1.0f );
     
-    cast->GraftOutput( this->GetOutput() );
-    cast->Update();
-    this->GraftOutput( cast->GetOutput() );
+    m_AnchorFilter->GraftOutput( this->GetOutput() );
+    m_AnchorFilter->Update();
+    this->GraftOutput( m_AnchorFilter->GetOutput() );
     }
   else if( m_Algorithm == VHGW )
     {
     itkDebugMacro("Running vHGWErodeImageFilter");
     m_VHGWFilter->SetInput( this->GetInput() );
-    progress->RegisterInternalFilter( m_VHGWFilter, 0.9f );
-
-    typename CastFilterType::Pointer cast = CastFilterType::New();
-    cast->SetInput( m_VHGWFilter->GetOutput() );
-    progress->RegisterInternalFilter( cast, 0.1f );
+    progress->RegisterInternalFilter( m_VHGWFilter, 1.0f );
     
-    cast->GraftOutput( this->GetOutput() );
-    cast->Update();
-    this->GraftOutput( cast->GetOutput() );
+    m_VHGWFilter->GraftOutput( this->GetOutput() );
+    m_VHGWFilter->Update();
+    this->GraftOutput( m_VHGWFilter->GetOutput() );
     }
 
 }
@@ -220,8 +316,11 @@ GrayscaleErodeImageFilter<TInputImage, TOutputImage, TKernel>
   Superclass::Modified();
   m_BasicFilter->Modified();
   m_HistogramFilter->Modified();
+  m_ShortHistogramFilter->Modified();
   m_AnchorFilter->Modified();
   m_VHGWFilter->Modified();
+  m_ColumnFilter->Modified();
+  m_ChordFilter->Modified();
 }
 
 template<class TInputImage, class TOutputImage, class TKernel>
@@ -233,6 +332,7 @@ GrayscaleErodeImageFilter<TInputImage, TOutputImage, TKernel>
 
   os << indent << "Boundary: " <<  static_cast<typename NumericTraits<PixelType>::PrintType>( m_Boundary ) << std::endl;
   os << indent << "Algorithm: " << m_Algorithm << std::endl;
+  os << indent << "UseShortCounters: " << m_UseShortCounters << std::endl;
 }
 
 }// end namespace itk
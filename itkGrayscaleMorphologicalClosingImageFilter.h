@@ -25,7 +25,6 @@
 #include "itkAnchorCloseImageFilter.h"
 #include "itkvHGWErodeImageFilter.h"
 #include "itkvHGWDilateImageFilter.h"
-#include "itkCastImageFilter.h"
 #include "itkConstantBoundaryCondition.h"
 #include "itkFlatStructuringElement.h"
 #include "itkNeighborhood.h"
@@ -84,10 +83,9 @@ public:
   typedef MovingHistogramDilateImageFilter< TInputImage, TOutputImage, TKernel > HistogramDilateFilterType;
   typedef BasicDilateImageFilter< TInputImage, TInputImage, TKernel > BasicDilateFilterType;
   typedef BasicErodeImageFilter< TInputImage, TOutputImage, TKernel > BasicErodeFilterType;
-  typedef AnchorCloseImageFilter< TInputImage, FlatKernelType > AnchorFilterType;
-  typedef vHGWErodeImageFilter< TInputImage, FlatKernelType > vHGWErodeFilterType;
+  typedef AnchorCloseImageFilter< TInputImage, FlatKernelType, TOutputImage > AnchorFilterType;
+  typedef vHGWErodeImageFilter< TInputImage, FlatKernelType, TOutputImage > vHGWErodeFilterType;
   typedef vHGWDilateImageFilter< TInputImage, FlatKernelType > vHGWDilateFilterType;
-  typedef CastImageFilter< TInputImage, TOutputImage > SubtractFilterType;
   
   /** Kernel typedef. */
   typedef TKernel KernelType;
@@ -290,7 +290,7 @@ GrayscaleMorphologicalClosingImageFilter<TInputImage, TOutputImage, TKernel>
       m_AnchorFilter->SetInput( pad->GetOutput() );
       progress->RegisterInternalFilter( m_AnchorFilter, 0.8f );
 
-      typedef typename itk::CropImageFilter<TInputImage, TOutputImage> CropType;
+      typedef typename itk::CropImageFilter<TOutputImage, TOutputImage> CropType;
       typename CropType::Pointer crop = CropType::New();
       crop->SetInput( m_AnchorFilter->GetOutput() );
       crop->SetUpperBoundaryCropSize( this->GetKernel().GetRadius() );
@@ -304,16 +304,11 @@ GrayscaleMorphologicalClosingImageFilter<TInputImage, TOutputImage, TKernel>
     else
       {
       m_AnchorFilter->SetInput( this->GetInput() );
-      progress->RegisterInternalFilter( m_AnchorFilter, 0.9f );
-  
-      typedef typename itk::CastImageFilter<TInputImage, TOutputImage> CastType;
-      typename CastType::Pointer cast = CastType::New();
-      cast->SetInput( m_AnchorFilter->GetOutput() );
-      progress->RegisterInternalFilter( cast, 0.1f );
+      progress->RegisterInternalFilter( m_AnchorFilter, 1.0f );
   
-      cast->GraftOutput( this->GetOutput() );
-      cast->Update();
-      this->GraftOutput( cast->GetOutput() );
+      m_AnchorFilter->GraftOutput( this->GetOutput() );
+      m_AnchorFilter->Update();
+      this->GraftOutput( m_AnchorFilter->GetOutput() );
       }
     }
 
@@ -25,7 +25,6 @@
 #include "itkAnchorOpenImageFilter.h"
 #include "itkvHGWErodeImageFilter.h"
 #include "itkvHGWDilateImageFilter.h"
-#include "itkCastImageFilter.h"
 #include "itkConstantBoundaryCondition.h"
 #include "itkFlatStructuringElement.h"
 #include "itkNeighborhood.h"
@@ -84,10 +83,9 @@ public:
   typedef MovingHistogramErodeImageFilter< TInputImage, TOutputImage, TKernel > HistogramErodeFilterType;
   typedef BasicErodeImageFilter< TInputImage, TInputImage, TKernel > BasicErodeFilterType;
   typedef BasicDilateImageFilter< TInputImage, TOutputImage, TKernel > BasicDilateFilterType;
-  typedef AnchorOpenImageFilter< TInputImage, FlatKernelType > AnchorFilterType;
+  typedef AnchorOpenImageFilter< TInputImage, FlatKernelType, TOutputImage > AnchorFilterType;
   typedef vHGWErodeImageFilter< TInputImage, FlatKernelType > vHGWErodeFilterType;
-  typedef vHGWDilateImageFilter< TInputImage, FlatKernelType > vHGWDilateFilterType;
-  typedef CastImageFilter< TInputImage, TOutputImage > SubtractFilterType;
+  typedef vHGWDilateImageFilter< TInputImage, FlatKernelType, TOutputImage > vHGWDilateFilterType;
   
   /** Kernel typedef. */
   typedef TKernel KernelType;
@@ -250,7 +250,7 @@ GrayscaleMorphologicalOpeningImageFilter<TInputImage, TOutputImage, TKernel>
       m_vHGWDilateFilter->SetInput( m_vHGWErodeFilter->GetOutput() );
       progress->RegisterInternalFilter( m_vHGWDilateFilter, 0.4f );
 
-      typedef typename itk::CropImageFilter<TInputImage, TOutputImage> CropType;
+      typedef typename itk::CropImageFilter<TOutputImage, TOutputImage> CropType;
       typename CropType::Pointer crop = CropType::New();
       crop->SetInput( m_vHGWDilateFilter->GetOutput() );
       crop->SetUpperBoundaryCropSize( this->GetKernel().GetRadius() );
@@ -270,14 +270,8 @@ GrayscaleMorphologicalOpeningImageFilter<TInputImage, TOutputImage, TKernel>
       progress->RegisterInternalFilter( m_vHGWDilateFilter, 0.5f );
 
       m_vHGWDilateFilter->GraftOutput( this->GetOutput() );
-      typedef typename itk::CastImageFilter<TInputImage, TOutputImage> CastType;
-      typename CastType::Pointer cast = CastType::New();
-      cast->SetInput( m_vHGWDilateFilter->GetOutput() );
-      progress->RegisterInternalFilter( cast, 0.1f );
-  
-      cast->GraftOutput( this->GetOutput() );
-      cast->Update();
-      this->GraftOutput( cast->GetOutput() );
+      m_vHGWDilateFilter->Update();
+      this->GraftOutput( m_vHGWDilateFilter->GetOutput() );
       }
     }
   else if( m_Algorithm == ANCHOR )
@@ -296,7 +290,7 @@ GrayscaleMorphologicalOpeningImageFilter<TInputImage, TOutputImage, TKernel>
       m_AnchorFilter->SetInput( pad->GetOutput() );
       progress->RegisterInternalFilter( m_AnchorFilter, 0.8f );
 
-      typedef typename itk::CropImageFilter<TInputImage, TOutputImage> CropType;
+      typedef typename itk::CropImageFilter<TOutputImage, TOutputImage> CropType;
       typename CropType::Pointer crop = CropType::New();
       crop->SetInput( m_AnchorFilter->GetOutput() );
       crop->SetUpperBoundaryCropSize( this->GetKernel().GetRadius() );
@@ -310,16 +304,11 @@ GrayscaleMorphologicalOpeningImageFilter<TInputImage, TOutputImage, TKernel>
     else
       {
       m_AnchorFilter->SetInput( this->GetInput() );
-      progress->RegisterInternalFilter( m_AnchorFilter, 0.9f );
-  
-      typedef typename itk::CastImageFilter<TInputImage, TOutputImage> CastType;
-      typename CastType::Pointer cast = CastType::New();
-      cast->SetInput( m_AnchorFilter->GetOutput() );
-      progress->RegisterInternalFilter( cast, 0.1f );
+      progress->RegisterInternalFilter( m_AnchorFilter, 1.0f );
   
-      cast->GraftOutput( this->GetOutput() );
-      cast->Update();
-      this->GraftOutput( cast->GetOutput() );
+      m_AnchorFilter->GraftOutput( this->GetOutput() );
+      m_AnchorFilter->Update();
+      this->GraftOutput( m_AnchorFilter->GetOutput() );
       }
     }
 
@@ -0,0 +1,153 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkHistogramChangedBlocks.h,v $
+  Language:  C++
+  Date:      $Date: 2006/04/12 12:00:00 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkHistogramChangedBlocks_h
+#define __itkHistogramChangedBlocks_h
+
+#include <vector>
+#include <algorithm>
+#include "itkHistogramOccupancyBitmap.h"
+
+namespace itk {
+
+namespace Function {
+
+/** \class HistogramChangedBlocks
+ * \brief Record the blocks of 64 bins modified in a histogram
+ *
+ * The vector based histograms with a large number of bins use this
+ * class to restore their state from a reference histogram by copying
+ * only the blocks of bins modified since they were identical, instead
+ * of copying the whole histogram, or to empty themselves by clearing
+ * only the blocks modified since they were empty. A block of 64 bins
+ * matches a word of the first level of HistogramOccupancyBitmap.
+ */
+class HistogramChangedBlocks
+{
+public:
+  typedef HistogramOccupancyBitmap::WordType WordType;
+
+  HistogramChangedBlocks()
+    {
+    m_NumberOfBlocks = 0;
+    }
+  ~HistogramChangedBlocks(){}
+
+  /** Allocate the storage for the given number of bins, with no block
+   * marked as changed. */
+  inline void Initialize( unsigned long numberOfBins )
+    {
+    m_NumberOfBlocks = ( numberOfBins + 63 ) / 64;
+    m_Words.assign( ( m_NumberOfBlocks + 63 ) / 64, 0 );
+    }
+
+  /** Mark the block of the bin as changed */
+  inline void Set( unsigned long bin )
+    { m_Words[ bin >> 12 ] |= HistogramOccupancyBitmap::Bit( ( bin >> 6 ) & 63 ); }
+
+  /** Mark all the blocks as changed */
+  inline void SetAll()
+    {
+    for( unsigned long i=0; i<m_Words.size(); i++ )
+      {
+      const unsigned long nbOfBlocks = std::min( m_NumberOfBlocks - ( i << 6 ), 64UL );
+      m_Words[i] = nbOfBlocks == 64 ? ~static_cast< WordType >( 0 ) : HistogramOccupancyBitmap::Bit( nbOfBlocks ) - 1;
+      }
+    }
+
+  /** Add the changed blocks of other to this object */
+  inline void Merge( const HistogramChangedBlocks & other )
+    {
+    for( unsigned long i=0; i<m_Words.size(); i++ )
+      { m_Words[i] |= other.m_Words[i]; }
+    }
+
+  inline void Clear()
+    { std::fill( m_Words.begin(), m_Words.end(), 0 ); }
+
+  /** Copy the changed blocks of source in destination. size is the
+   * number of bins of the two arrays. */
+  template <class TValue>
+  inline void CopyBlocks( const TValue * source, TValue * destination, unsigned long size ) const
+    {
+    for( unsigned long i=0; i<m_Words.size(); i++ )
+      {
+      WordType w = m_Words[i];
+      while( w != 0 )
+        {
+        const unsigned long block = ( i << 6 ) + HistogramOccupancyBitmap::LowestBit( w );
+        w &= w - 1;
+        const unsigned long begin = block << 6;
+        const unsigned long end = std::min( begin + 64, size );
+        std::copy( source + begin, source + end, destination + begin );
+        }
+      }
+    }
+
+  /** Set the changed blocks of array to value. size is the number of
+   * bins of the array. */
+  template <class TValue>
+  inline void FillBlocks( TValue * array, unsigned long size, const TValue & value ) const
+    {
+    for( unsigned long i=0; i<m_Words.size(); i++ )
+      {
+      WordType w = m_Words[i];
+      while( w != 0 )
+        {
+        const unsigned long block = ( i << 6 ) + HistogramOccupancyBitmap::LowestBit( w );
+        w &= w - 1;
+        const unsigned long begin = block << 6;
+        const unsigned long end = std::min( begin + 64, size );
+        std::fill( array + begin, array + end, value );
+        }
+      }
+    }
+
+  /** Copy the changed blocks of the first level of source in
+   * destination, and the upper levels, which are small, entirely. */
+  inline void CopyBitmap( const HistogramOccupancyBitmap & source, HistogramOccupancyBitmap & destination ) const
+    {
+    if( !destination.m_Level1.empty() )
+      { CopyBlocksOfWords( &source.m_Level1[0], &destination.m_Level1[0] ); }
+    destination.m_Level2 = source.m_Level2;
+    destination.m_Summary = source.m_Summary;
+    }
+
+private:
+  inline void CopyBlocksOfWords( const WordType * source, WordType * destination ) const
+    {
+    // the block b is the word b of the first level
+    for( unsigned long i=0; i<m_Words.size(); i++ )
+      {
+      WordType w = m_Words[i];
+      while( w != 0 )
+        {
+        const unsigned long block = ( i << 6 ) + HistogramOccupancyBitmap::LowestBit( w );
+        w &= w - 1;
+        destination[ block ] = source[ block ];
+        }
+      }
+    }
+
+  std::vector< WordType > m_Words;
+  unsigned long m_NumberOfBlocks;
+};
+
+} // end namespace Function
+
+} // end namespace itk
+
+#endif
@@ -0,0 +1,139 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkHistogramCounterArray.h,v $
+  Language:  C++
+  Date:      $Date: 2006/04/14 12:00:00 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkHistogramCounterArray_h
+#define __itkHistogramCounterArray_h
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include "itkHistogramChangedBlocks.h"
+
+namespace itk {
+
+namespace Function {
+
+/** \class HistogramCounterArray
+ * \brief Array of bin counters with a width chosen at compile time
+ *
+ * The counter type is a template parameter, so the updates of the
+ * counters in the inner loop of the histograms don't depend on a width
+ * known only at run time. The histograms use unsigned int counters by
+ * default: they are large enough for any kernel, and a 65536 bins
+ * histogram uses 256 KB instead of 512 KB with unsigned long counters.
+ * A smaller type can be given to the histograms when the kernels are
+ * known to be small: GetCountLimit() gives the largest count the
+ * counters can store.
+ */
+template <class TCounter>
+class HistogramCounterArray
+{
+public:
+  typedef TCounter CounterType;
+
+  HistogramCounterArray() {}
+  ~HistogramCounterArray(){}
+
+  /** Allocate size counters set to 0. */
+  inline void Initialize( unsigned long size )
+    {
+    m_Counts.assign( size, 0 );
+    }
+
+  /** The largest count the counters can store. The width is fixed at
+   * compile time: the filters compare it with the size of the kernel
+   * before running. */
+  static inline unsigned long GetCountLimit()
+    {
+    return static_cast< unsigned long >( std::numeric_limits< TCounter >::max() );
+    }
+
+  inline unsigned long size() const
+    { return m_Counts.size(); }
+
+  inline unsigned long operator[]( unsigned long bin ) const
+    { return m_Counts[ bin ]; }
+
+  /** increment the counter and return its new value */
+  inline unsigned long Increment( unsigned long bin )
+    { return ++m_Counts[ bin ]; }
+
+  /** decrement the counter and return its new value */
+  inline unsigned long Decrement( unsigned long bin )
+    { return --m_Counts[ bin ]; }
+
+  /** add count to the counter and return its new value */
+  inline unsigned long AddToBin( unsigned long bin, unsigned long count )
+    { return m_Counts[ bin ] += static_cast< TCounter >( count ); }
+
+  /** subtract count from the counter and return its new value */
+  inline unsigned long SubtractFromBin( unsigned long bin, unsigned long count )
+    { return m_Counts[ bin ] -= static_cast< TCounter >( count ); }
+
+  /** set the counter to 0 */
+  inline void ClearBin( unsigned long bin )
+    { m_Counts[ bin ] = 0; }
+
+  /** set all the counters to 0 */
+  inline void Clear()
+    {
+    std::fill( m_Counts.begin(), m_Counts.end(), 0 );
+    }
+
+  /** Add the counters of other, which must have the same size. */
+  inline void Add( const HistogramCounterArray & other )
+    {
+    // simple loop on contiguous arrays, easily vectorized by the compiler
+    const unsigned long size = m_Counts.size();
+    for( unsigned long i=0; i<size; i++ )
+      { m_Counts[i] += other.m_Counts[i]; }
+    }
+
+  /** Subtract the counters of other, which must have the same size, and
+   * must not be greater than the counters of this array. */
+  inline void Subtract( const HistogramCounterArray & other )
+    {
+    const unsigned long size = m_Counts.size();
+    for( unsigned long i=0; i<size; i++ )
+      { m_Counts[i] -= other.m_Counts[i]; }
+    }
+
+  /** Copy the blocks of counters marked in changes from source, which
+   * must have the same size. */
+  inline void CopyBlocks( const HistogramCounterArray & source, const HistogramChangedBlocks & changes )
+    {
+    if( m_Counts.empty() )
+      { return; }
+    changes.CopyBlocks( &source.m_Counts[0], &m_Counts[0], m_Counts.size() );
+    }
+
+  /** Set to 0 the blocks of counters marked in changes */
+  inline void ClearBlocks( const HistogramChangedBlocks & changes )
+    {
+    if( m_Counts.empty() )
+      { return; }
+    changes.FillBlocks( &m_Counts[0], m_Counts.size(), static_cast< TCounter >( 0 ) );
+    }
+
+private:
+  std::vector< TCounter > m_Counts;
+};
+
+} // end namespace Function
+
+} // end namespace itk
+
+#endif
@@ -0,0 +1,187 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkHistogramOccupancyBitmap.h,v $
+  Language:  C++
+  Date:      $Date: 2006/04/10 12:00:00 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkHistogramOccupancyBitmap_h
+#define __itkHistogramOccupancyBitmap_h
+
+#include <vector>
+
+namespace itk {
+
+namespace Function {
+
+/** \class HistogramOccupancyBitmap
+ * \brief Hierarchical bitmap of the non empty bins of a histogram
+ *
+ * The bitmap stores one bit per bin, and summarizes each 64 bits word
+ * in a bit of an upper level, up to a single summary word. Marking a
+ * bin as empty or non empty is a constant time operation, and the
+ * lowest or highest non empty bin is found with one bit scan per level,
+ * so histograms with a large number of bins (16 bits pixel types)
+ * don't have to scan the empty bins to find their extremum.
+ *
+ * Up to 64*64*64 = 262144 bins are supported.
+ */
+class HistogramOccupancyBitmap
+{
+public:
+  typedef unsigned long long WordType;
+
+  HistogramOccupancyBitmap()
+    {
+    m_Summary = 0;
+    }
+  ~HistogramOccupancyBitmap(){}
+
+  /** Allocate the bitmap for the given number of bins. All the bins
+   * are marked as empty. */
+  inline void Initialize( unsigned long numberOfBins )
+    {
+    m_Level1.assign( ( numberOfBins + 63 ) / 64, 0 );
+    m_Level2.assign( ( m_Level1.size() + 63 ) / 64, 0 );
+    m_Summary = 0;
+    }
+
+  /** Mark the bin as non empty */
+  inline void Set( unsigned long bin )
+    {
+    const unsigned long w1 = bin >> 6;
+    const unsigned long w2 = w1 >> 6;
+    m_Level1[ w1 ] |= Bit( bin & 63 );
+    m_Level2[ w2 ] |= Bit( w1 & 63 );
+    m_Summary |= Bit( w2 );
+    }
+
+  /** Mark the bin as empty */
+  inline void Clear( unsigned long bin )
+    {
+    const unsigned long w1 = bin >> 6;
+    m_Level1[ w1 ] &= ~Bit( bin & 63 );
+    if( m_Level1[ w1 ] == 0 )
+      {
+      const unsigned long w2 = w1 >> 6;
+      m_Level2[ w2 ] &= ~Bit( w1 & 63 );
+      if( m_Level2[ w2 ] == 0 )
+        { m_Summary &= ~Bit( w2 ); }
+      }
+    }
+
+  inline bool IsSet( unsigned long bin ) const
+    { return ( m_Level1[ bin >> 6 ] & Bit( bin & 63 ) ) != 0; }
+
+  inline bool IsEmpty() const
+    { return m_Summary == 0; }
+
+  /** Return the lowest non empty bin. The bitmap must not be empty. */
+  inline unsigned long First() const
+    {
+    const unsigned long w2 = LowestBit( m_Summary );
+    const unsigned long w1 = ( w2 << 6 ) + LowestBit( m_Level2[ w2 ] );
+    return ( w1 << 6 ) + LowestBit( m_Level1[ w1 ] );
+    }
+
+  /** Return the highest non empty bin. The bitmap must not be empty. */
+  inline unsigned long Last() const
+    {
+    const unsigned long w2 = HighestBit( m_Summary );
+    const unsigned long w1 = ( w2 << 6 ) + HighestBit( m_Level2[ w2 ] );
+    return ( w1 << 6 ) + HighestBit( m_Level1[ w1 ] );
+    }
+
+  /** Move bin to the next non empty bin, and return false if there is
+   * no non empty bin after bin. */
+  inline bool Next( unsigned long & bin ) const
+    {
+    unsigned long w1 = bin >> 6;
+    WordType w = m_Level1[ w1 ] & BitsAbove( bin & 63 );
+    if( w == 0 )
+      {
+      unsigned long w2 = w1 >> 6;
+      w = m_Level2[ w2 ] & BitsAbove( w1 & 63 );
+      if( w == 0 )
+        {
+        w = m_Summary & BitsAbove( w2 );
+        if( w == 0 )
+          { return false; }
+        w2 = LowestBit( w );
+        w = m_Level2[ w2 ];
+        }
+      w1 = ( w2 << 6 ) + LowestBit( w );
+      w = m_Level1[ w1 ];
+      }
+    bin = ( w1 << 6 ) + LowestBit( w );
+    return true;
+    }
+
+  static inline WordType Bit( unsigned long i )
+    { return static_cast<WordType>( 1 ) << i; }
+
+  /** the bits strictly above the bit i */
+  static inline WordType BitsAbove( unsigned long i )
+    {
+    if( i == 63 )
+      { return 0; }
+    return ~static_cast<WordType>( 0 ) << ( i + 1 );
+    }
+
+  /** index of the lowest bit set in w. w must not be 0. */
+  static inline unsigned long LowestBit( WordType w )
+    {
+#if defined(__GNUC__)
+    return __builtin_ctzll( w );
+#else
+    unsigned long n = 0;
+    if( ( w & 0xFFFFFFFFULL ) == 0 ) { n += 32; w >>= 32; }
+    if( ( w & 0xFFFFULL ) == 0 ) { n += 16; w >>= 16; }
+    if( ( w & 0xFFULL ) == 0 ) { n += 8; w >>= 8; }
+    if( ( w & 0xFULL ) == 0 ) { n += 4; w >>= 4; }
+    if( ( w & 0x3ULL ) == 0 ) { n += 2; w >>= 2; }
+    if( ( w & 0x1ULL ) == 0 ) { n += 1; }
+    return n;
+#endif
+    }
+
+  /** index of the highest bit set in w. w must not be 0. */
+  static inline unsigned long HighestBit( WordType w )
+    {
+#if defined(__GNUC__)
+    return 63 - __builtin_clzll( w );
+#else
+    unsigned long n = 0;
+    if( w & 0xFFFFFFFF00000000ULL ) { n += 32; w >>= 32; }
+    if( w & 0xFFFF0000ULL ) { n += 16; w >>= 16; }
+    if( w & 0xFF00ULL ) { n += 8; w >>= 8; }
+    if( w & 0xF0ULL ) { n += 4; w >>= 4; }
+    if( w & 0xCULL ) { n += 2; w >>= 2; }
+    if( w & 0x2ULL ) { n += 1; }
+    return n;
+#endif
+    }
+
+private:
+  // restores the modified words from another bitmap
+  friend class HistogramChangedBlocks;
+
+  std::vector< WordType > m_Level1;
+  std::vector< WordType > m_Level2;
+  WordType m_Summary;
+};
+
+} // end namespace Function
+
+} // end namespace itk
+
+#endif
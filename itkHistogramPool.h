@@ -0,0 +1,101 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkHistogramPool.h,v $
+  Language:  C++
+  Date:      $Date: 2006/04/28 12:00:00 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkHistogramPool_h
+#define __itkHistogramPool_h
+
+#include <vector>
+
+namespace itk {
+
+/** \class HistogramPool
+ * \brief The per thread histograms of the moving histogram filters
+ *
+ * The histograms of the vector based implementations are large, and
+ * zeroing them costs more than a run of the filter on a small image. This
+ * class keeps the histograms of each thread from an update to the next
+ * one, like MorphologyScratchArena does for the line buffers, so they are
+ * only allocated by the first update.
+ *
+ * The filter must call SetNumberOfThreads() before the threads are
+ * started. Each thread then only uses its own slot, without any lock.
+ * Get() returns an empty histogram, reset with its Reset() method, which
+ * only clears the bins used by the previous runs. Release() frees all the
+ * histograms.
+ */
+template <class THistogram>
+class HistogramPool
+{
+public:
+  typedef THistogram HistogramType;
+
+  HistogramPool() {}
+
+  ~HistogramPool()
+    {
+    this->Release();
+    }
+
+  /** Make room for the histograms of nb threads. The existing histograms
+   * are kept. */
+  void SetNumberOfThreads( unsigned int nb )
+    {
+    if( m_Threads.size() < nb )
+      { m_Threads.resize( nb ); }
+    }
+
+  /** Return an empty histogram for the thread: an histogram of a previous
+   * run when there is one, or a new one. */
+  HistogramType * Get( int threadId )
+    {
+    HistogramSlot & slot = m_Threads[ threadId ];
+    if( slot.empty() )
+      { return new HistogramType(); }
+    HistogramType * histogram = slot.back();
+    slot.pop_back();
+    histogram->Reset();
+    return histogram;
+    }
+
+  /** Give back an histogram obtained with Get() by the same thread. */
+  void GiveBack( int threadId, HistogramType * histogram )
+    {
+    m_Threads[ threadId ].push_back( histogram );
+    }
+
+  /** Free all the histograms */
+  void Release()
+    {
+    for( unsigned long i=0; i<m_Threads.size(); i++ )
+      {
+      for( unsigned long j=0; j<m_Threads[i].size(); j++ )
+        { delete m_Threads[i][j]; }
+      }
+    std::vector< HistogramSlot >().swap( m_Threads );
+    }
+
+private:
+  HistogramPool(const HistogramPool&); //purposely not implemented
+  void operator=(const HistogramPool&); //purposely not implemented
+
+  typedef std::vector< HistogramType * > HistogramSlot;
+
+  std::vector< HistogramSlot > m_Threads;
+};
+
+} // end namespace itk
+
+#endif
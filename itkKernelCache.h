@@ -0,0 +1,177 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkKernelCache.h,v $
+  Language:  C++
+  Date:      $Date: 2006/04/28 12:00:00 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkKernelCache_h
+#define __itkKernelCache_h
+
+#include <map>
+#include <list>
+#include <utility>
+#include "itkLightObject.h"
+#include "itkObjectFactory.h"
+#include "itkSimpleFastMutexLock.h"
+
+namespace itk {
+
+/** \class KernelCacheEntry
+ * \brief An immutable value stored in a KernelCache
+ *
+ * The value is filled with GetValue() before being inserted in the cache.
+ * The cache only returns const entries, so the filters can share them
+ * without copying, and keep them after they have been evicted.
+ */
+template <class TValue>
+class KernelCacheEntry : public LightObject
+{
+public:
+  typedef KernelCacheEntry Self;
+  typedef LightObject Superclass;
+  typedef SmartPointer<Self> Pointer;
+  typedef SmartPointer<const Self> ConstPointer;
+  typedef TValue ValueType;
+
+  itkNewMacro(Self);
+  itkTypeMacro(KernelCacheEntry, LightObject);
+
+  ValueType & GetValue()
+    { return m_Value; }
+
+  const ValueType & GetValue() const
+    { return m_Value; }
+
+protected:
+  KernelCacheEntry() {}
+  ~KernelCacheEntry() {}
+
+private:
+  KernelCacheEntry(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  ValueType m_Value;
+};
+
+/** \class KernelCache
+ * \brief A process wide cache of the data computed from the kernels
+ *
+ * The filters which preprocess their kernel, like the moving histogram
+ * filters, store the result of the preprocessing in this cache, so the
+ * other instances of the same filter type can reuse it when they get the
+ * same kernel. This is useful with the meta filters, which hold several
+ * internal filters with the same kernel, and when many filters are
+ * created with a few distinct kernels.
+ *
+ * There is one cache for each couple of key and value types. The cache
+ * can be used from several threads. The values are stored in shared
+ * KernelCacheEntry objects: a lookup only copies a smart pointer under the
+ * lock. The cache keeps at most MaximumSize entries, and evicts the least
+ * recently used one when it is full.
+ *
+ * TKey must provide operator<. The comparison should start with a hash of
+ * the kernel to be cheap.
+ */
+template <class TKey, class TValue>
+class KernelCache
+{
+public:
+  typedef TKey KeyType;
+  typedef TValue ValueType;
+  typedef KernelCacheEntry< ValueType > EntryType;
+  typedef typename EntryType::Pointer EntryPointer;
+  typedef typename EntryType::ConstPointer EntryConstPointer;
+
+  /** The maximum number of entries in the cache */
+  static const unsigned long MaximumSize = 64;
+
+  /** Get the entry stored for the key in entry. Return false if there is
+   * no entry for this key. */
+  static bool Find( const KeyType & key, EntryConstPointer & entry )
+    {
+    GetLock().Lock();
+    typename MapType::iterator it = GetMap().find( key );
+    const bool found = ( it != GetMap().end() );
+    if( found )
+      {
+      entry = it->second.first;
+      // the entry is now the most recently used one
+      GetOrder().splice( GetOrder().begin(), GetOrder(), it->second.second );
+      }
+    GetLock().Unlock();
+    return found;
+    }
+
+  /** Store the entry for the key. The entry must not be modified after
+   * this call. */
+  static void Insert( const KeyType & key, const EntryType * entry )
+    {
+    GetLock().Lock();
+    MapType & map = GetMap();
+    OrderType & order = GetOrder();
+    typename MapType::iterator it = map.find( key );
+    if( it != map.end() )
+      {
+      it->second.first = entry;
+      order.splice( order.begin(), order, it->second.second );
+      }
+    else
+      {
+      if( map.size() >= MaximumSize )
+        {
+        map.erase( order.back() );
+        order.pop_back();
+        }
+      order.push_front( key );
+      map[ key ] = std::make_pair( EntryConstPointer( entry ), order.begin() );
+      }
+    GetLock().Unlock();
+    }
+
+  /** Remove all the entries of the cache. */
+  static void Clear()
+    {
+    GetLock().Lock();
+    GetMap().clear();
+    GetOrder().clear();
+    GetLock().Unlock();
+    }
+
+private:
+  // the keys, from the most recently used to the least recently used one
+  typedef std::list< KeyType > OrderType;
+  typedef std::map< KeyType, std::pair< EntryConstPointer, typename OrderType::iterator > > MapType;
+
+  // the storage is created on first use
+  static MapType & GetMap()
+    {
+    static MapType map;
+    return map;
+    }
+
+  static OrderType & GetOrder()
+    {
+    static OrderType order;
+    return order;
+    }
+
+  static SimpleFastMutexLock & GetLock()
+    {
+    static SimpleFastMutexLock lock;
+    return lock;
+    }
+};
+
+} // end namespace itk
+
+#endif
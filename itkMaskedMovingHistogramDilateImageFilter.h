@@ -0,0 +1,92 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkMaskedMovingHistogramDilateImageFilter.h,v $
+  Language:  C++
+  Date:      $Date: 2006/04/26 12:00:00 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even 
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR 
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkMaskedMovingHistogramDilateImageFilter_h
+#define __itkMaskedMovingHistogramDilateImageFilter_h
+
+#include "itkMaskedMovingHistogramMorphologyImageFilter.h"
+
+namespace itk {
+
+/**
+ * \class MaskedMovingHistogramDilateImageFilter
+ * \brief gray scale dilation of the pixels of an image in a mask
+ *
+ * Dilate an image using grayscale morphology. Dilation takes the
+ * maximum of all the pixels identified by the structuring element.
+ *
+ * The pixels outside the mask are ignored, and the output pixels outside
+ * the mask are set to the fill value: see MaskedMovingHistogramImageFilter.
+ * 
+ * \sa MovingHistogramDilateImageFilter, MaskedMovingHistogramImageFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+
+
+template<class TInputImage, class TMaskImage, class TOutputImage, class TKernel>
+class ITK_EXPORT MaskedMovingHistogramDilateImageFilter : 
+    public MaskedMovingHistogramMorphologyImageFilter<TInputImage, TMaskImage, TOutputImage, TKernel,
+      typename Function::MorphologyHistogram < typename TInputImage::PixelType, typename std::greater<typename TInputImage::PixelType> > >
+{
+public:
+  /** Standard class typedefs. */
+  typedef MaskedMovingHistogramDilateImageFilter Self;
+  typedef MaskedMovingHistogramMorphologyImageFilter<TInputImage, TMaskImage, TOutputImage, TKernel,
+      typename Function::MorphologyHistogram < typename TInputImage::PixelType, typename std::greater<typename TInputImage::PixelType> > >  Superclass;
+  typedef SmartPointer<Self>        Pointer;
+  typedef SmartPointer<const Self>  ConstPointer;
+  
+  /** Standard New method. */
+  itkNewMacro(Self);  
+
+  /** Runtime information support. */
+  itkTypeMacro(MaskedMovingHistogramDilateImageFilter, 
+               MaskedMovingHistogramMorphologyImageFilter);
+  
+  /** Image related typedefs. */
+  typedef TInputImage InputImageType;
+  typedef TOutputImage OutputImageType;
+  typedef typename TInputImage::RegionType RegionType ;
+  typedef typename TInputImage::SizeType SizeType ;
+  typedef typename TInputImage::IndexType IndexType ;
+  typedef typename TInputImage::PixelType PixelType ;
+  typedef typename TInputImage::OffsetType OffsetType ;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+  typedef typename TOutputImage::PixelType OutputPixelType ;
+  
+  /** Image related typedefs. */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TInputImage::ImageDimension);
+                      
+
+protected:
+  MaskedMovingHistogramDilateImageFilter()
+  {
+    this->m_Boundary = itk::NumericTraits< PixelType >::NonpositiveMin();
+  }
+  ~MaskedMovingHistogramDilateImageFilter() {};
+
+private:
+  MaskedMovingHistogramDilateImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+} ; // end of class
+
+} // end namespace itk
+  
+#endif
+
+
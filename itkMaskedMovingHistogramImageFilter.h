@@ -0,0 +1,193 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkMaskedMovingHistogramImageFilter.h,v $
+  Language:  C++
+  Date:      $Date: 2006/04/26 12:00:00 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkMaskedMovingHistogramImageFilter_h
+#define __itkMaskedMovingHistogramImageFilter_h
+
+#include "itkMovingHistogramImageFilterBase.h"
+#include "itkHistogramPool.h"
+
+namespace itk {
+
+/**
+ * \class MaskedMovingHistogramImageFilter
+ * \brief Implements a generic moving histogram algorithm restricted to a mask
+ *
+ * This filter is similar to MovingHistogramImageFilter, but takes a mask
+ * image as second input. The input pixels outside the mask are not added
+ * to the histogram, and the output pixels outside the mask are not
+ * computed: they are set to the fill value. The pixels are in the mask
+ * when their value in the mask image is equal to the mask value.
+ *
+ * The histogram is moved along the lines only over the pixels in the
+ * mask. When a line enters the mask again after a run of pixels outside
+ * the mask, the histogram is either moved over the run, or emptied and
+ * filled with the pixels of the kernel, depending on which is the
+ * cheapest. The cost of the filter is this way roughly proportional to
+ * the number of pixels in the mask rather than to the size of the image.
+ *
+ * The histogram class must implement the concept described in
+ * MovingHistogramImageFilterBase. Reset() is used to empty the histogram;
+ * RestoreFrom() and MergeChanges() are not used. The histogram may be
+ * empty when GetValue() is called, if the center of the kernel is not in
+ * the kernel. The histograms are kept between the updates in a
+ * HistogramPool, and freed by ReleaseScratchMemory().
+ *
+ * The mask image must have the same size as the input image.
+ *
+ * \sa MovingHistogramImageFilter, MaskedMovingHistogramMorphologyImageFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+
+template<class TInputImage, class TMaskImage, class TOutputImage, class TKernel, class THistogram >
+class ITK_EXPORT MaskedMovingHistogramImageFilter :
+    public MovingHistogramImageFilterBase<TInputImage, TOutputImage, TKernel>
+{
+public:
+  /** Standard class typedefs. */
+  typedef MaskedMovingHistogramImageFilter Self;
+  typedef MovingHistogramImageFilterBase<TInputImage, TOutputImage, TKernel>  Superclass;
+  typedef SmartPointer<Self>        Pointer;
+  typedef SmartPointer<const Self>  ConstPointer;
+
+  /** Standard New method. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(MaskedMovingHistogramImageFilter,
+               MovingHistogramImageFilterBase);
+
+  /** Image related typedefs. */
+  typedef TInputImage InputImageType;
+  typedef TOutputImage OutputImageType;
+  typedef TMaskImage MaskImageType;
+  typedef typename TInputImage::RegionType RegionType ;
+  typedef typename TInputImage::SizeType SizeType ;
+  typedef typename TInputImage::IndexType IndexType ;
+  typedef typename TInputImage::PixelType PixelType ;
+  typedef typename TInputImage::OffsetType OffsetType ;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+  typedef typename TOutputImage::PixelType OutputPixelType ;
+  typedef typename TMaskImage::PixelType MaskPixelType ;
+
+  /** Image related typedefs. */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TInputImage::ImageDimension);
+
+  /** Kernel typedef. */
+  typedef TKernel KernelType;
+
+  typedef typename Superclass::OffsetListType OffsetListType;
+  typedef typename Superclass::LinearOffsetListType LinearOffsetListType;
+  typedef typename Superclass::LinearOffsetTableType LinearOffsetTableType;
+  typedef typename Superclass::OffsetValueType OffsetValueType;
+
+  typedef THistogram HistogramType;
+
+  /** Set/Get the mask image */
+  void SetMaskImage( const MaskImageType * mask )
+    { this->SetNthInput( 1, const_cast< MaskImageType * >( mask ) ); }
+  const MaskImageType * GetMaskImage() const
+    { return static_cast< const MaskImageType * >( this->ProcessObject::GetInput( 1 ) ); }
+
+  /** Set/Get the value of the pixels in the mask. Defaults to the maximum
+   * value of the mask pixel type. */
+  itkSetMacro(MaskValue, MaskPixelType);
+  itkGetMacro(MaskValue, MaskPixelType);
+
+  /** Set/Get the value of the output pixels outside the mask. Defaults
+   * to zero. */
+  itkSetMacro(FillValue, OutputPixelType);
+  itkGetMacro(FillValue, OutputPixelType);
+
+  /** Free the histograms kept between the updates. They are allocated
+   * again by the next update. */
+  void ReleaseScratchMemory()
+    {
+    m_HistogramPool.Release();
+    }
+
+protected:
+  MaskedMovingHistogramImageFilter();
+  ~MaskedMovingHistogramImageFilter() {};
+  void PrintSelf(std::ostream& os, Indent indent) const;
+
+  /** The mask is needed on the same region as the input */
+  void GenerateInputRequestedRegion();
+
+  /** Compute the linear offsets in the mask buffer */
+  void BeforeThreadedGenerateData();
+
+  /** Multi-thread version GenerateData. */
+  void  ThreadedGenerateData (const OutputImageRegionType&
+                              outputRegionForThread,
+                              int threadId) ;
+
+  /** NewHistogram must return an empty histogram object for the thread.
+   * It's also the good place to pass parameters to the histogram.
+   * A default version is provided which reset an histogram of the pool of
+   * the thread, or create a new Historgram, and return it.
+   */
+  virtual THistogram * NewHistogram( int threadId );
+
+  MaskPixelType m_MaskValue;
+  OutputPixelType m_FillValue;
+
+private:
+  MaskedMovingHistogramImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  /** add the pixel at the given position to the histogram if it is in the
+   * mask, or a boundary pixel if it is outside the input image */
+  inline void AddPixel( HistogramType * histogram, const RegionType & inputRegion,
+                        const InputImageType * inputImage, const MaskImageType * maskImage,
+                        const IndexType & idx ) const
+    {
+    if( !inputRegion.IsInside( idx ) )
+      { histogram->AddBoundary(); }
+    else if( maskImage->GetPixel( idx ) == m_MaskValue )
+      { histogram->AddPixel( inputImage->GetPixel( idx ) ); }
+    }
+
+  inline void RemovePixel( HistogramType * histogram, const RegionType & inputRegion,
+                           const InputImageType * inputImage, const MaskImageType * maskImage,
+                           const IndexType & idx ) const
+    {
+    if( !inputRegion.IsInside( idx ) )
+      { histogram->RemoveBoundary(); }
+    else if( maskImage->GetPixel( idx ) == m_MaskValue )
+      { histogram->RemovePixel( inputImage->GetPixel( idx ) ); }
+    }
+
+  // the offsets of the kernel and of the translations, in the input and
+  // mask buffers
+  LinearOffsetListType m_KernelLinearOffsets;
+  LinearOffsetListType m_KernelMaskLinearOffsets;
+  LinearOffsetTableType m_AddedMaskLinearOffsets;
+  LinearOffsetTableType m_RemovedMaskLinearOffsets;
+
+  // the histograms not used by the threads, kept between the runs
+  HistogramPool< THistogram > m_HistogramPool;
+
+} ; // end of class
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkMaskedMovingHistogramImageFilter.txx"
+#endif
+
+#endif
@@ -0,0 +1,260 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkMaskedMovingHistogramImageFilter.txx,v $
+  Language:  C++
+  Date:      $Date: 2006/04/26 12:00:00 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkMaskedMovingHistogramImageFilter_txx
+#define __itkMaskedMovingHistogramImageFilter_txx
+
+#include "itkMaskedMovingHistogramImageFilter.h"
+#include "itkImageLinearConstIteratorWithIndex.h"
+#include "itkProgressReporter.h"
+#include "itkNumericTraits.h"
+#include <algorithm>
+
+namespace itk {
+
+
+template<class TInputImage, class TMaskImage, class TOutputImage, class TKernel, class THistogram>
+MaskedMovingHistogramImageFilter<TInputImage, TMaskImage, TOutputImage, TKernel, THistogram>
+::MaskedMovingHistogramImageFilter()
+{
+  this->SetNumberOfRequiredInputs( 2 );
+  m_MaskValue = NumericTraits< MaskPixelType >::max();
+  m_FillValue = NumericTraits< OutputPixelType >::Zero;
+}
+
+
+template<class TInputImage, class TMaskImage, class TOutputImage, class TKernel, class THistogram>
+THistogram *
+MaskedMovingHistogramImageFilter<TInputImage, TMaskImage, TOutputImage, TKernel, THistogram>
+::NewHistogram( int threadId )
+{
+  // reuse an histogram of a previous run when there is one
+  return m_HistogramPool.Get( threadId );
+}
+
+
+template<class TInputImage, class TMaskImage, class TOutputImage, class TKernel, class THistogram>
+void
+MaskedMovingHistogramImageFilter<TInputImage, TMaskImage, TOutputImage, TKernel, THistogram>
+::GenerateInputRequestedRegion()
+{
+  // pad the input requested region by the kernel radius
+  Superclass::GenerateInputRequestedRegion();
+
+  MaskImageType * maskImage = const_cast< MaskImageType * >( this->GetMaskImage() );
+  if( maskImage && this->GetInput() )
+    { maskImage->SetRequestedRegion( this->GetInput()->GetRequestedRegion() ); }
+}
+
+
+template<class TInputImage, class TMaskImage, class TOutputImage, class TKernel, class THistogram>
+void
+MaskedMovingHistogramImageFilter<TInputImage, TMaskImage, TOutputImage, TKernel, THistogram>
+::BeforeThreadedGenerateData()
+{
+  Superclass::BeforeThreadedGenerateData();
+
+  if( this->m_MaximumHistogramCount > THistogram::GetCountLimit() )
+    {
+    itkExceptionMacro( << "The kernel is too large for the counters of the histogram: "
+                       << this->m_MaximumHistogramCount << " pixels, at most "
+                       << THistogram::GetCountLimit() << " are supported." );
+    }
+
+  const InputImageType * inputImage = this->GetInput();
+  const MaskImageType * maskImage = this->GetMaskImage();
+  if( !maskImage->GetBufferedRegion().IsInside( inputImage->GetRequestedRegion() ) )
+    { itkExceptionMacro( << "The mask image must cover the input image." ); }
+
+  const OffsetValueType * offsetTable = inputImage->GetOffsetTable();
+  const OffsetValueType * maskOffsetTable = maskImage->GetOffsetTable();
+  this->ComputeLinearOffsets( this->GetKernelOffsets(), offsetTable, m_KernelLinearOffsets );
+  this->ComputeLinearOffsets( this->GetKernelOffsets(), maskOffsetTable, m_KernelMaskLinearOffsets );
+  this->ComputeLinearOffsets( this->GetAddedOffsets(), maskOffsetTable, m_AddedMaskLinearOffsets );
+  this->ComputeLinearOffsets( this->GetRemovedOffsets(), maskOffsetTable, m_RemovedMaskLinearOffsets );
+
+  // each thread takes its histogram from its own slot of the pool
+  m_HistogramPool.SetNumberOfThreads( this->GetNumberOfThreads() );
+}
+
+
+template<class TInputImage, class TMaskImage, class TOutputImage, class TKernel, class THistogram>
+void
+MaskedMovingHistogramImageFilter<TInputImage, TMaskImage, TOutputImage, TKernel, THistogram>
+::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                       int threadId)
+{
+  OutputImageType * outputImage = this->GetOutput();
+  const InputImageType * inputImage = this->GetInput();
+  const MaskImageType * maskImage = this->GetMaskImage();
+  const RegionType inputRegion = inputImage->GetRequestedRegion();
+
+  // the lines are along the best axis, as in MovingHistogramImageFilter
+  const unsigned int direction = this->m_Axes[ImageDimension - 1];
+  const long lineLength = outputRegionForThread.GetSize()[direction];
+
+  ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels() / lineLength);
+
+  // the histogram is emptied with Reset(), which only clears its non
+  // empty bins
+  HistogramType * histogram = this->NewHistogram( threadId );
+
+  const unsigned int directionIndex = this->GetDirectionIndex( direction, 1 );
+  const OffsetListType & addedList = this->GetAddedOffsets()[directionIndex];
+  const OffsetListType & removedList = this->GetRemovedOffsets()[directionIndex];
+  const LinearOffsetListType & addedLinearList = this->m_AddedLinearOffsets[directionIndex];
+  const LinearOffsetListType & removedLinearList = this->m_RemovedLinearOffsets[directionIndex];
+  const LinearOffsetListType & addedMaskLinearList = m_AddedMaskLinearOffsets[directionIndex];
+  const LinearOffsetListType & removedMaskLinearList = m_RemovedMaskLinearOffsets[directionIndex];
+
+  // moving the histogram over a run of pixels outside the mask costs
+  // about the number of pixels of a translation along the lines per pixel
+  // of the run; filling it again costs the number of pixels in the kernel
+  const unsigned long fillCost = this->GetKernelOffsets().size();
+  const unsigned long moveCost = std::max( this->m_TranslationCounts[direction], 1UL );
+
+  // The interior is the set of positions where the kernel, padded by
+  // one pixel for the translation, is fully inside the input image. The
+  // histogram can be filled and moved from those positions without any
+  // bounds checking.
+  const SizeType kernelSize = this->GetKernel().GetSize();
+  IndexType interiorFirst, interiorLast;
+  for( unsigned int i=0; i<ImageDimension; i++ )
+    {
+    const long centerOffset = kernelSize[i] / 2 + 1;
+    interiorFirst[i] = inputRegion.GetIndex()[i] + centerOffset;
+    interiorLast[i] = inputRegion.GetIndex()[i] + static_cast<long>( inputRegion.GetSize()[i] )
+      - static_cast<long>( kernelSize[i] + 2 ) + centerOffset;
+    }
+
+  const OffsetValueType inputStride = inputImage->GetOffsetTable()[direction];
+  const OffsetValueType maskStride = maskImage->GetOffsetTable()[direction];
+  const OffsetValueType outputStride = outputImage->GetOffsetTable()[direction];
+
+  typedef ImageLinearConstIteratorWithIndex< OutputImageType > LineIteratorType;
+  LineIteratorType lineIt( outputImage, outputRegionForThread );
+  lineIt.SetDirection( direction );
+  for( lineIt.GoToBegin(); !lineIt.IsAtEnd(); lineIt.NextLine() )
+    {
+    const IndexType lineStart = lineIt.GetIndex();
+
+    // find the part of the line in the interior
+    long interiorBegin = 0;
+    long interiorEnd = 0;
+    bool lineInInterior = true;
+    for( unsigned int i=0; i<ImageDimension; i++ )
+      {
+      if( i != direction && ( lineStart[i] < interiorFirst[i] || lineStart[i] > interiorLast[i] ) )
+        { lineInInterior = false; }
+      }
+    if( lineInInterior )
+      {
+      interiorBegin = std::max( interiorFirst[direction] - lineStart[direction], 0L );
+      interiorEnd = std::min( interiorLast[direction] + 1 - lineStart[direction], lineLength );
+      }
+
+    const PixelType * inputPointer = inputImage->GetBufferPointer() + inputImage->ComputeOffset( lineStart );
+    const MaskPixelType * maskPointer = maskImage->GetBufferPointer() + maskImage->ComputeOffset( lineStart );
+    OutputPixelType * outputPointer = outputImage->GetBufferPointer() + outputImage->ComputeOffset( lineStart );
+
+    // the position of the histogram on the line, or -1 if it must be
+    // filled
+    long histogramPos = -1;
+    for( long pos=0; pos<lineLength; pos++ )
+      {
+      if( maskPointer[ pos * maskStride ] != m_MaskValue )
+        {
+        outputPointer[ pos * outputStride ] = m_FillValue;
+        continue;
+        }
+
+      if( histogramPos < 0 || static_cast<unsigned long>( pos - histogramPos ) * moveCost > fillCost )
+        {
+        // fill the histogram with the pixels of the kernel
+        histogram->Reset();
+        if( pos >= interiorBegin && pos < interiorEnd )
+          {
+          const PixelType * center = inputPointer + pos * inputStride;
+          const MaskPixelType * maskCenter = maskPointer + pos * maskStride;
+          for( unsigned long i=0; i<m_KernelLinearOffsets.size(); i++ )
+            {
+            if( maskCenter[ m_KernelMaskLinearOffsets[i] ] == m_MaskValue )
+              { histogram->AddPixel( center[ m_KernelLinearOffsets[i] ] ); }
+            }
+          }
+        else
+          {
+          IndexType idx = lineStart;
+          idx[direction] += pos;
+          for( typename OffsetListType::const_iterator listIt = this->GetKernelOffsets().begin(); listIt != this->GetKernelOffsets().end(); listIt++ )
+            { this->AddPixel( histogram, inputRegion, inputImage, maskImage, idx + *listIt ); }
+          }
+        }
+      else
+        {
+        // move the histogram from its position to the current pixel
+        for( long p=histogramPos; p<pos; p++ )
+          {
+          if( p >= interiorBegin && p < interiorEnd )
+            {
+            const PixelType * center = inputPointer + p * inputStride;
+            const MaskPixelType * maskCenter = maskPointer + p * maskStride;
+            for( unsigned long i=0; i<addedLinearList.size(); i++ )
+              {
+              if( maskCenter[ addedMaskLinearList[i] ] == m_MaskValue )
+                { histogram->AddPixel( center[ addedLinearList[i] ] ); }
+              }
+            for( unsigned long i=0; i<removedLinearList.size(); i++ )
+              {
+              if( maskCenter[ removedMaskLinearList[i] ] == m_MaskValue )
+                { histogram->RemovePixel( center[ removedLinearList[i] ] ); }
+              }
+            }
+          else
+            {
+            IndexType idx = lineStart;
+            idx[direction] += p;
+            for( typename OffsetListType::const_iterator addedIt = addedList.begin(); addedIt != addedList.end(); addedIt++ )
+              { this->AddPixel( histogram, inputRegion, inputImage, maskImage, idx + *addedIt ); }
+            for( typename OffsetListType::const_iterator removedIt = removedList.begin(); removedIt != removedList.end(); removedIt++ )
+              { this->RemovePixel( histogram, inputRegion, inputImage, maskImage, idx + *removedIt ); }
+            }
+          }
+        }
+      histogramPos = pos;
+
+      outputPointer[ pos * outputStride ] = static_cast< OutputPixelType >( histogram->GetValue( inputPointer[ pos * inputStride ] ) );
+      }
+    progress.CompletedPixel();
+    }
+
+  m_HistogramPool.GiveBack( threadId, histogram );
+}
+
+
+template<class TInputImage, class TMaskImage, class TOutputImage, class TKernel, class THistogram>
+void
+MaskedMovingHistogramImageFilter<TInputImage, TMaskImage, TOutputImage, TKernel, THistogram>
+::PrintSelf(std::ostream &os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "MaskValue: " << m_MaskValue << std::endl;
+  os << indent << "FillValue: " << m_FillValue << std::endl;
+}
+
+}// end namespace itk
+#endif
@@ -0,0 +1,114 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkMaskedMovingHistogramMorphologyImageFilter.h,v $
+  Language:  C++
+  Date:      $Date: 2006/04/26 12:00:00 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even 
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR 
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkMaskedMovingHistogramMorphologyImageFilter_h
+#define __itkMaskedMovingHistogramMorphologyImageFilter_h
+
+#include "itkMaskedMovingHistogramImageFilter.h"
+#include "itkMovingHistogramMorphologyImageFilter.h"
+
+namespace itk {
+
+/**
+ * \class MaskedMovingHistogramMorphologyImageFilter
+ * \brief base class for MaskedMovingHistogramDilateImageFilter and MaskedMovingHistogramErodeImageFilter
+ *
+ * This class adds the support for the boundaries to MaskedMovingHistogramImageFilter,
+ * and uses the same histograms as MovingHistogramMorphologyImageFilter.
+ * The pixels outside the mask are ignored: they are not replaced by the
+ * boundary value.
+ * 
+ * \sa MaskedMovingHistogramImageFilter, MovingHistogramMorphologyImageFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+
+template<class TInputImage, class TMaskImage, class TOutputImage, class TKernel, class THistogram>
+class ITK_EXPORT MaskedMovingHistogramMorphologyImageFilter : 
+    public MaskedMovingHistogramImageFilter<TInputImage, TMaskImage, TOutputImage, TKernel, THistogram>
+{
+public:
+  /** Standard class typedefs. */
+  typedef MaskedMovingHistogramMorphologyImageFilter Self;
+  typedef MaskedMovingHistogramImageFilter<TInputImage, TMaskImage, TOutputImage, TKernel, THistogram> Superclass;
+  typedef SmartPointer<Self>        Pointer;
+  typedef SmartPointer<const Self>  ConstPointer;
+  
+  /** Standard New method. */
+  itkNewMacro(Self);  
+
+  /** Runtime information support. */
+  itkTypeMacro(MaskedMovingHistogramMorphologyImageFilter, 
+               MaskedMovingHistogramImageFilter);
+  
+  /** Image related typedefs. */
+  typedef TInputImage InputImageType;
+  typedef TOutputImage OutputImageType;
+  typedef typename TInputImage::RegionType RegionType ;
+  typedef typename TInputImage::SizeType SizeType ;
+  typedef typename TInputImage::IndexType IndexType ;
+  typedef typename TInputImage::PixelType PixelType ;
+  typedef typename TInputImage::OffsetType OffsetType ;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+  typedef typename TOutputImage::PixelType OutputPixelType ;
+  typedef TMaskImage MaskImageType;
+  
+  /** Image related typedefs. */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TInputImage::ImageDimension);
+                      
+  /** Kernel typedef. */
+  typedef TKernel KernelType;
+
+  /** Set/Get the boundary value. */
+  itkSetMacro(Boundary, PixelType);
+  itkGetMacro(Boundary, PixelType);
+
+protected:
+  MaskedMovingHistogramMorphologyImageFilter()
+    {
+    // default m_boundary should be set by subclasses. Just provide a default
+    // value to always get the same behavior if it is not done
+    m_Boundary = itk::NumericTraits< PixelType >::Zero;
+    }
+  ~MaskedMovingHistogramMorphologyImageFilter() {};
+
+  void PrintSelf(std::ostream& os, Indent indent) const
+    {
+    Superclass::PrintSelf(os, indent);
+    os << indent << "Boundary: " << m_Boundary << std::endl;
+    }
+
+  /** needed to pass the boundary value and the maximum count of the bins
+   * to the histogram object */
+  virtual THistogram * NewHistogram( int threadId )
+    {
+    THistogram * histogram = Superclass::NewHistogram( threadId );
+    histogram->SetBoundary( m_Boundary );
+    histogram->SetMaximumCount( this->m_MaximumHistogramCount );
+    return histogram;
+    }
+
+  PixelType m_Boundary;
+
+private:
+  MaskedMovingHistogramMorphologyImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+} ; // end of class
+
+} // end namespace itk
+  
+#endif
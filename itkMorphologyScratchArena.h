@@ -0,0 +1,119 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkMorphologyScratchArena.h,v $
+  Language:  C++
+  Date:      $Date: 2006/04/28 12:00:00 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkMorphologyScratchArena_h
+#define __itkMorphologyScratchArena_h
+
+#include "itkImportImageContainer.h"
+#include <vector>
+
+namespace itk {
+
+/** \class MorphologyScratchArena
+ * \brief The per thread working memory of the line based morphology filters
+ *
+ * AnchorErodeDilateImageFilter and vHGWErodeDilateImageFilter process
+ * the lines of the region of a thread in an internal image, with a few
+ * line buffers. This class keeps those buffers from an update to the
+ * next one, so a filter run on each frame of a sequence doesn't allocate
+ * them again: the image keeps its memory when the region doesn't grow,
+ * and the line buffers only grow. Each thread also gets an object of
+ * type TThreadObject, for the classes which process the lines, so their
+ * own storage is kept too.
+ *
+ * The filter must call SetNumberOfThreads() before the threads are
+ * started. Each thread then only uses its own buffers. Release() frees
+ * all the memory.
+ */
+struct MorphologyScratchNoObject {};
+
+template <class TImage, unsigned int VNumberOfLines,
+          class TThreadObject = MorphologyScratchNoObject>
+class MorphologyScratchArena
+{
+public:
+  typedef TImage ImageType;
+  typedef typename TImage::Pointer ImagePointer;
+  typedef typename TImage::PixelType PixelType;
+  typedef typename TImage::RegionType RegionType;
+  typedef TThreadObject ThreadObjectType;
+
+  /** Make room for the buffers of nb threads. The existing buffers are
+   * kept. */
+  void SetNumberOfThreads( unsigned int nb )
+    {
+    if( m_Threads.size() < nb )
+      { m_Threads.resize( nb ); }
+    }
+
+  /** Return the internal image of the thread, allocated on region. Its
+   * content is undefined. */
+  ImageType * GetImage( int threadId, const RegionType & region )
+    {
+    ImagePointer & image = m_Threads[ threadId ].m_Image;
+    if( image.IsNull() )
+      { image = ImageType::New(); }
+    // the pixel container only reallocates its memory when it grows
+    image->SetRegions( region );
+    image->Allocate();
+    return image;
+    }
+
+  /** Return the line buffer number line of the thread, with at least
+   * length pixels. Its content is undefined. */
+  PixelType * GetLine( int threadId, unsigned int line, unsigned long length )
+    {
+    LinePointer & buffer = m_Threads[ threadId ].m_Lines[ line ];
+    if( buffer.IsNull() )
+      { buffer = LineType::New(); }
+    // like the pixel container of the image, the line only reallocates
+    // its memory when it grows
+    buffer->Reserve( length );
+    return buffer->GetBufferPointer();
+    }
+
+  /** Return the object of the thread. It is default constructed by
+   * SetNumberOfThreads(), and then kept from an update to the next
+   * one. */
+  ThreadObjectType & GetThreadObject( int threadId )
+    {
+    return m_Threads[ threadId ].m_Object;
+    }
+
+  /** Free all the buffers, and the objects of the threads */
+  void Release()
+    {
+    std::vector< ThreadScratch >().swap( m_Threads );
+    }
+
+private:
+  // not a std::vector, which can't give a pointer to its data for bool
+  typedef ImportImageContainer< unsigned long, PixelType > LineType;
+  typedef typename LineType::Pointer LinePointer;
+
+  struct ThreadScratch
+    {
+    ImagePointer m_Image;
+    LinePointer m_Lines[ VNumberOfLines ];
+    ThreadObjectType m_Object;
+    };
+
+  std::vector< ThreadScratch > m_Threads;
+};
+
+} // end namespace itk
+
+#endif
@@ -31,22 +31,27 @@ namespace itk {
  * The structuring element is assumed to be composed of binary
  * values (zero or one). Only elements of the structuring element
  * having values > 0 are candidates for affecting the center pixel.
+ *
+ * TCounter is the type of the counters of the histogram, for the pixel
+ * types with a fixed size histogram. unsigned short halves the memory of
+ * the counters, but the filter throws an exception if the kernel has more
+ * than 65535 pixels.
  * 
  * \sa MorphologyImageFilter, GrayscaleFunctionMorphologicalGradientImageFilter, BinaryMorphologicalGradientImageFilter
  * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
  */
 
 
-template<class TInputImage, class TOutputImage, class TKernel>
+template<class TInputImage, class TOutputImage, class TKernel, class TCounter = unsigned int>
 class ITK_EXPORT MovingHistogramErodeImageFilter : 
     public MovingHistogramMorphologyImageFilter<TInputImage, TOutputImage, TKernel,
-      typename Function::MorphologyHistogram < typename TInputImage::PixelType, typename std::less<typename TInputImage::PixelType> > >
+      typename Function::MorphologyHistogram < typename TInputImage::PixelType, typename std::less<typename TInputImage::PixelType>, TCounter > >
 {
 public:
   /** Standard class typedefs. */
   typedef MovingHistogramErodeImageFilter Self;
   typedef MovingHistogramMorphologyImageFilter<TInputImage, TOutputImage, TKernel,
-      typename Function::MorphologyHistogram < typename TInputImage::PixelType, typename std::less<typename TInputImage::PixelType> > >  Superclass;
+      typename Function::MorphologyHistogram < typename TInputImage::PixelType, typename std::less<typename TInputImage::PixelType>, TCounter > >  Superclass;
   typedef SmartPointer<Self>        Pointer;
   typedef SmartPointer<const Self>  ConstPointer;
   
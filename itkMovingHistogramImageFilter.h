@@ -18,6 +18,11 @@
 #define __itkMovingHistogramImageFilter_h
 
 #include "itkMovingHistogramImageFilterBase.h"
+#include "itkHistogramPool.h"
+#include "itkNumericTraits.h"
+#include "itkSimpleFastMutexLock.h"
+#include "itkProgressReporter.h"
+#include <vector>
 
 //#define zigzag
 
@@ -44,11 +49,22 @@ namespace itk {
  * the structuring element (or kernel) type, and the histogram type.
  * The input and output image must have the same number of dimension.
  *
- * The histogram type is a class which has to implements seven methods:
+ * The histogram type is a class which has to implements nine methods:
  * + a default constructor which takes no parameter.
- * + HistogramType * Clone() must produce a new identical histogram. It is
- * used internally to optimize the filter, by avoiding reverse iteration
- * over the image.
+ * + HistogramType * Clone() must produce a new identical histogram.
+ * + void RestoreFrom( const HistogramType & reference ) must make the
+ * histogram identical to reference. It is used when the filter moves to
+ * a new line, and it is only called when the histogram was identical to
+ * reference after the previous call of RestoreFrom() or Reset(), except
+ * for its own changes and the ones added with MergeChanges(). It is also
+ * used to copy an histogram, by restoring an empty histogram from it, to
+ * avoid reverse iteration over the image. The histograms with
+ * a large number of bins should only revert those changes rather than
+ * copy the whole reference.
+ * + void MergeChanges( const HistogramType & other ) must add the changes
+ * of other since its last call of RestoreFrom() to the changes reverted by
+ * the next call of RestoreFrom(). It can be kept empty if RestoreFrom()
+ * copies the whole reference.
  * + void AddPixel( const InputPixelType &p ) is called when a new pixel
  * is added to the histogram.
  * + void RemovePixel( const InputPixelType &p ) is called when a pixel
@@ -71,6 +87,23 @@ namespace itk {
  * One histogram is created for each thread by the method NewHistogram().
  * The NewHistogram() method can be overiden to pass some parameters to the
  * histogram.
+ *
+ * The histograms are kept in a HistogramPool, with one slot per thread,
+ * when a thread has finished with them, and are reused by the next runs
+ * of the filter, so the large histograms are not allocated and zeroed
+ * again at each update. ReleaseScratchMemory() frees them. The histogram
+ * type must provide a void Reset() method which empties the histogram;
+ * the vector based histograms only clear their non empty bins.
+ *
+ * When several threads are used, the output requested region is split in
+ * tiles rather than in one slab per thread. Each thread starts with a
+ * contiguous range of tiles, and steals the half of the remaining tiles
+ * of the most loaded thread when it has computed its own ones, so the
+ * threads stay busy up to the end even when the cost of the pixels is not
+ * uniform. The tiles keep the whole lines when possible, and are large
+ * enough to make the initialization of their histogram cheap compared to
+ * the moves of the histogram. This can be disabled with
+ * WorkStealingOff(): the region is then split as in the other filters.
  * 
  * The neighborhood is defined by a structuring element, and must a
  * itk::Neighborhood object or a subclass.
@@ -128,46 +161,204 @@ public:
   /** n-dimensional Kernel radius. */
   typedef typename KernelType::SizeType RadiusType ;
 
-  typedef typename std::list< OffsetType > OffsetListType;
+  typedef typename Superclass::OffsetListType OffsetListType;
+  typedef typename Superclass::LinearOffsetListType LinearOffsetListType;
+  typedef typename Superclass::OffsetValueType OffsetValueType;
+
+  /** Set/Get the number of adjacent lines moved together by a thread, each
+   * with its own histogram. The pixels added and removed at the same
+   * offset on the different lines are read together, and the updates of
+   * the histograms are interleaved, which hides the latency of the
+   * updates when they are cheap, as with the 8 bits histograms. Defaults
+   * to 1: the lines are moved one after the other. */
+  itkSetClampMacro(NumberOfLockStepLines, unsigned int, 1, NumericTraits<unsigned int>::max());
+  itkGetMacro(NumberOfLockStepLines, unsigned int);
+
+  /** Set/Get whether the output is computed by tiles distributed to the
+   * threads with work stealing. Defaults to true. */
+  itkSetMacro(WorkStealing, bool);
+  itkGetMacro(WorkStealing, bool);
+  itkBooleanMacro(WorkStealing);
 
-  typedef typename std::map< OffsetType, OffsetListType, typename Functor::OffsetLexicographicCompare<ImageDimension> > OffsetMapType;
+  /** Free the histograms kept between the updates. They are allocated
+   * again by the next update. */
+  void ReleaseScratchMemory()
+    {
+    m_HistogramPool.Release();
+    }
 
 protected:
   MovingHistogramImageFilter();
-  ~MovingHistogramImageFilter() {};
+  ~MovingHistogramImageFilter();
+  void PrintSelf(std::ostream& os, Indent indent) const;
   
   /** Multi-thread version GenerateData. */
   void  ThreadedGenerateData (const OutputImageRegionType& 
                               outputRegionForThread,
                               int threadId) ;
 
-  /** NewHistogram must return an histogram object. It's also the good place to 
-   * pass parameters to the histogram.
-   * A default version is provided which just create a new Historgram and return
-   * it.
+  /** NewHistogram must return an empty histogram object for the thread.
+   * It's also the good place to pass parameters to the histogram.
+   * A default version is provided which reset an histogram of the pool of
+   * the thread, or create a new Historgram, and return it.
    */
-  virtual THistogram * NewHistogram();
+  virtual THistogram * NewHistogram( int threadId );
+
+  /** Return a copy of histogram, taken from the pool when possible.
+   * histogram must have been filled from an empty histogram, without any
+   * call of RestoreFrom(): the copy is an empty histogram restored from
+   * it, so only the blocks changed since it was empty are copied. */
+  THistogram * CloneHistogram( int threadId, THistogram * histogram );
+
+  /** Give back an histogram obtained with NewHistogram() or
+   * CloneHistogram() to the pool of the thread. */
+  void ReleaseHistogram( int threadId, THistogram * histogram );
 
 #ifndef zigzag
   // declare the type used to store the histogram
   typedef THistogram HistogramType;
 
+  /** \class OutputWriter
+   * \brief write the value of the histogram in the output image
+   *
+   * This is the writer used by ThreadedGenerateData(). The subclasses which
+   * compute several values from the same histogram can pass their own
+   * writer to ThreadedGenerateDataWithWriter(). A writer must provide
+   * + void StartLine( const IndexType & idx, unsigned int direction ), called
+   * at the beginning of each line with the index of its first pixel and the
+   * axis of the line.
+   * + void Write( HistogramType * histogram, const PixelType & center ),
+   * called for each pixel of the line, in order.
+   */
+  class OutputWriter
+    {
+    public:
+    OutputWriter( OutputImageType * output )
+      {
+      m_Output = output;
+      m_Pointer = NULL;
+      m_Stride = 0;
+      }
+
+    inline void StartLine( const IndexType & idx, unsigned int direction )
+      {
+      m_Pointer = m_Output->GetBufferPointer() + m_Output->ComputeOffset( idx );
+      m_Stride = m_Output->GetOffsetTable()[ direction ];
+      }
+
+    inline void Write( HistogramType * histogram, const PixelType & center )
+      {
+      *m_Pointer = static_cast< OutputPixelType >( histogram->GetValue( center ) );
+      m_Pointer += m_Stride;
+      }
+
+    private:
+    OutputImageType * m_Output;
+    OutputPixelType * m_Pointer;
+    OffsetValueType m_Stride;
+    };
+
+  /** Compute the output of the thread, and give the histogram to the
+   * writer at each pixel. The output is the region of the thread, or the
+   * tiles taken from the pool when the tiles are used. */
+  template <class TWriter>
+  void ThreadedGenerateDataWithWriter( const OutputImageRegionType& outputRegionForThread,
+                                       int threadId,
+                                       TWriter & writer );
+
+  /** Move the histogram over the region, and give it to the writer at
+   * each pixel. progress may be NULL. */
+  template <class TWriter>
+  void GenerateRegionWithWriter( const OutputImageRegionType& region,
+                                 int threadId,
+                                 TWriter & writer,
+                                 ProgressReporter * progress );
+
+  /** Same as above, with groups of NumberOfLockStepLines lines moved
+   * together. TWriter must be copy constructible: there is one writer per
+   * line of a group. */
+  template <class TWriter>
+  void GenerateRegionLockStep( const OutputImageRegionType& region,
+                               int threadId,
+                               TWriter & writer,
+                               ProgressReporter * progress );
+
+  /** Split the output requested region in tiles, and give a range of tiles
+   * to each thread. */
+  void BeforeThreadedGenerateData();
+
+  /** All the threads get the whole requested region when the tiles are
+   * used: their output is taken from the pool. */
+  int SplitRequestedRegion( int i, int num, OutputImageRegionType& splitRegion );
+
+  /** Split the region in about numberOfTiles tiles, and store them in
+   * m_Tiles. */
+  void ComputeTiles( const OutputImageRegionType & region, unsigned long numberOfTiles );
+
+  /** Get the next tile of the thread. Return false when there is no
+   * tile left to compute. */
+  bool NextTile( int threadId, unsigned long & tile );
+
+  /** Count a computed tile, and report the progress from the thread 0 */
+  void CompleteTile( int threadId );
+
   void pushHistogram(HistogramType * histogram, 
 		     const OffsetListType* addedList,
 		     const OffsetListType* removedList,
+		     const LinearOffsetListType* addedLinearList,
+		     const LinearOffsetListType* removedLinearList,
 		     const RegionType &inputRegion,
 		     const RegionType &kernRegion,
 		     const InputImageType* inputImage,
 		     const IndexType currentIdx);
 
+  /** move the histogram when the kernel is fully inside the input image */
+  inline void pushHistogramInterior(HistogramType * histogram, 
+				    const LinearOffsetListType* addedLinearList,
+				    const LinearOffsetListType* removedLinearList,
+				    const PixelType * center);
+
+  /** move the histograms of several lines in lock-step when the kernel is
+   * fully inside the input image. The line k is at laneStride * k from
+   * the first one. */
+  inline void pushHistogramInteriorLockStep(HistogramType ** histograms,
+                                            unsigned int numberOfLines,
+                                            const LinearOffsetListType* addedLinearList,
+                                            const LinearOffsetListType* removedLinearList,
+                                            const PixelType * center,
+                                            OffsetValueType laneStride);
+
+  /** move the histogram when the kernel may be partially outside the
+   * input image */
+  void pushHistogramBorder(HistogramType * histogram, 
+			   const OffsetListType* addedList,
+			   const OffsetListType* removedList,
+			   const RegionType &inputRegion,
+			   const InputImageType* inputImage,
+			   const IndexType currentIdx);
+
   void printHist(const HistogramType &H);
 
+  // the tiles, and the range of tiles left to each thread
+  std::vector< OutputImageRegionType > m_Tiles;
+  std::vector< unsigned long > m_TileBegin;
+  std::vector< unsigned long > m_TileEnd;
+  unsigned long m_CompletedTiles;
+  SimpleFastMutexLock m_TileLock;
+
 #endif
 
+  unsigned int m_NumberOfLockStepLines;
+
+  bool m_WorkStealing;
+
 private:
   MovingHistogramImageFilter(const Self&); //purposely not implemented
   void operator=(const Self&); //purposely not implemented
 
+  // the histograms not used by the threads, kept between the runs
+  HistogramPool< THistogram > m_HistogramPool;
+
 } ; // end of class
 
 } // end namespace itk
@@ -28,6 +28,7 @@
 #include "itkImageRegionIterator.h"
 #include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkImageLinearConstIteratorWithIndex.h"
+#include <algorithm>
 
 #endif
 
@@ -38,15 +39,64 @@ template<class TInputImage, class TOutputImage, class TKernel, class THistogram>
 MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
 ::MovingHistogramImageFilter()
 {
+  m_NumberOfLockStepLines = 1;
+  m_WorkStealing = true;
+#ifndef zigzag
+  m_CompletedTiles = 0;
+#endif
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel, class THistogram>
+MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
+::~MovingHistogramImageFilter()
+{
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel, class THistogram>
+void
+MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
+::PrintSelf(std::ostream &os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfLockStepLines: " << m_NumberOfLockStepLines << std::endl;
+  os << indent << "WorkStealing: " << m_WorkStealing << std::endl;
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel, class THistogram>
+THistogram *
+MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
+::NewHistogram( int threadId )
+{
+  // reuse an histogram of a previous run when there is one
+  return m_HistogramPool.Get( threadId );
 }
 
 
 template<class TInputImage, class TOutputImage, class TKernel, class THistogram>
 THistogram *
 MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
-::NewHistogram()
+::CloneHistogram( int threadId, THistogram * histogram )
 {
-  return new THistogram();
+  // histogram has been filled from an empty one, so its changes cover all
+  // its non empty bins: restoring an empty histogram from it only copies
+  // those blocks, instead of the whole histogram
+  THistogram * clone = this->NewHistogram( threadId );
+  clone->MergeChanges( *histogram );
+  clone->RestoreFrom( *histogram );
+  return clone;
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel, class THistogram>
+void
+MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
+::ReleaseHistogram( int threadId, THistogram * histogram )
+{
+  m_HistogramPool.GiveBack( threadId, histogram );
 }
 
 
@@ -59,14 +109,14 @@ MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
     ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
     
     // instanciate the histogram
-    THistogram * histogram = this->NewHistogram();
+    THistogram * histogram = this->NewHistogram( threadId );
 
     OutputImageType* outputImage = this->GetOutput();
     const InputImageType* inputImage = this->GetInput();
     RegionType inputRegion = inputImage->GetRequestedRegion();
     
     // initialize the histogram
-    for( typename OffsetListType::iterator listIt = this->m_KernelOffsets.begin(); listIt != this->m_KernelOffsets.end(); listIt++ )
+    for( typename OffsetListType::const_iterator listIt = this->GetKernelOffsets().begin(); listIt != this->GetKernelOffsets().end(); listIt++ )
       {
       IndexType idx = outputRegionForThread.GetIndex() + (*listIt);
       if( inputRegion.IsInside( idx ) )
@@ -96,8 +146,8 @@ MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
     // init the offset and get the lists for the best axis
     offset[this->m_Axes[axis]] = direction[this->m_Axes[axis]];
     // it's very important for performances to get a pointer and not a copy
-    const OffsetListType* addedList = &this->m_AddedOffsets[offset];;
-    const OffsetListType* removedList = &this->m_RemovedOffsets[offset];
+    const OffsetListType* addedList = &this->GetAddedOffsets()[this->GetDirectionIndex(offset)];;
+    const OffsetListType* removedList = &this->GetRemovedOffsets()[this->GetDirectionIndex(offset)];
 
     while( axis >= 0 )
       {
@@ -147,8 +197,8 @@ MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
           // the axis must be the last one
           axis = ImageDimension - 1;
           offset[this->m_Axes[axis]] = direction[this->m_Axes[axis]];
-          addedList = &this->m_AddedOffsets[offset];;
-          removedList = &this->m_RemovedOffsets[offset];
+          addedList = &this->GetAddedOffsets()[this->GetDirectionIndex(offset)];;
+          removedList = &this->GetRemovedOffsets()[this->GetDirectionIndex(offset)];
           }
         }
       else
@@ -167,8 +217,8 @@ MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
         if( axis >= 0 )
           {
           offset[this->m_Axes[axis]] = direction[this->m_Axes[axis]];
-          addedList = &this->m_AddedOffsets[offset];;
-          removedList = &this->m_RemovedOffsets[offset];
+          addedList = &this->GetAddedOffsets()[this->GetDirectionIndex(offset)];;
+          removedList = &this->GetRemovedOffsets()[this->GetDirectionIndex(offset)];
           }
         }
       }
@@ -185,16 +235,252 @@ MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
 ::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
                        int threadId) 
 {
-    
+  OutputWriter writer( this->GetOutput() );
+  this->ThreadedGenerateDataWithWriter( outputRegionForThread, threadId, writer );
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel, class THistogram>
+void
+MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
+::BeforeThreadedGenerateData()
+{
+  Superclass::BeforeThreadedGenerateData();
+
+  if( this->m_MaximumHistogramCount > THistogram::GetCountLimit() )
+    {
+    itkExceptionMacro( << "The kernel is too large for the counters of the histogram: "
+                       << this->m_MaximumHistogramCount << " pixels, at most "
+                       << THistogram::GetCountLimit() << " are supported." );
+    }
+
+  // each thread takes its histograms from its own slot of the pool
+  m_HistogramPool.SetNumberOfThreads( this->GetNumberOfThreads() );
+
+  m_Tiles.clear();
+  m_TileBegin.clear();
+  m_TileEnd.clear();
+  m_CompletedTiles = 0;
+
+  const unsigned long numberOfThreads = this->GetNumberOfThreads();
+  if( !m_WorkStealing || numberOfThreads <= 1 )
+    { return; }
+
+  // a few tiles per thread are enough to balance the load: the threads
+  // which have finished steal the tiles of the others
+  this->ComputeTiles( this->GetOutput()->GetRequestedRegion(), 8 * numberOfThreads );
+  if( m_Tiles.size() <= 1 )
+    {
+    m_Tiles.clear();
+    return;
+    }
+
+  // the tiles are in memory order: a contiguous range of tiles for each
+  // thread, as with the static split
+  const unsigned long numberOfRanges = std::min( numberOfThreads, (unsigned long)m_Tiles.size() );
+  m_TileBegin.resize( numberOfRanges );
+  m_TileEnd.resize( numberOfRanges );
+  for( unsigned long i=0; i<numberOfRanges; i++ )
+    {
+    m_TileBegin[i] = i * m_Tiles.size() / numberOfRanges;
+    m_TileEnd[i] = ( i + 1 ) * m_Tiles.size() / numberOfRanges;
+    }
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel, class THistogram>
+int
+MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
+::SplitRequestedRegion( int i, int num, OutputImageRegionType& splitRegion )
+{
+  if( m_Tiles.empty() )
+    { return Superclass::SplitRequestedRegion( i, num, splitRegion ); }
+
+  splitRegion = this->GetOutput()->GetRequestedRegion();
+  return m_TileBegin.size();
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel, class THistogram>
+void
+MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
+::ComputeTiles( const OutputImageRegionType & region, unsigned long numberOfTiles )
+{
+  const unsigned int bestDirection = this->m_Axes[ImageDimension - 1];
+
+  // The histogram is filled with all the pixels of the kernel at the
+  // beginning of a tile, and is then moved with about
+  // m_PixelsPerTranslation pixels per pixel. The tiles must be large
+  // enough to keep the filling cheap compared to the moves.
+  const double minimumPixels = 8.0 * this->GetKernelOffsets().size()
+    / std::max( this->m_PixelsPerTranslation, 1UL );
+
+  // halve the largest side of the tiles until there is enough tiles. The
+  // lines are split only when the tiles are already a single line.
+  SizeType tileSize = region.GetSize();
+  unsigned long count = 1;
+  while( count < numberOfTiles )
+    {
+    int axis = -1;
+    for( unsigned int i=0; i<ImageDimension; i++ )
+      {
+      if( i != bestDirection && tileSize[i] > 1 && ( axis < 0 || tileSize[i] > tileSize[axis] ) )
+        { axis = i; }
+      }
+    if( axis < 0 )
+      {
+      if( tileSize[bestDirection] <= 1 )
+        { break; }
+      axis = bestDirection;
+      }
+
+    unsigned long pixels = 1;
+    for( unsigned int i=0; i<ImageDimension; i++ )
+      { pixels *= tileSize[i]; }
+    if( pixels / 2.0 < minimumPixels )
+      { break; }
+
+    tileSize[axis] = ( tileSize[axis] + 1 ) / 2;
+    count = 1;
+    for( unsigned int i=0; i<ImageDimension; i++ )
+      { count *= ( region.GetSize()[i] + tileSize[i] - 1 ) / tileSize[i]; }
+    }
+
+  // store the tiles, with the first axis varying the fastest
+  m_Tiles.clear();
+  m_Tiles.reserve( count );
+  IndexType tileIndex = region.GetIndex();
+  for( unsigned long t=0; t<count; t++ )
+    {
+    OutputImageRegionType tile;
+    SizeType size;
+    for( unsigned int i=0; i<ImageDimension; i++ )
+      {
+      const long end = region.GetIndex()[i] + static_cast<long>( region.GetSize()[i] );
+      size[i] = std::min( static_cast<long>( tileSize[i] ), end - tileIndex[i] );
+      }
+    tile.SetIndex( tileIndex );
+    tile.SetSize( size );
+    m_Tiles.push_back( tile );
+
+    for( unsigned int i=0; i<ImageDimension; i++ )
+      {
+      tileIndex[i] += tileSize[i];
+      if( tileIndex[i] < region.GetIndex()[i] + static_cast<long>( region.GetSize()[i] ) )
+        { break; }
+      tileIndex[i] = region.GetIndex()[i];
+      }
+    }
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel, class THistogram>
+bool
+MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
+::NextTile( int threadId, unsigned long & tile )
+{
+  m_TileLock.Lock();
+  if( m_TileBegin[threadId] == m_TileEnd[threadId] )
+    {
+    // steal the half of the tiles left to the most loaded thread. They are
+    // taken at the end of its range, far from the tile it is computing.
+    unsigned long victim = 0;
+    for( unsigned long i=1; i<m_TileBegin.size(); i++ )
+      {
+      if( m_TileEnd[i] - m_TileBegin[i] > m_TileEnd[victim] - m_TileBegin[victim] )
+        { victim = i; }
+      }
+    const unsigned long stolen = ( m_TileEnd[victim] - m_TileBegin[victim] + 1 ) / 2;
+    if( stolen == 0 )
+      {
+      m_TileLock.Unlock();
+      return false;
+      }
+    m_TileEnd[threadId] = m_TileEnd[victim];
+    m_TileEnd[victim] -= stolen;
+    m_TileBegin[threadId] = m_TileEnd[victim];
+    }
+  tile = m_TileBegin[threadId]++;
+  m_TileLock.Unlock();
+  return true;
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel, class THistogram>
+void
+MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
+::CompleteTile( int threadId )
+{
+  m_TileLock.Lock();
+  const unsigned long completed = ++m_CompletedTiles;
+  m_TileLock.Unlock();
+
+  // only the thread 0 reports the progress, as with ProgressReporter
+  if( threadId == 0 )
+    {
+    this->UpdateProgress( static_cast<float>( completed ) / m_Tiles.size() );
+    if( this->GetAbortGenerateData() )
+      {
+      ProcessAborted e(__FILE__, __LINE__);
+      e.SetDescription("Process aborted.");
+      e.SetLocation(ITK_LOCATION);
+      throw e;
+      }
+    }
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel, class THistogram>
+template<class TWriter>
+void
+MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
+::ThreadedGenerateDataWithWriter(const OutputImageRegionType& outputRegionForThread,
+                                 int threadId,
+                                 TWriter & writer) 
+{
+  if( m_Tiles.empty() )
+    {
+    // static split: the thread computes its own region
+    // Report progress every line instead of every pixel
+    const unsigned long lineLength = outputRegionForThread.GetSize()[this->m_Axes[ImageDimension - 1]];
+    ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels()/lineLength);
+    this->GenerateRegionWithWriter( outputRegionForThread, threadId, writer, &progress );
+    return;
+    }
+
+  // take the tiles from the pool until they are all computed
+  unsigned long tile;
+  while( this->NextTile( threadId, tile ) )
+    {
+    this->GenerateRegionWithWriter( m_Tiles[tile], threadId, writer, NULL );
+    this->CompleteTile( threadId );
+    }
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel, class THistogram>
+template<class TWriter>
+void
+MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
+::GenerateRegionWithWriter(const OutputImageRegionType& outputRegionForThread,
+                           int threadId,
+                           TWriter & writer,
+                           ProgressReporter * progress) 
+{
+    if (m_NumberOfLockStepLines > 1 && ImageDimension > 1)
+      {
+      this->GenerateRegionLockStep(outputRegionForThread, threadId, writer, progress);
+      return;
+      }
+
     // instantiate the histogram
-    HistogramType * histogram = this->NewHistogram();
+    HistogramType * histogram = this->NewHistogram( threadId );
     
-    OutputImageType* outputImage = this->GetOutput();
     const InputImageType* inputImage = this->GetInput();
     RegionType inputRegion = inputImage->GetRequestedRegion();
     
     // initialize the histogram
-    for( typename OffsetListType::iterator listIt = this->m_KernelOffsets.begin(); listIt != this->m_KernelOffsets.end(); listIt++ )
+    for( typename OffsetListType::const_iterator listIt = this->GetKernelOffsets().begin(); listIt != this->GetKernelOffsets().end(); listIt++ )
       {
       IndexType idx = outputRegionForThread.GetIndex() + (*listIt);
       if( inputRegion.IsInside( idx ) )
@@ -206,7 +492,6 @@ MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
     // now move the histogram
     itk::FixedArray<short, ImageDimension> direction;
     direction.Fill(1);
-    IndexType currentIdx = outputRegionForThread.GetIndex();
     int axis = ImageDimension - 1;
     OffsetType offset;
     offset.Fill( 0 );
@@ -219,15 +504,15 @@ MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
       { centerOffset[axis] = stRegion.GetSize()[axis] / 2; }
 
     int BestDirection = this->m_Axes[axis];
-    int LineLength = inputRegion.GetSize()[BestDirection];
 
-    // Report progress every line instead of every pixel
-    ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels()/outputRegionForThread.GetSize()[BestDirection]);
     // init the offset and get the lists for the best axis
     offset[BestDirection] = direction[BestDirection];
     // it's very important for performances to get a pointer and not a copy
-    const OffsetListType* addedList = &this->m_AddedOffsets[offset];;
-    const OffsetListType* removedList = &this->m_RemovedOffsets[offset];
+    unsigned int directionIndex = this->GetDirectionIndex(BestDirection, direction[BestDirection]);
+    const OffsetListType* addedList = &this->GetAddedOffsets()[directionIndex];
+    const OffsetListType* removedList = &this->GetRemovedOffsets()[directionIndex];
+    const LinearOffsetListType* addedLinearList = &this->m_AddedLinearOffsets[directionIndex];
+    const LinearOffsetListType* removedLinearList = &this->m_RemovedLinearOffsets[directionIndex];
 
     typedef typename itk::ImageLinearConstIteratorWithIndex<InputImageType> InputLineIteratorType;
     InputLineIteratorType InLineIt(inputImage, outputRegionForThread);
@@ -242,36 +527,104 @@ MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
 
     typedef typename std::vector<HistogramType *> HistVecType;
     HistVecType HistVec(ImageDimension);
-    typedef typename std::vector<IndexType> IndexVecType;
-    IndexVecType PrevLineStartVec(ImageDimension);
 
-    // Steps is used to keep track of the order in which the line
-    // iterator passes over the various dimensions.
-    int *Steps = new int[ImageDimension];
+    // Order in which the line iterator passes over the various
+    // dimensions, from the one changed the less often to the line
+    // direction: the iterator moves to the next line on the lowest
+    // dimension first.
+    std::vector<unsigned int> LevelOrder;
+    std::vector<unsigned int> LevelOfDim(ImageDimension);
+    for (int i=ImageDimension-1;i>=0;i--)
+      {
+      if (i != BestDirection)
+        {
+        LevelOfDim[i] = LevelOrder.size();
+        LevelOrder.push_back(i);
+        }
+      }
+    LevelOfDim[BestDirection] = LevelOrder.size();
+    LevelOrder.push_back(BestDirection);
+
+    for (unsigned int i=0;i<ImageDimension;i++)
+      {
+      HistVec[i] = this->CloneHistogram(threadId, histogram);
+      }
 
+    // The interior is the set of positions where the kernel, padded by
+    // one pixel for the translation, is fully inside the input image. The
+    // histogram can be moved from those positions without any bounds
+    // checking.
+    IndexType interiorFirst, interiorLast;
     for (unsigned int i=0;i<ImageDimension;i++)
       {
-      HistVec[i] = histogram->Clone();
-      PrevLineStartVec[i] = InLineIt.GetIndex();
-      Steps[i]=0;
+      interiorFirst[i] = inputRegion.GetIndex()[i] + centerOffset[i];
+      interiorLast[i] = inputRegion.GetIndex()[i] + static_cast<long>(inputRegion.GetSize()[i])
+        - static_cast<long>(stRegion.GetSize()[i]) + centerOffset[i];
       }
 
+    const long LineLength = outputRegionForThread.GetSize()[BestDirection];
+    const OffsetValueType inputStride = inputImage->GetOffsetTable()[BestDirection];
+
     while(!InLineIt.IsAtEnd())
       {
       HistogramType *histRef = HistVec[BestDirection];
       IndexType PrevLineStart = InLineIt.GetIndex();
-      for (InLineIt.GoToBeginOfLine(); !InLineIt.IsAtEndOfLine(); ++InLineIt)
+
+      // Find the part of the line in the interior. The line is in the
+      // interior only if all its other coordinates are in the interior.
+      long interiorBegin = 0;
+      long interiorEnd = 0;
+      bool lineInInterior = true;
+      for (unsigned int i=0;i<ImageDimension;i++)
 	{
-	
-	// Update the historgram
-	IndexType currentIdx = InLineIt.GetIndex();
-	outputImage->SetPixel(currentIdx, static_cast< OutputPixelType >( histRef->GetValue( inputImage->GetPixel( currentIdx ) ) ));
-	stRegion.SetIndex( currentIdx - centerOffset );
-	pushHistogram(histRef, addedList, removedList, inputRegion, 
-		      stRegion, inputImage, currentIdx);
+	if (i != (unsigned int)BestDirection
+	    && (PrevLineStart[i] < interiorFirst[i] || PrevLineStart[i] > interiorLast[i]))
+	  {
+	  lineInInterior = false;
+	  }
+	}
+      if (lineInInterior)
+	{
+	interiorBegin = std::max(interiorFirst[BestDirection] - PrevLineStart[BestDirection], 0L);
+	interiorEnd = std::min(interiorLast[BestDirection] + 1 - PrevLineStart[BestDirection], LineLength);
+	interiorEnd = std::max(interiorEnd, interiorBegin);
+	}
+      // the histogram is not moved after the last pixel of the line
+      const long lastPixel = LineLength - 1;
 
+      IndexType currentIdx = PrevLineStart;
+      const PixelType * inputPointer = inputImage->GetBufferPointer() + inputImage->ComputeOffset(currentIdx);
+      writer.StartLine(currentIdx, BestDirection);
+      long pos = 0;
+      // border at the beginning of the line
+      for (; pos < std::min(interiorBegin, lastPixel); pos++)
+	{
+	writer.Write(histRef, *inputPointer);
+	pushHistogramBorder(histRef, addedList, removedList, inputRegion,
+			    inputImage, currentIdx);
+	currentIdx[BestDirection]++;
+	inputPointer += inputStride;
+	}
+      // interior
+      for (; pos < std::min(interiorEnd, lastPixel); pos++)
+	{
+	writer.Write(histRef, *inputPointer);
+	pushHistogramInterior(histRef, addedLinearList, removedLinearList,
+			      inputPointer);
+	inputPointer += inputStride;
 	}
-      Steps[BestDirection] += LineLength;
+      currentIdx[BestDirection] = PrevLineStart[BestDirection] + pos;
+      // border at the end of the line
+      for (; pos < lastPixel; pos++)
+	{
+	writer.Write(histRef, *inputPointer);
+	pushHistogramBorder(histRef, addedList, removedList, inputRegion,
+			    inputImage, currentIdx);
+	currentIdx[BestDirection]++;
+	inputPointer += inputStride;
+	}
+      writer.Write(histRef, *inputPointer);
+
       InLineIt.NextLine();
       if (InLineIt.IsAtEnd())
 	{
@@ -290,45 +643,275 @@ MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
       // This function deals with changing planes etc
       GetDirAndOffset(LineStart, PrevLineStart, ImageDimension,
 		      LineOffset, Changes, LineDirection);
-      ++(Steps[LineDirection]);
       IndexType PrevLineStartHist = LineStart - LineOffset;
-      const OffsetListType* addedListLine = &this->m_AddedOffsets[LineOffset];;
-      const OffsetListType* removedListLine = &this->m_RemovedOffsets[LineOffset];
+      unsigned int lineDirectionIndex = this->GetDirectionIndex(LineDirection, 1);
+      const OffsetListType* addedListLine = &this->GetAddedOffsets()[lineDirectionIndex];
+      const OffsetListType* removedListLine = &this->GetRemovedOffsets()[lineDirectionIndex];
+      const LinearOffsetListType* addedLinearListLine = &this->m_AddedLinearOffsets[lineDirectionIndex];
+      const LinearOffsetListType* removedLinearListLine = &this->m_RemovedLinearOffsets[lineDirectionIndex];
       HistogramType *tmpHist = HistVec[LineDirection];
-      stRegion.SetIndex(PrevLineStart - centerOffset);
-      // Now move the histogram
-      pushHistogram(tmpHist, addedListLine, removedListLine, inputRegion, 
-		    stRegion, inputImage, PrevLineStartHist);
-
-      //PrevLineStartVec[LineDirection] = LineStart;
-      // copy the updated histogram and line start entries to the
-      // relevant directions. When updating direction 2, for example,
-      // new copies of directions 0 and 1 should be made.
-      for (unsigned int i=0;i<ImageDimension;i++) 
+      // The histograms of the directions iterated more often than
+      // LineDirection must be identical to the one of LineDirection
+      // after the move. They are restored from this histogram, which
+      // has not been modified since they were identical to it - the
+      // changes they need to revert are their own changes and the ones
+      // of the directions between them and LineDirection - and then moved
+      // like it. This way, the cost of a line change is proportional
+      // to the size of the kernel face rather than to the size of the
+      // histogram.
+      unsigned int level = LevelOfDim[LineDirection];
+      for (unsigned int i=level+2;i<ImageDimension;i++)
+	{
+	HistVec[LevelOrder[i]]->MergeChanges(*HistVec[LevelOrder[i-1]]);
+	}
+      for (unsigned int i=level+1;i<ImageDimension;i++)
+	{
+	HistVec[LevelOrder[i]]->RestoreFrom(*tmpHist);
+	}
+      stRegion.SetIndex(PrevLineStartHist - centerOffset);
+      // Now move the histograms
+      for (unsigned int i=level;i<ImageDimension;i++)
+	{
+	pushHistogram(HistVec[LevelOrder[i]], addedListLine, removedListLine,
+		      addedLinearListLine, removedLinearListLine, inputRegion,
+		      stRegion, inputImage, PrevLineStartHist);
+	}
+      if (progress)
 	{
-	if (Steps[i] > Steps[LineDirection])
+	progress->CompletedPixel();
+	}
+      }
+  for (unsigned i=0;i<ImageDimension;i++) 
+    {
+    this->ReleaseHistogram(threadId, HistVec[i]);
+    }
+  this->ReleaseHistogram(threadId, histogram);
+}
+
+template<class TInputImage, class TOutputImage, class TKernel, class THistogram>
+template<class TWriter>
+void
+MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
+::GenerateRegionLockStep(const OutputImageRegionType& outputRegionForThread,
+                         int threadId,
+                         TWriter & writer,
+                         ProgressReporter * progress) 
+{
+  const InputImageType* inputImage = this->GetInput();
+  RegionType inputRegion = inputImage->GetRequestedRegion();
+
+  const int BestDirection = this->m_Axes[ImageDimension - 1];
+  // the lines of a group are adjacent on the first axis the line iterator
+  // moves along
+  const unsigned int LaneDirection = ( BestDirection == 0 ) ? 1 : 0;
+  const long LineLength = outputRegionForThread.GetSize()[BestDirection];
+
+  RegionType stRegion;
+  stRegion.SetSize( this->m_Kernel.GetSize() );
+  stRegion.PadByRadius( 1 ); // must pad the region by one because of the translation
+
+  OffsetType centerOffset;
+  for( unsigned int axis=0; axis<ImageDimension; axis++)
+    { centerOffset[axis] = stRegion.GetSize()[axis] / 2; }
+
+  const unsigned int directionIndex = this->GetDirectionIndex(BestDirection, 1);
+  const OffsetListType* addedList = &this->GetAddedOffsets()[directionIndex];
+  const OffsetListType* removedList = &this->GetRemovedOffsets()[directionIndex];
+  const LinearOffsetListType* addedLinearList = &this->m_AddedLinearOffsets[directionIndex];
+  const LinearOffsetListType* removedLinearList = &this->m_RemovedLinearOffsets[directionIndex];
+  const unsigned int laneDirectionIndex = this->GetDirectionIndex(LaneDirection, 1);
+  const OffsetListType* addedListLane = &this->GetAddedOffsets()[laneDirectionIndex];
+  const OffsetListType* removedListLane = &this->GetRemovedOffsets()[laneDirectionIndex];
+  const LinearOffsetListType* addedLinearListLane = &this->m_AddedLinearOffsets[laneDirectionIndex];
+  const LinearOffsetListType* removedLinearListLane = &this->m_RemovedLinearOffsets[laneDirectionIndex];
+
+  // same interior as in ThreadedGenerateDataWithWriter()
+  IndexType interiorFirst, interiorLast;
+  for (unsigned int i=0;i<ImageDimension;i++)
+    {
+    interiorFirst[i] = inputRegion.GetIndex()[i] + centerOffset[i];
+    interiorLast[i] = inputRegion.GetIndex()[i] + static_cast<long>(inputRegion.GetSize()[i])
+      - static_cast<long>(stRegion.GetSize()[i]) + centerOffset[i];
+    }
+
+  const OffsetValueType inputStride = inputImage->GetOffsetTable()[BestDirection];
+  const OffsetValueType laneStride = inputImage->GetOffsetTable()[LaneDirection];
+
+  // The histogram of a line start is the one of the previous line start,
+  // moved by one pixel on LaneDirection. The histograms are copied with
+  // the assignment operator: this mode is meant for the histograms which
+  // are cheap to copy.
+  const unsigned int nbOfLanes = m_NumberOfLockStepLines;
+  HistogramType * empty = this->NewHistogram(threadId);
+  HistogramType * lineStartHist = this->CloneHistogram(threadId, empty);
+  bool lineStartHistIsValid = false;
+  IndexType lineStartHistIdx;
+  lineStartHistIdx.Fill(0);
+  std::vector<HistogramType *> lanes(nbOfLanes);
+  for (unsigned int k=0;k<nbOfLanes;k++)
+    {
+    lanes[k] = this->CloneHistogram(threadId, empty);
+    }
+  std::vector<TWriter> writers(nbOfLanes, writer);
+  std::vector<IndexType> laneStart(nbOfLanes);
+  std::vector<IndexType> laneIdx(nbOfLanes);
+  std::vector<const PixelType *> lanePointer(nbOfLanes);
+
+  typedef typename itk::ImageLinearConstIteratorWithIndex<InputImageType> InputLineIteratorType;
+  InputLineIteratorType InLineIt(inputImage, outputRegionForThread);
+  InLineIt.SetDirection(BestDirection);
+  InLineIt.GoToBegin();
+
+  while(!InLineIt.IsAtEnd())
+    {
+    // gather the next lines, as long as they are adjacent on LaneDirection
+    unsigned int nbOfLines = 0;
+    while (nbOfLines < nbOfLanes && !InLineIt.IsAtEnd())
+      {
+      IndexType start = InLineIt.GetIndex();
+      if (nbOfLines > 0)
+	{
+	IndexType expected = laneStart[nbOfLines - 1];
+	expected[LaneDirection]++;
+	if (start != expected)
 	  {
-	  //PrevLineStartVec[i] = LineStart;
-	  delete(HistVec[i]);
-	  HistVec[i] = HistVec[LineDirection]->Clone();
+	  break;
 	  }
 	}
-      progress.CompletedPixel();
+      laneStart[nbOfLines++] = start;
+      InLineIt.NextLine();
       }
-  for (unsigned i=0;i<ImageDimension;i++) 
+
+    // the histograms at the start of the lines
+    for (unsigned int k=0;k<nbOfLines;k++)
+      {
+      const HistogramType * previous = ( k == 0 ) ? lineStartHist : lanes[k - 1];
+      IndexType previousIdx = ( k == 0 ) ? lineStartHistIdx : laneStart[k - 1];
+      IndexType expected = previousIdx;
+      expected[LaneDirection]++;
+      if ((k > 0 || lineStartHistIsValid) && laneStart[k] == expected)
+	{
+	*lanes[k] = *previous;
+	stRegion.SetIndex(previousIdx - centerOffset);
+	pushHistogram(lanes[k], addedListLane, removedListLane,
+		      addedLinearListLane, removedLinearListLane, inputRegion,
+		      stRegion, inputImage, previousIdx);
+	}
+      else
+	{
+	// first line of a new plane: fill the histogram from scratch
+	*lanes[k] = *empty;
+	for( typename OffsetListType::const_iterator listIt = this->GetKernelOffsets().begin(); listIt != this->GetKernelOffsets().end(); listIt++ )
+	  {
+	  IndexType idx = laneStart[k] + (*listIt);
+	  if( inputRegion.IsInside( idx ) )
+	    { lanes[k]->AddPixel( inputImage->GetPixel(idx) ); }
+	  else
+	    { lanes[k]->AddBoundary(); }
+	  }
+	}
+      }
+    *lineStartHist = *lanes[nbOfLines - 1];
+    lineStartHistIdx = laneStart[nbOfLines - 1];
+    lineStartHistIsValid = true;
+
+    // The lines can be moved in lock-step in the interior only if they are
+    // all in the interior.
+    long interiorBegin = 0;
+    long interiorEnd = 0;
+    bool linesInInterior = laneStart[0][LaneDirection] >= interiorFirst[LaneDirection]
+      && laneStart[nbOfLines - 1][LaneDirection] <= interiorLast[LaneDirection];
+    for (unsigned int i=0;i<ImageDimension;i++)
+      {
+      if (i != (unsigned int)BestDirection && i != LaneDirection
+	  && (laneStart[0][i] < interiorFirst[i] || laneStart[0][i] > interiorLast[i]))
+	{
+	linesInInterior = false;
+	}
+      }
+    if (linesInInterior)
+      {
+      interiorBegin = std::max(interiorFirst[BestDirection] - laneStart[0][BestDirection], 0L);
+      interiorEnd = std::min(interiorLast[BestDirection] + 1 - laneStart[0][BestDirection], LineLength);
+      interiorEnd = std::max(interiorEnd, interiorBegin);
+      }
+    const long lastPixel = LineLength - 1;
+
+    for (unsigned int k=0;k<nbOfLines;k++)
+      {
+      laneIdx[k] = laneStart[k];
+      lanePointer[k] = inputImage->GetBufferPointer() + inputImage->ComputeOffset(laneStart[k]);
+      writers[k].StartLine(laneStart[k], BestDirection);
+      }
+    long pos = 0;
+    // border at the beginning of the lines
+    for (; pos < std::min(interiorBegin, lastPixel); pos++)
+      {
+      for (unsigned int k=0;k<nbOfLines;k++)
+	{
+	writers[k].Write(lanes[k], *lanePointer[k]);
+	pushHistogramBorder(lanes[k], addedList, removedList, inputRegion,
+			    inputImage, laneIdx[k]);
+	laneIdx[k][BestDirection]++;
+	lanePointer[k] += inputStride;
+	}
+      }
+    // interior, in lock-step
+    const PixelType * inputPointer = lanePointer[0];
+    for (; pos < std::min(interiorEnd, lastPixel); pos++)
+      {
+      for (unsigned int k=0;k<nbOfLines;k++)
+	{
+	writers[k].Write(lanes[k], inputPointer[k * laneStride]);
+	}
+      pushHistogramInteriorLockStep(&lanes[0], nbOfLines, addedLinearList,
+				    removedLinearList, inputPointer, laneStride);
+      inputPointer += inputStride;
+      }
+    for (unsigned int k=0;k<nbOfLines;k++)
+      {
+      laneIdx[k][BestDirection] = laneStart[k][BestDirection] + pos;
+      lanePointer[k] = inputPointer + k * laneStride;
+      }
+    // border at the end of the lines
+    for (; pos < lastPixel; pos++)
+      {
+      for (unsigned int k=0;k<nbOfLines;k++)
+	{
+	writers[k].Write(lanes[k], *lanePointer[k]);
+	pushHistogramBorder(lanes[k], addedList, removedList, inputRegion,
+			    inputImage, laneIdx[k]);
+	laneIdx[k][BestDirection]++;
+	lanePointer[k] += inputStride;
+	}
+      }
+    for (unsigned int k=0;k<nbOfLines;k++)
+      {
+      writers[k].Write(lanes[k], *lanePointer[k]);
+      if (progress)
+	{
+	progress->CompletedPixel();
+	}
+      }
+    }
+
+  for (unsigned int k=0;k<nbOfLanes;k++)
     {
-    delete(HistVec[i]);
+    this->ReleaseHistogram(threadId, lanes[k]);
     }
-  delete [] Steps;
-  delete histogram;
+  this->ReleaseHistogram(threadId, lineStartHist);
+  this->ReleaseHistogram(threadId, empty);
 }
 
+
 template<class TInputImage, class TOutputImage, class TKernel, class THistogram>
 void
 MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
 ::pushHistogram(HistogramType * histogram, 
 		const OffsetListType* addedList,
 		const OffsetListType* removedList,
+		const LinearOffsetListType* addedLinearList,
+		const LinearOffsetListType* removedLinearList,
 		const RegionType &inputRegion,
 		const RegionType &kernRegion,
 		const InputImageType* inputImage,
@@ -337,31 +920,88 @@ MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
 
   if( inputRegion.IsInside( kernRegion ) )
     {
-    // update the histogram
-    for( typename OffsetListType::const_iterator addedIt = addedList->begin(); addedIt != addedList->end(); addedIt++ )
-      { histogram->AddPixel( inputImage->GetPixel( currentIdx + (*addedIt) ) ); }
-    for( typename OffsetListType::const_iterator removedIt = removedList->begin(); removedIt != removedList->end(); removedIt++ )
-      { histogram->RemovePixel( inputImage->GetPixel( currentIdx + (*removedIt) ) ); }
+    // all the pixels are in the image: read them directly in the buffer
+    pushHistogramInterior( histogram, addedLinearList, removedLinearList,
+                           inputImage->GetBufferPointer() + inputImage->ComputeOffset( currentIdx ) );
     }
   else
     {
-    // update the histogram
-    for( typename OffsetListType::const_iterator addedIt = addedList->begin(); addedIt != addedList->end(); addedIt++ )
-      {
-      IndexType idx = currentIdx + (*addedIt);
-      if( inputRegion.IsInside( idx ) )
-        { histogram->AddPixel( inputImage->GetPixel( idx ) ); }
-      else
-        { histogram->AddBoundary(); }
-      }
-    for( typename OffsetListType::const_iterator removedIt = removedList->begin(); removedIt != removedList->end(); removedIt++ )
-      {
-      IndexType idx = currentIdx + (*removedIt);
-      if( inputRegion.IsInside( idx ) )
-        { histogram->RemovePixel( inputImage->GetPixel( idx ) ); }
-      else
-        { histogram->RemoveBoundary(); }
-      }
+    pushHistogramBorder( histogram, addedList, removedList, inputRegion,
+                         inputImage, currentIdx );
+    }
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel, class THistogram>
+inline void
+MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
+::pushHistogramInterior(HistogramType * histogram, 
+		        const LinearOffsetListType* addedLinearList,
+		        const LinearOffsetListType* removedLinearList,
+		        const PixelType * center)
+{
+  // update the histogram
+  for( typename LinearOffsetListType::const_iterator addedIt = addedLinearList->begin(); addedIt != addedLinearList->end(); addedIt++ )
+    { histogram->AddPixel( center[ *addedIt ] ); }
+  for( typename LinearOffsetListType::const_iterator removedIt = removedLinearList->begin(); removedIt != removedLinearList->end(); removedIt++ )
+    { histogram->RemovePixel( center[ *removedIt ] ); }
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel, class THistogram>
+inline void
+MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
+::pushHistogramInteriorLockStep(HistogramType ** histograms,
+                                unsigned int numberOfLines,
+                                const LinearOffsetListType* addedLinearList,
+                                const LinearOffsetListType* removedLinearList,
+                                const PixelType * center,
+                                OffsetValueType laneStride)
+{
+  // the pixels at the same offset are read together, and the updates of
+  // the different histograms, which don't depend on each other, are
+  // interleaved
+  for( typename LinearOffsetListType::const_iterator addedIt = addedLinearList->begin(); addedIt != addedLinearList->end(); addedIt++ )
+    {
+    const PixelType * p = center + *addedIt;
+    for( unsigned int k=0; k<numberOfLines; k++ )
+      { histograms[k]->AddPixel( p[ k * laneStride ] ); }
+    }
+  for( typename LinearOffsetListType::const_iterator removedIt = removedLinearList->begin(); removedIt != removedLinearList->end(); removedIt++ )
+    {
+    const PixelType * p = center + *removedIt;
+    for( unsigned int k=0; k<numberOfLines; k++ )
+      { histograms[k]->RemovePixel( p[ k * laneStride ] ); }
+    }
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel, class THistogram>
+void
+MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
+::pushHistogramBorder(HistogramType * histogram, 
+		      const OffsetListType* addedList,
+		      const OffsetListType* removedList,
+		      const RegionType &inputRegion,
+		      const InputImageType* inputImage,
+		      const IndexType currentIdx)
+{
+  // update the histogram
+  for( typename OffsetListType::const_iterator addedIt = addedList->begin(); addedIt != addedList->end(); addedIt++ )
+    {
+    IndexType idx = currentIdx + (*addedIt);
+    if( inputRegion.IsInside( idx ) )
+      { histogram->AddPixel( inputImage->GetPixel( idx ) ); }
+    else
+      { histogram->AddBoundary(); }
+    }
+  for( typename OffsetListType::const_iterator removedIt = removedList->begin(); removedIt != removedList->end(); removedIt++ )
+    {
+    IndexType idx = currentIdx + (*removedIt);
+    if( inputRegion.IsInside( idx ) )
+      { histogram->RemovePixel( inputImage->GetPixel( idx ) ); }
+    else
+      { histogram->RemoveBoundary(); }
     }
 }
 
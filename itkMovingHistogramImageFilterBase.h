@@ -18,13 +18,65 @@
 #define __itkMovingHistogramImageFilterBase_h
 
 #include "itkKernelImageFilter.h"
-#include <list>
-#include <map>
+#include "itkFixedArray.h"
 #include <set>
+#include <vector>
 #include "itkOffsetLexicographicCompare.h"
+#include "itkKernelCache.h"
 
 namespace itk {
 
+/** \class MovingHistogramKernelCacheKey
+ * \brief the key of a kernel in the cache of MovingHistogramImageFilterBase
+ *
+ * The result of the preprocessing only depends on the size of the kernel
+ * and on the position of its active pixels. The hash is compared first,
+ * so the active pixels are only compared for the kernels with the same
+ * hash.
+ */
+template< unsigned int VDimension >
+struct MovingHistogramKernelCacheKey
+{
+  unsigned long m_Hash;
+  Size< VDimension > m_Size;
+  std::vector< bool > m_Active;
+
+  bool operator< ( const MovingHistogramKernelCacheKey & other ) const
+    {
+    if( m_Hash != other.m_Hash )
+      { return m_Hash < other.m_Hash; }
+    for( unsigned int i=0; i<VDimension; i++ )
+      {
+      if( m_Size[i] != other.m_Size[i] )
+        { return m_Size[i] < other.m_Size[i]; }
+      }
+    return m_Active < other.m_Active;
+    }
+};
+
+/** \class MovingHistogramKernelCacheEntry
+ * \brief the result of the preprocessing of a kernel by
+ * MovingHistogramImageFilterBase
+ *
+ * The offset lists are large for the large kernels: the filters with the
+ * same kernel use the ones of the shared entry of the cache, without
+ * copying them.
+ */
+template< unsigned int VDimension >
+struct MovingHistogramKernelCacheEntry
+{
+  typedef std::vector< Offset< VDimension > > OffsetListType;
+
+  OffsetListType m_KernelOffsets;
+  std::vector< OffsetListType > m_AddedOffsets;
+  std::vector< OffsetListType > m_RemovedOffsets;
+  FixedArray< unsigned long, VDimension > m_TranslationCounts;
+  FixedArray< int, VDimension > m_Axes;
+  unsigned long m_MaximumHistogramCount;
+  double m_PredictedCost;
+};
+
+
 /**
  * \class MovingHistogramImageFilterBase
  * \brief Implements a generic moving histogram algorithm
@@ -46,11 +98,22 @@ namespace itk {
  * the structuring element (or kernel) type, and the histogram type.
  * The input and output image must have the same number of dimension.
  *
- * The histogram type is a class which has to implements seven methods:
+ * The histogram type is a class which has to implements nine methods:
  * + a default constructor which takes no parameter.
- * + HistogramType * Clone() must produce a new identical histogram. It is
- * used internally to optimize the filter, by avoiding reverse iteration
- * over the image.
+ * + HistogramType * Clone() must produce a new identical histogram.
+ * + void RestoreFrom( const HistogramType & reference ) must make the
+ * histogram identical to reference. It is used when the filter moves to
+ * a new line, and it is only called when the histogram was identical to
+ * reference after the previous call of RestoreFrom() or Reset(), except
+ * for its own changes and the ones added with MergeChanges(). It is also
+ * used to copy an histogram, by restoring an empty histogram from it, to
+ * avoid reverse iteration over the image. The histograms with
+ * a large number of bins should only revert those changes rather than
+ * copy the whole reference.
+ * + void MergeChanges( const HistogramType & other ) must add the changes
+ * of other since its last call of RestoreFrom() to the changes reverted by
+ * the next call of RestoreFrom(). It can be kept empty if RestoreFrom()
+ * copies the whole reference.
  * + void AddPixel( const InputPixelType &p ) is called when a new pixel
  * is added to the histogram.
  * + void RemovePixel( const InputPixelType &p ) is called when a pixel
@@ -65,6 +128,9 @@ namespace itk {
  * pixels.
  * + AType GetValue() is called to set the value of the output image. AType
  * must be the output pixel type, or a type castable to the output pixel type.
+ * + static unsigned long GetCountLimit() must return the largest number of
+ * pixels the histogram can hold. The filter throws an exception when the
+ * kernel needs more.
  *
  * MovingHistogramImageFilterBase add the new pixels before removing the old ones,
  * so, if AddBoundary() is implemented and/or the kernel is symetric, it is safe
@@ -130,19 +196,112 @@ public:
   /** n-dimensional Kernel radius. */
   typedef typename KernelType::SizeType RadiusType ;
 
-  typedef typename std::list< OffsetType > OffsetListType;
+  /** The offsets are stored in contiguous arrays, sorted in the order of
+   * the pixels in memory. */
+  typedef typename std::vector< OffsetType > OffsetListType;
 
-  typedef typename std::map< OffsetType, OffsetListType, typename Functor::OffsetLexicographicCompare<ImageDimension> > OffsetMapType;
+  /** Offsets in the input buffer, used to read the pixels with a pointer
+   * when the kernel is fully inside the input image */
+  typedef typename OffsetType::OffsetValueType OffsetValueType;
+  typedef typename std::vector< OffsetValueType > LinearOffsetListType;
 
-  /** Set kernel (structuring element). */
+  /** One list of offsets for each direction of each axis, indexed with
+   * GetDirectionIndex(). */
+  typedef typename std::vector< OffsetListType > OffsetTableType;
+  typedef typename std::vector< LinearOffsetListType > LinearOffsetTableType;
+
+  /** Set kernel (structuring element). The offset tables computed from the
+   * kernel are stored in a process wide cache, shared by all the moving
+   * histogram filters with the same dimension, so setting a kernel already
+   * used by another filter is cheap. */
   void SetKernel( const KernelType& kernel );
 
+  /** Get the number of pixels added and removed by a translation along
+   * the axis of the lines: the axis with the smallest translations after
+   * SetKernel(), and the axis chosen for the last run after an update. */
   itkGetMacro(PixelsPerTranslation, unsigned long);
+
+  typedef typename itk::FixedArray< int, ImageDimension > AxesType;
+
+  /** Get the traversal axes, sorted from the most expensive to the
+   * cheapest one. The last one is the axis of the lines. */
+  itkGetConstReferenceMacro(Axes, AxesType);
+
+  /** Get the largest number of pixels held by a histogram with the
+   * current kernel. */
+  itkGetMacro(MaximumHistogramCount, unsigned long);
+
+  /** Get the predicted cost, in histogram updates per pixel, of the
+   * traversal axis chosen for the last run. */
+  itkGetMacro(PredictedCost, double);
   
 protected:
   MovingHistogramImageFilterBase();
   ~MovingHistogramImageFilterBase() {};
+  void PrintSelf(std::ostream& os, Indent indent) const;
   
+  /** Choose the traversal axes and compute the linear offsets of the added
+   * and removed pixels in the buffer of the input image. */
+  void BeforeThreadedGenerateData();
+
+  /** Sort the axes from the most expensive to the cheapest one. */
+  static void SortAxes( const FixedArray< double, ImageDimension > & costs, AxesType & axes );
+
+  typedef MovingHistogramKernelCacheKey< ImageDimension > KernelCacheKey;
+  typedef MovingHistogramKernelCacheEntry< ImageDimension > KernelCacheEntry;
+  typedef KernelCache< KernelCacheKey, KernelCacheEntry > KernelCacheType;
+  typedef typename KernelCacheType::EntryType KernelCacheEntryObject;
+
+  /** The offsets of the active pixels of the kernel, used to fill the
+   * histograms. */
+  const OffsetListType & GetKernelOffsets() const
+    { return m_KernelEntry->GetValue().m_KernelOffsets; }
+
+  /** The offsets of the pixels added and removed by a translation, indexed
+   * with GetDirectionIndex(). */
+  const OffsetTableType & GetAddedOffsets() const
+    { return m_KernelEntry->GetValue().m_AddedOffsets; }
+  const OffsetTableType & GetRemovedOffsets() const
+    { return m_KernelEntry->GetValue().m_RemovedOffsets; }
+
+  /** Compute the offset tables and the best axes of the kernel. Throw an
+   * exception if the kernel is empty. */
+  void PreprocessKernel( const KernelType& kernel, KernelCacheEntry & entry ) const;
+
+  /** Choose the traversal axes with a cost model which takes the memory
+   * layout of the input into account. A translation reads the added and
+   * removed pixels in a number of distinct cache lines, which are new
+   * lines when the stride of the axis is large, and a short line makes the
+   * translation to the next line more expensive. */
+  void ChooseAxes( const OffsetValueType * offsetTable, const SizeType & regionSize );
+
+  /** Convert the offsets to offsets in a buffer with the given offset
+   * table. */
+  static void ComputeLinearOffsets( const OffsetTableType & offsets,
+                                    const OffsetValueType * offsetTable,
+                                    LinearOffsetTableType & linearTable );
+  static void ComputeLinearOffsets( const OffsetListType & offsets,
+                                    const OffsetValueType * offsetTable,
+                                    LinearOffsetListType & linearList );
+
+  /** Return the position of the lists of offsets of the translation
+   * in the given direction (-1 or 1) of the given axis in the offset
+   * tables. */
+  static unsigned int GetDirectionIndex( unsigned int axis, int direction )
+    { return 2 * axis + ( direction > 0 ); }
+
+  /** Same as above, for a translation of one pixel on one axis given as
+   * an offset. */
+  static unsigned int GetDirectionIndex( const OffsetType & offset )
+    {
+    for( unsigned int axis=0; axis<ImageDimension; axis++ )
+      {
+      if( offset[axis] != 0 )
+        { return GetDirectionIndex( axis, offset[axis] ); }
+      }
+    return 0;
+    }
+
   void GetDirAndOffset(const IndexType LineStart, 
                       const IndexType PrevLineStart,
                       const int ImageDimension,
@@ -150,17 +309,31 @@ protected:
                       OffsetType &Changes,
                       int &LineDirection);
 
-  // store the added and removed pixel offset in a list
-  OffsetMapType m_AddedOffsets;
-  OffsetMapType m_RemovedOffsets;
+  // the preprocessed kernel, shared with the cache: the offsets of the
+  // kernel and of the added and removed pixels
+  typename KernelCacheType::EntryConstPointer m_KernelEntry;
 
-  // store the offset of the kernel to initialize the histogram
-  OffsetListType m_KernelOffsets;
+  // the same offsets, as offsets in the input buffer. They depend on the
+  // input buffer size, so they are computed before each run
+  LinearOffsetTableType m_AddedLinearOffsets;
+  LinearOffsetTableType m_RemovedLinearOffsets;
 
-  typename itk::FixedArray< int, ImageDimension > m_Axes;
+  // the axes, sorted from the most expensive to the cheapest one to
+  // traverse. m_Axes[ImageDimension - 1] is the axis of the lines.
+  AxesType m_Axes;
 
   unsigned long m_PixelsPerTranslation;
 
+  // the number of pixels added by a translation along each axis
+  FixedArray< unsigned long, ImageDimension > m_TranslationCounts;
+
+  double m_PredictedCost;
+
+  // the maximum number of pixels in an histogram: the pixels of the kernel,
+  // plus the pixels added by a translation before the removed ones are
+  // removed. No bin can have a greater count.
+  unsigned long m_MaximumHistogramCount;
+
 
 private:
   MovingHistogramImageFilterBase(const Self&); //purposely not implemented
@@ -168,7 +341,7 @@ private:
 
   class DirectionCost {
     public :
-    DirectionCost( int dimension, int count )
+    DirectionCost( int dimension, double count )
       {
       m_Dimension = dimension;
       m_Count = count;
@@ -189,7 +362,7 @@ private:
       }
 
     int m_Dimension;
-    int m_Count;
+    double m_Count;
   };
 
 } ; // end of class
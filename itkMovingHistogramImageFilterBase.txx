@@ -22,6 +22,7 @@
 #include "itkOffset.h"
 #include "itkProgressReporter.h"
 #include "itkNumericTraits.h"
+#include <algorithm>
 
 #ifndef zigzag
 
@@ -38,7 +39,14 @@ template<class TInputImage, class TOutputImage, class TKernel>
 MovingHistogramImageFilterBase<TInputImage, TOutputImage, TKernel>
 ::MovingHistogramImageFilterBase()
 {
+  // an empty kernel until SetKernel() is called
+  m_KernelEntry = KernelCacheEntryObject::New();
   m_PixelsPerTranslation = 0;
+  m_MaximumHistogramCount = 0;
+  m_PredictedCost = 0;
+  m_TranslationCounts.Fill( 0 );
+  for( unsigned int i=0; i<ImageDimension; i++ )
+    { m_Axes[i] = ImageDimension - 1 - i; }
 }
 
 
@@ -46,6 +54,52 @@ template<class TInputImage, class TOutputImage, class TKernel>
 void
 MovingHistogramImageFilterBase<TInputImage, TOutputImage, TKernel>
 ::SetKernel( const KernelType& kernel )
+{
+  // the key of the kernel in the cache: its size and its active pixels
+  KernelCacheKey key;
+  key.m_Size = kernel.GetSize();
+  key.m_Active.reserve( kernel.Size() );
+  key.m_Hash = 0;
+  for( unsigned axis=0; axis<ImageDimension; axis++)
+    { key.m_Hash = key.m_Hash * 31 + key.m_Size[axis]; }
+  for( KernelIteratorType kernel_it = kernel.Begin(); kernel_it != kernel.End(); ++kernel_it )
+    {
+    const bool active = *kernel_it > 0;
+    key.m_Active.push_back( active );
+    key.m_Hash = key.m_Hash * 31 + active;
+    }
+
+  // the preprocessing is only done for the kernels not already in the
+  // cache. It throws an exception if the kernel is empty, so the filter
+  // is not modified in that case.
+  typename KernelCacheType::EntryConstPointer cached;
+  if( !KernelCacheType::Find( key, cached ) )
+    {
+    typename KernelCacheEntryObject::Pointer newEntry = KernelCacheEntryObject::New();
+    this->PreprocessKernel( kernel, newEntry->GetValue() );
+    KernelCacheType::Insert( key, newEntry );
+    cached = newEntry.GetPointer();
+    }
+
+  // store the kernel !!
+  Superclass::SetKernel( kernel );
+
+  // the offset lists are used from the shared entry; only the small
+  // values are copied, because they are updated before each run
+  m_KernelEntry = cached;
+  const KernelCacheEntry & entry = m_KernelEntry->GetValue();
+  m_TranslationCounts = entry.m_TranslationCounts;
+  m_MaximumHistogramCount = entry.m_MaximumHistogramCount;
+  m_Axes = entry.m_Axes;
+  m_PredictedCost = entry.m_PredictedCost;
+  m_PixelsPerTranslation = m_TranslationCounts[m_Axes[ImageDimension - 1]];
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel>
+void
+MovingHistogramImageFilterBase<TInputImage, TOutputImage, TKernel>
+::PreprocessKernel( const KernelType& kernel, KernelCacheEntry & entry ) const
 {
   // first, build the list of offsets of added and removed pixels when the 
   // structuring element move of 1 pixel on 1 axis; do it for the 2 directions
@@ -62,7 +116,9 @@ MovingHistogramImageFilterBase<TInputImage, TOutputImage, TKernel>
   kernelImageIt = ImageRegionIteratorWithIndex<BoolImageType>(tmpSEImage, tmpSEImageRegion);
   kernelImageIt.GoToBegin();
   KernelIteratorType kernel_it = kernel.Begin();
-  OffsetListType kernelOffsets;
+  OffsetListType & kernelOffsets = entry.m_KernelOffsets;
+  kernelOffsets.clear();
+  typename Functor::OffsetMemoryOrderCompare<ImageDimension> memoryOrder;
 
   // create a center index to compute the offset
   IndexType centerIndex;
@@ -76,7 +132,7 @@ MovingHistogramImageFilterBase<TInputImage, TOutputImage, TKernel>
     if( *kernel_it > 0 )
       {
       kernelImageIt.Set( true );
-      kernelOffsets.push_front( kernelImageIt.GetIndex() - centerIndex );
+      kernelOffsets.push_back( kernelImageIt.GetIndex() - centerIndex );
       count++;
       }
     else
@@ -90,20 +146,17 @@ MovingHistogramImageFilterBase<TInputImage, TOutputImage, TKernel>
   if( count == 0 )
     { itkExceptionMacro( << "The kernel must contain at least one point." ); }
 
-  // no attribute should be modified before here to avoid setting the filter in a bad status
-  // store the kernel !!
-  Superclass::SetKernel( kernel );
+  entry.m_AddedOffsets.clear();
+  entry.m_RemovedOffsets.clear();
+  entry.m_AddedOffsets.resize( 2 * ImageDimension );
+  entry.m_RemovedOffsets.resize( 2 * ImageDimension );
 
-  // clear the already stored values
-  m_AddedOffsets.clear();
-  m_RemovedOffsets.clear();
-  //m_Axes
-
-  // store the kernel offset list
-  m_KernelOffsets = kernelOffsets;
+  // sort the kernel offset list
+  std::sort( kernelOffsets.begin(), kernelOffsets.end(), memoryOrder );
 
   typename itk::FixedArray< unsigned long, ImageDimension > axisCount;
   axisCount.Fill( 0 );
+  unsigned long maximumAdded = 0;
 
   for( unsigned axis=0; axis<ImageDimension; axis++)
     {
@@ -112,6 +165,8 @@ MovingHistogramImageFilterBase<TInputImage, TOutputImage, TKernel>
     for( int direction=-1; direction<=1; direction +=2)
       {
       refOffset[axis] = direction;
+      OffsetListType & addedList = entry.m_AddedOffsets[ GetDirectionIndex( axis, direction ) ];
+      OffsetListType & removedList = entry.m_RemovedOffsets[ GetDirectionIndex( axis, direction ) ];
       for( kernelImageIt.GoToBegin(); !kernelImageIt.IsAtEnd(); ++kernelImageIt)
         {
         IndexType idx = kernelImageIt.GetIndex();
@@ -124,13 +179,13 @@ MovingHistogramImageFilterBase<TInputImage, TOutputImage, TKernel>
             {
             if( !tmpSEImage->GetPixel( nextIdx ) )
               {
-                m_AddedOffsets[refOffset].push_front( nextIdx - centerIndex );
+                addedList.push_back( nextIdx - centerIndex );
                 axisCount[axis]++;
               }
             }
           else
             {
-              m_AddedOffsets[refOffset].push_front( nextIdx - centerIndex );
+              addedList.push_back( nextIdx - centerIndex );
               axisCount[axis]++;
             }
           // search for removed pixel during a translation
@@ -139,36 +194,170 @@ MovingHistogramImageFilterBase<TInputImage, TOutputImage, TKernel>
             {
             if( !tmpSEImage->GetPixel( prevIdx ) )
               {
-                m_RemovedOffsets[refOffset].push_front( idx - centerIndex );
+                removedList.push_back( idx - centerIndex );
                 axisCount[axis]++;
               }
             }
           else
             {
-              m_RemovedOffsets[refOffset].push_front( idx - centerIndex );
+              removedList.push_back( idx - centerIndex );
               axisCount[axis]++;
             }
 
           }
         }
+      // sort the offsets in the memory order, for a better cache usage
+      std::sort( addedList.begin(), addedList.end(), memoryOrder );
+      std::sort( removedList.begin(), removedList.end(), memoryOrder );
+      maximumAdded = std::max( maximumAdded, (unsigned long)addedList.size() );
       }
     }
-    
-    // search for the best axis
-    typedef typename std::set<DirectionCost> MapCountType;
-    MapCountType invertedCount;
+
+    entry.m_MaximumHistogramCount = count + maximumAdded;
+
+    // divided by 2 because there is 2 directions on the axis
+    FixedArray< double, ImageDimension > costs;
     for( unsigned i=0; i<ImageDimension; i++ )
       {
-      invertedCount.insert( DirectionCost( i, axisCount[i] ) );
+      entry.m_TranslationCounts[i] = axisCount[i] / 2;
+      costs[i] = entry.m_TranslationCounts[i];
+      }
+
+    // search for the best axis. The memory layout of the input image is not
+    // known yet: the axes are sorted on the number of pixels per translation
+    // only, and sorted again in BeforeThreadedGenerateData()
+    SortAxes( costs, entry.m_Axes );
+    entry.m_PredictedCost = costs[entry.m_Axes[ImageDimension - 1]];
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel>
+void
+MovingHistogramImageFilterBase<TInputImage, TOutputImage, TKernel>
+::SortAxes( const FixedArray< double, ImageDimension > & costs, AxesType & axes )
+{
+  typedef typename std::set<DirectionCost> MapCountType;
+  MapCountType invertedCount;
+  for( unsigned i=0; i<ImageDimension; i++ )
+    {
+    invertedCount.insert( DirectionCost( i, costs[i] ) );
+    }
+
+  int i=0;
+  for( typename MapCountType::iterator it=invertedCount.begin(); it!=invertedCount.end(); it++, i++)
+    {
+    axes[i] = it->m_Dimension;
+    }
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel>
+void
+MovingHistogramImageFilterBase<TInputImage, TOutputImage, TKernel>
+::ChooseAxes( const OffsetValueType * offsetTable, const SizeType & regionSize )
+{
+  // rough costs, in number of histogram updates: reading a cache line not
+  // read at the previous position costs as much as a few updates
+  const OffsetValueType cacheLineSize = 64;
+  const double missCost = 4.0;
+
+  // cost of the translations along each axis, per pixel. The added and
+  // removed pixels are read in a set of cache lines. At the next position,
+  // those lines are moved by the stride of the axis: they are all new
+  // lines if the stride is as large as a cache line, and a fraction of
+  // them otherwise. The added pixels of a kernel often are contiguous in
+  // memory, so the lines are counted rather than the pixels.
+  FixedArray< double, ImageDimension > translationCosts;
+  for( unsigned int axis=0; axis<ImageDimension; axis++ )
+    {
+    const unsigned int d = GetDirectionIndex( axis, 1 );
+    LinearOffsetListType lines;
+    ComputeLinearOffsets( this->GetAddedOffsets()[d], offsetTable, lines );
+    LinearOffsetListType removedOffsets;
+    ComputeLinearOffsets( this->GetRemovedOffsets()[d], offsetTable, removedOffsets );
+    lines.insert( lines.end(), removedOffsets.begin(), removedOffsets.end() );
+    for( typename LinearOffsetListType::iterator it=lines.begin(); it!=lines.end(); it++ )
+      {
+      // floor of the division, for the offsets before the center
+      const OffsetValueType bytes = *it * static_cast< OffsetValueType >( sizeof( PixelType ) );
+      *it = bytes >= 0 ? bytes / cacheLineSize : -( ( cacheLineSize - 1 - bytes ) / cacheLineSize );
       }
+    std::sort( lines.begin(), lines.end() );
+    const unsigned long lineCount = std::unique( lines.begin(), lines.end() ) - lines.begin();
 
-    int i=0;
-    for( typename MapCountType::iterator it=invertedCount.begin(); it!=invertedCount.end(); it++, i++)
+    const double stride = offsetTable[axis] * static_cast< double >( sizeof( PixelType ) );
+    const double missRate = std::min( stride / cacheLineSize, 1.0 );
+    translationCosts[axis] = m_TranslationCounts[axis] + missCost * lineCount * missRate;
+    }
+
+  // The lines along an axis are walked with one translation per pixel.
+  // Moving to the next line costs one translation on the first other axis,
+  // which is shared by all the pixels of the line.
+  FixedArray< double, ImageDimension > costs;
+  for( unsigned int axis=0; axis<ImageDimension; axis++ )
+    {
+    costs[axis] = translationCosts[axis];
+    if( ImageDimension > 1 )
       {
-      m_Axes[i] = it->m_Dimension;
+      const unsigned int lineAxis = ( axis == 0 ) ? 1 : 0;
+      costs[axis] += translationCosts[lineAxis] / std::max( regionSize[axis], 1UL );
       }
+    }
+
+  SortAxes( costs, m_Axes );
+  m_PredictedCost = costs[m_Axes[ImageDimension - 1]];
+  m_PixelsPerTranslation = m_TranslationCounts[m_Axes[ImageDimension - 1]];
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel>
+void
+MovingHistogramImageFilterBase<TInputImage, TOutputImage, TKernel>
+::BeforeThreadedGenerateData()
+{
+  // the offset table of the input buffer is required to convert the index
+  // offsets to linear offsets
+  const OffsetValueType * offsetTable = this->GetInput()->GetOffsetTable();
+
+  // the memory layout of the input and the size of the output are now
+  // known: choose the traversal axes
+  this->ChooseAxes( offsetTable, this->GetOutput()->GetRequestedRegion().GetSize() );
+
+  ComputeLinearOffsets( this->GetAddedOffsets(), offsetTable, m_AddedLinearOffsets );
+  ComputeLinearOffsets( this->GetRemovedOffsets(), offsetTable, m_RemovedLinearOffsets );
+}
+
 
-    m_PixelsPerTranslation = axisCount[m_Axes[ImageDimension - 1]] / 2;  // divided by 2 because there is 2 directions on the axis
+template<class TInputImage, class TOutputImage, class TKernel>
+void
+MovingHistogramImageFilterBase<TInputImage, TOutputImage, TKernel>
+::ComputeLinearOffsets( const OffsetTableType & offsets,
+                        const OffsetValueType * offsetTable,
+                        LinearOffsetTableType & linearTable )
+{
+  linearTable.clear();
+  linearTable.resize( offsets.size() );
+  for( unsigned int d=0; d<offsets.size(); d++ )
+    { ComputeLinearOffsets( offsets[d], offsetTable, linearTable[d] ); }
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel>
+void
+MovingHistogramImageFilterBase<TInputImage, TOutputImage, TKernel>
+::ComputeLinearOffsets( const OffsetListType & offsets,
+                        const OffsetValueType * offsetTable,
+                        LinearOffsetListType & linearList )
+{
+  linearList.clear();
+  linearList.reserve( offsets.size() );
+  for( typename OffsetListType::const_iterator listIt = offsets.begin(); listIt != offsets.end(); listIt++ )
+    {
+    OffsetValueType linearOffset = 0;
+    for( unsigned axis=0; axis<ImageDimension; axis++ )
+      { linearOffset += (*listIt)[axis] * offsetTable[axis]; }
+    linearList.push_back( linearOffset );
+    }
 }
 
 
@@ -200,5 +389,19 @@ MovingHistogramImageFilterBase<TInputImage, TOutputImage, TKernel>
     }
 }
 
+
+template<class TInputImage, class TOutputImage, class TKernel>
+void
+MovingHistogramImageFilterBase<TInputImage, TOutputImage, TKernel>
+::PrintSelf(std::ostream &os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "PixelsPerTranslation: " << m_PixelsPerTranslation << std::endl;
+  os << indent << "Axes: " << m_Axes << std::endl;
+  os << indent << "BestAxis: " << m_Axes[ImageDimension - 1] << std::endl;
+  os << indent << "PredictedCost: " << m_PredictedCost << std::endl;
+}
+
 }// end namespace itk
 #endif
@@ -0,0 +1,167 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkMovingHistogramMinMaxGradientImageFilter.h,v $
+  Language:  C++
+  Date:      $Date: 2006/04/20 12:00:00 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even 
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR 
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkMovingHistogramMinMaxGradientImageFilter_h
+#define __itkMovingHistogramMinMaxGradientImageFilter_h
+
+#include "itkMovingHistogramMorphologicalGradientImageFilter.h"
+
+namespace itk {
+
+/**
+ * \class MovingHistogramMinMaxGradientImageFilter
+ * \brief Compute the erosion, the dilation and the morphological gradient in a single pass
+ *
+ * The histogram of the neighborhood is moved only once over the image,
+ * and the lowest value, the highest value and their difference are
+ * written in three outputs: the erosion (output 0), the dilation
+ * (output 1) and the morphological gradient (output 2). As the update of
+ * the histogram is the expensive part of the moving histogram filters,
+ * this filter is about three times faster than running
+ * MovingHistogramErodeImageFilter, MovingHistogramDilateImageFilter and
+ * MovingHistogramMorphologicalGradientImageFilter on the same image.
+ *
+ * The pixels outside the image are ignored, which is the same as using
+ * the default boundary values of the erosion and of the dilation.
+ *
+ * \sa MovingHistogramErodeImageFilter, MovingHistogramDilateImageFilter,
+ * \sa MovingHistogramMorphologicalGradientImageFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+
+template<class TInputImage, class TOutputImage, class TKernel>
+class ITK_EXPORT MovingHistogramMinMaxGradientImageFilter : 
+    public MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel,
+      typename  Function::MorphologicalGradientHistogram< typename TInputImage::PixelType > >
+{
+public:
+  /** Standard class typedefs. */
+  typedef MovingHistogramMinMaxGradientImageFilter Self;
+  typedef MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel,
+      typename  Function::MorphologicalGradientHistogram< typename TInputImage::PixelType > >  Superclass;
+  typedef SmartPointer<Self>        Pointer;
+  typedef SmartPointer<const Self>  ConstPointer;
+  
+  /** Standard New method. */
+  itkNewMacro(Self);  
+
+  /** Runtime information support. */
+  itkTypeMacro(MovingHistogramMinMaxGradientImageFilter, 
+               MovingHistogramImageFilter);
+  
+  /** Image related typedefs. */
+  typedef TInputImage InputImageType;
+  typedef TOutputImage OutputImageType;
+  typedef typename TInputImage::RegionType RegionType ;
+  typedef typename TInputImage::SizeType SizeType ;
+  typedef typename TInputImage::IndexType IndexType ;
+  typedef typename TInputImage::PixelType PixelType ;
+  typedef typename TInputImage::OffsetType OffsetType ;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+  typedef typename TOutputImage::PixelType OutputPixelType ;
+  typedef typename Superclass::OffsetValueType OffsetValueType;
+
+  typedef typename Function::MorphologicalGradientHistogram< PixelType > HistogramType;
+
+  /** Image related typedefs. */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TInputImage::ImageDimension);
+
+  /** The erosion of the input image */
+  OutputImageType * GetMinimumOutput()
+    { return this->GetOutput( 0 ); }
+
+  /** The dilation of the input image */
+  OutputImageType * GetMaximumOutput()
+    { return this->GetOutput( 1 ); }
+
+  /** The morphological gradient of the input image */
+  OutputImageType * GetGradientOutput()
+    { return this->GetOutput( 2 ); }
+
+  /** Return true if the vector based algorithm is used, and
+   * false if the map based algorithm is used */
+  static bool GetUseVectorBasedAlgorithm()
+    { return HistogramType::useVectorBasedAlgorithm(); }
+
+protected:
+  MovingHistogramMinMaxGradientImageFilter();
+  ~MovingHistogramMinMaxGradientImageFilter() {};
+
+  /** Multi-thread version GenerateData. */
+  void  ThreadedGenerateData (const OutputImageRegionType& 
+                              outputRegionForThread,
+                              int threadId) ;
+
+  /** needed to pass the maximum count of the bins to the histogram object */
+  virtual HistogramType * NewHistogram( int threadId );
+
+  /** write the minimum, the maximum and their difference in the three
+   * outputs */
+  class MinMaxGradientWriter
+    {
+    public:
+    MinMaxGradientWriter( OutputImageType * minimum, OutputImageType * maximum, OutputImageType * gradient )
+      {
+      m_Outputs[0] = minimum;
+      m_Outputs[1] = maximum;
+      m_Outputs[2] = gradient;
+      m_Stride = 0;
+      }
+
+    inline void StartLine( const IndexType & idx, unsigned int direction )
+      {
+      // the three outputs have the same buffered region
+      const OffsetValueType offset = m_Outputs[0]->ComputeOffset( idx );
+      for( unsigned int i=0; i<3; i++ )
+        { m_Pointers[i] = m_Outputs[i]->GetBufferPointer() + offset; }
+      m_Stride = m_Outputs[0]->GetOffsetTable()[ direction ];
+      }
+
+    inline void Write( HistogramType * histogram, const PixelType & )
+      {
+      const PixelType minimum = histogram->GetMinimum();
+      const PixelType maximum = histogram->GetMaximum();
+      *m_Pointers[0] = static_cast< OutputPixelType >( minimum );
+      *m_Pointers[1] = static_cast< OutputPixelType >( maximum );
+      // the histogram is empty if the kernel is fully outside the image
+      if( maximum >= minimum )
+        { *m_Pointers[2] = static_cast< OutputPixelType >( maximum - minimum ); }
+      else
+        { *m_Pointers[2] = NumericTraits< OutputPixelType >::Zero; }
+      for( unsigned int i=0; i<3; i++ )
+        { m_Pointers[i] += m_Stride; }
+      }
+
+    private:
+    OutputImageType * m_Outputs[3];
+    OutputPixelType * m_Pointers[3];
+    OffsetValueType m_Stride;
+    };
+
+private:
+  MovingHistogramMinMaxGradientImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+} ; // end of class
+
+} // end namespace itk
+  
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkMovingHistogramMinMaxGradientImageFilter.txx"
+#endif
+
+#endif
@@ -0,0 +1,60 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkMovingHistogramMinMaxGradientImageFilter.txx,v $
+  Language:  C++
+  Date:      $Date: 2006/04/20 12:00:00 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even 
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR 
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkMovingHistogramMinMaxGradientImageFilter_txx
+#define __itkMovingHistogramMinMaxGradientImageFilter_txx
+
+#include "itkMovingHistogramMinMaxGradientImageFilter.h"
+
+
+namespace itk {
+
+
+template<class TInputImage, class TOutputImage, class TKernel>
+MovingHistogramMinMaxGradientImageFilter<TInputImage, TOutputImage, TKernel>
+::MovingHistogramMinMaxGradientImageFilter()
+{
+  // the erosion is the output 0, the dilation the output 1 and the
+  // gradient the output 2
+  this->SetNumberOfRequiredOutputs( 3 );
+  this->SetNthOutput( 1, this->MakeOutput( 1 ) );
+  this->SetNthOutput( 2, this->MakeOutput( 2 ) );
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel>
+typename MovingHistogramMinMaxGradientImageFilter<TInputImage, TOutputImage, TKernel>::HistogramType *
+MovingHistogramMinMaxGradientImageFilter<TInputImage, TOutputImage, TKernel>
+::NewHistogram( int threadId )
+{
+  HistogramType * histogram = Superclass::NewHistogram( threadId );
+  histogram->SetMaximumCount( this->m_MaximumHistogramCount );
+  return histogram;
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel>
+void
+MovingHistogramMinMaxGradientImageFilter<TInputImage, TOutputImage, TKernel>
+::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                       int threadId) 
+{
+  MinMaxGradientWriter writer( this->GetMinimumOutput(), this->GetMaximumOutput(), this->GetGradientOutput() );
+  this->ThreadedGenerateDataWithWriter( outputRegionForThread, threadId, writer );
+}
+
+}// end namespace itk
+#endif
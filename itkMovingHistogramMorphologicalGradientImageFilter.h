@@ -19,152 +19,247 @@
 
 #include "itkMovingHistogramImageFilter.h"
 #include <map>
+#include "itkHistogramOccupancyBitmap.h"
+#include "itkHistogramChangedBlocks.h"
+#include "itkHistogramCounterArray.h"
 
 namespace itk {
 
 namespace Function {
+
+/** \class MorphologicalGradientMapHistogram
+ * \brief map based histogram, usable with any pixel type
+ */
 template <class TInputPixel>
-class MorphologicalGradientHistogram
+class MorphologicalGradientMapHistogram
 {
 public:
-  MorphologicalGradientHistogram()
-    {
-    if( useVectorBasedAlgorithm() )
-      { initVector(); }
-    }
-  ~MorphologicalGradientHistogram(){}
+  MorphologicalGradientMapHistogram() {}
+  ~MorphologicalGradientMapHistogram(){}
 
-  MorphologicalGradientHistogram * Clone()
-    {
-    MorphologicalGradientHistogram * result = new MorphologicalGradientHistogram();
-    result->m_Map = this->m_Map;
-    result->m_Vector = this->m_Vector;
-    result->m_Min = this->m_Min;
-    result->m_Max = this->m_Max;
-    result->m_Count = this->m_Count;
-    return result;
-    }
+  MorphologicalGradientMapHistogram * Clone()
+    { return new MorphologicalGradientMapHistogram( *this ); }
+
+  typedef typename std::map< TInputPixel, unsigned long > MapType;
 
   inline void AddBoundary() {}
 
   inline void RemoveBoundary() {}
 
   inline void AddPixel( const TInputPixel &p )
-    {
-    if( useVectorBasedAlgorithm() )
-      { AddPixelVector( p ); }
-    else
-      { AddPixelMap( p ); }
-    }
+    { m_Map[ p ]++; }
 
   inline void RemovePixel( const TInputPixel &p )
-    {
-    if( useVectorBasedAlgorithm() )
-      { RemovePixelVector( p ); }
-    else
-      { RemovePixelMap( p ); }
-    }
+    { m_Map[ p ]--; }
 
   inline TInputPixel GetValue( const TInputPixel & )
     {
-    if( useVectorBasedAlgorithm() )
-      { return GetValueVector(); }
-    else
-      { return GetValueMap(); }
+    // the extrema are the ends of the map. Only the empty values at the
+    // ends are removed, as in MorphologyMapHistogram: the ones in the
+    // middle of the map are removed when they reach one of its ends.
+    const TInputPixel maximum = this->GetMaximum();
+    if( m_Map.empty() )
+      { return NumericTraits< TInputPixel >::Zero; }
+    return maximum - this->GetMinimum();
     }
 
+  /** the lowest value in the histogram, or the highest value of the pixel
+   * type if the histogram is empty */
+  inline TInputPixel GetMinimum()
+    {
+    // only clean the beginning of the map
+    while( !m_Map.empty() && m_Map.begin()->second == 0 )
+      { m_Map.erase( m_Map.begin() ); }
+    if( !m_Map.empty() )
+      { return m_Map.begin()->first; }
+    return NumericTraits< TInputPixel >::max();
+    }
 
-  static inline bool useVectorBasedAlgorithm()
+  /** the highest value in the histogram, or the lowest value of the pixel
+   * type if the histogram is empty */
+  inline TInputPixel GetMaximum()
     {
-    // bool, short and char are acceptable for vector based algorithm: they do not require
-    // too much memory. Other types are not usable with that algorithm
-    return typeid(TInputPixel) == typeid(unsigned char)
-        || typeid(TInputPixel) == typeid(signed char)
-        || typeid(TInputPixel) == typeid(unsigned short)
-        || typeid(TInputPixel) == typeid(signed short)
-        || typeid(TInputPixel) == typeid(bool);
+    // only clean the end of the map
+    while( !m_Map.empty() && m_Map.rbegin()->second == 0 )
+      {
+      typename MapType::iterator last = m_Map.end();
+      --last;
+      m_Map.erase( last );
+      }
+    if( !m_Map.empty() )
+      { return m_Map.rbegin()->first; }
+    return NumericTraits< TInputPixel >::NonpositiveMin();
     }
 
+  static inline bool useVectorBasedAlgorithm()
+    { return false; }
 
+  // the map is small compared to the number of values added and removed
+  // along a line, so it is simply copied
+  inline void RestoreFrom( const MorphologicalGradientMapHistogram & reference )
+    { m_Map = reference.m_Map; }
 
+  inline void MergeChanges( const MorphologicalGradientMapHistogram & ) {}
 
+  /** Empty the histogram. */
+  inline void Reset()
+    { m_Map.clear(); }
 
+  // the counters of the map are not stored in a fixed size array
+  inline void SetMaximumCount( unsigned long ) {}
 
+  static inline unsigned long GetCountLimit()
+    { return NumericTraits< unsigned long >::max(); }
 
-  //
-  // the map based algorithm
-  //
+  inline void AddHistogram( const MorphologicalGradientMapHistogram & other )
+    {
+    for( typename MapType::const_iterator it=other.m_Map.begin(); it!=other.m_Map.end(); it++ )
+      { m_Map[ it->first ] += it->second; }
+    }
 
-  typedef typename std::map< TInputPixel, unsigned long > MapType;
+  inline void SubtractHistogram( const MorphologicalGradientMapHistogram & other )
+    {
+    for( typename MapType::const_iterator it=other.m_Map.begin(); it!=other.m_Map.end(); it++ )
+      { m_Map[ it->first ] -= it->second; }
+    }
 
-  inline void AddPixelMap( const TInputPixel &p )
-    { m_Map[ p ]++; }
+  MapType m_Map;
+};
 
-  inline void RemovePixelMap( const TInputPixel &p )
-    { m_Map[ p ]--; }
 
-  inline TInputPixel GetValueMap()
+/** \class MorphologicalGradientVectorHistogram
+ * \brief vector based histogram, for the pixel types with a small
+ * number of values (8 bits and bool)
+ */
+template <class TInputPixel, class TCounter = unsigned int>
+class MorphologicalGradientVectorHistogram
+{
+public:
+  MorphologicalGradientVectorHistogram()
+    {
+    m_Vector.Initialize( static_cast<int>( NumericTraits< TInputPixel >::max() - NumericTraits< TInputPixel >::NonpositiveMin() + 1 ) );
+    m_Max = NumericTraits< TInputPixel >::NonpositiveMin();
+    m_Min = NumericTraits< TInputPixel >::max();
+    m_Count = 0;
+    m_Changes.Initialize( m_Vector.size() );
+    }
+  ~MorphologicalGradientVectorHistogram(){}
+
+  MorphologicalGradientVectorHistogram * Clone()
+    { return new MorphologicalGradientVectorHistogram( *this ); }
+
+  inline void AddBoundary() {}
+
+  inline void RemoveBoundary() {}
+
+  inline void AddPixel( const TInputPixel &p )
+    {
+    m_Changes.Set( static_cast<int>( p - NumericTraits< TInputPixel >::NonpositiveMin() ) );
+    m_Vector.Increment( static_cast<int>( p - NumericTraits< TInputPixel >::NonpositiveMin() ) );
+    if( p > m_Max )
+      { m_Max = p; }
+    if( p < m_Min )
+      { m_Min = p; }
+    m_Count++;
+    }
+
+  inline void RemovePixel( const TInputPixel &p )
     {
-    // clean the map
-    typename MapType::iterator mapIt = m_Map.begin();
-    while( mapIt != m_Map.end() )
+    m_Changes.Set( static_cast<int>( p - NumericTraits< TInputPixel >::NonpositiveMin() ) );
+    m_Count--;
+    // the extrema are searched only when the bin of one of them is now
+    // empty
+    if( m_Vector.Decrement( static_cast<int>( p - NumericTraits< TInputPixel >::NonpositiveMin() ) ) != 0 )
+      { return; }
+    if( m_Count > 0 )
       {
-      if( mapIt->second == 0 )
-        { 
-        // this value must be removed from the histogram
-        // The value must be stored and the iterator updated before removing the value
-        // or the iterator is invalidated.
-        TInputPixel toErase = mapIt->first;
-        mapIt++;
-        m_Map.erase(toErase);
+      if( p == m_Max )
+        {
+        while( m_Vector[ static_cast<int>( m_Max - NumericTraits< TInputPixel >::NonpositiveMin() ) ] == 0 )
+          { m_Max--; }
         }
-      else
+      if( p == m_Min )
         {
-        mapIt++;
+        while( m_Vector[ static_cast<int>( m_Min - NumericTraits< TInputPixel >::NonpositiveMin() ) ] == 0 )
+          { m_Min++; }
         }
       }
-
-    // and return the value
-    if( !m_Map.empty() )
-      { return m_Map.rbegin()->first - m_Map.begin()->first; }
-    return 0;
+    else
+      {
+      m_Max = NumericTraits< TInputPixel >::NonpositiveMin();
+      m_Min = NumericTraits< TInputPixel >::max();
+      }
     }
 
-  MapType m_Map;
-
-
+  inline TInputPixel GetValue( const TInputPixel & )
+    {
+    if( m_Count > 0 )
+      { return m_Max - m_Min; }
+    else
+      { return NumericTraits< TInputPixel >::Zero; }
+    }
 
+  /** the lowest value in the histogram, or the highest value of the pixel
+   * type if the histogram is empty */
+  inline TInputPixel GetMinimum()
+    { return m_Min; }
 
+  /** the highest value in the histogram, or the lowest value of the pixel
+   * type if the histogram is empty */
+  inline TInputPixel GetMaximum()
+    { return m_Max; }
 
+  static inline bool useVectorBasedAlgorithm()
+    { return true; }
 
+  // only the blocks of bins changed since the histogram was identical to
+  // the reference are copied
+  inline void RestoreFrom( const MorphologicalGradientVectorHistogram & reference )
+    {
+    m_Vector.CopyBlocks( reference.m_Vector, m_Changes );
+    m_Min = reference.m_Min;
+    m_Max = reference.m_Max;
+    m_Count = reference.m_Count;
+    m_Changes.Clear();
+    }
 
-  //
-  // the vector based algorithm
-  //
+  inline void MergeChanges( const MorphologicalGradientVectorHistogram & other )
+    { m_Changes.Merge( other.m_Changes ); }
 
-  inline void initVector()
+  /** Empty the histogram. The vector is small: it is fully cleared. */
+  inline void Reset()
     {
-    // initialize members need for the vector based algorithm
-    m_Vector.resize( static_cast<int>( NumericTraits< TInputPixel >::max() - NumericTraits< TInputPixel >::NonpositiveMin() + 1 ), 0 );
+    m_Vector.Clear();
+    m_Changes.Clear();
     m_Max = NumericTraits< TInputPixel >::NonpositiveMin();
     m_Min = NumericTraits< TInputPixel >::max();
     m_Count = 0;
     }
 
-  inline void AddPixelVector( const TInputPixel &p )
+  // the width of the counters is fixed at compile time: the filter checks
+  // the kernel against GetCountLimit() before running
+  inline void SetMaximumCount( unsigned long ) {}
+
+  static inline unsigned long GetCountLimit()
+    { return HistogramCounterArray< TCounter >::GetCountLimit(); }
+
+  inline void AddHistogram( const MorphologicalGradientVectorHistogram & other )
     {
-    m_Vector[ static_cast<int>( p - NumericTraits< TInputPixel >::NonpositiveMin() ) ]++;
-    if( p > m_Max )
-      { m_Max = p; }
-    if( p < m_Min )
-      { m_Min = p; }
-    m_Count++;
+    m_Vector.Add( other.m_Vector );
+    m_Changes.SetAll();
+    m_Count += other.m_Count;
+    // the extrema of an empty histogram are never selected
+    if( other.m_Max > m_Max )
+      { m_Max = other.m_Max; }
+    if( other.m_Min < m_Min )
+      { m_Min = other.m_Min; }
     }
 
-  inline void RemovePixelVector( const TInputPixel &p )
+  inline void SubtractHistogram( const MorphologicalGradientVectorHistogram & other )
     {
-    m_Vector[ static_cast<int>( p - NumericTraits< TInputPixel >::NonpositiveMin() ) ]--;
-    m_Count--;
+    m_Vector.Subtract( other.m_Vector );
+    m_Changes.SetAll();
+    m_Count -= other.m_Count;
     if( m_Count > 0 )
       {
       while( m_Vector[ static_cast<int>( m_Max - NumericTraits< TInputPixel >::NonpositiveMin() ) ] == 0 )
@@ -179,23 +274,244 @@ public:
       }
     }
 
-  inline TInputPixel GetValueVector()
+  HistogramCounterArray< TCounter > m_Vector;
+  HistogramChangedBlocks m_Changes;
+  TInputPixel m_Min;
+  TInputPixel m_Max;
+  unsigned long m_Count;
+};
+
+
+/** \class MorphologicalGradientBitmapHistogram
+ * \brief vector based histogram with a hierarchical occupancy bitmap
+ *
+ * The 16 bits version of MorphologicalGradientVectorHistogram. The non
+ * empty bins are kept in a HistogramOccupancyBitmap, so a new extremum
+ * is found with a few bit scans instead of a linear scan of the empty
+ * bins when the bin of the current one becomes empty.
+ */
+template <class TInputPixel, class TCounter = unsigned int>
+class MorphologicalGradientBitmapHistogram
+{
+public:
+  MorphologicalGradientBitmapHistogram()
     {
-    if( m_Count > 0 )
-      { return m_Max - m_Min; }
-    else
+    m_Vector.Initialize( static_cast<int>( NumericTraits< TInputPixel >::max() - NumericTraits< TInputPixel >::NonpositiveMin() + 1 ) );
+    m_Bitmap.Initialize( m_Vector.size() );
+    m_Changes.Initialize( m_Vector.size() );
+    m_Max = NumericTraits< TInputPixel >::NonpositiveMin();
+    m_Min = NumericTraits< TInputPixel >::max();
+    }
+  ~MorphologicalGradientBitmapHistogram(){}
+
+  MorphologicalGradientBitmapHistogram * Clone()
+    { return new MorphologicalGradientBitmapHistogram( *this ); }
+
+  inline void AddBoundary() {}
+
+  inline void RemoveBoundary() {}
+
+  inline void AddPixel( const TInputPixel &p )
+    {
+    const unsigned long bin = static_cast<unsigned long>( p - NumericTraits< TInputPixel >::NonpositiveMin() );
+    m_Changes.Set( bin );
+    if( m_Vector.Increment( bin ) == 1 )
+      { m_Bitmap.Set( bin ); }
+    if( p > m_Max )
+      { m_Max = p; }
+    if( p < m_Min )
+      { m_Min = p; }
+    }
+
+  inline void RemovePixel( const TInputPixel &p )
+    {
+    const unsigned long bin = static_cast<unsigned long>( p - NumericTraits< TInputPixel >::NonpositiveMin() );
+    m_Changes.Set( bin );
+    if( m_Vector.Decrement( bin ) == 0 )
+      {
+      m_Bitmap.Clear( bin );
+      if( p == m_Max || p == m_Min )
+        { this->UpdateExtrema(); }
+      }
+    }
+
+  inline TInputPixel GetValue( const TInputPixel & )
+    {
+    if( m_Bitmap.IsEmpty() )
       { return NumericTraits< TInputPixel >::Zero; }
+    return m_Max - m_Min;
+    }
+
+  /** the lowest value in the histogram, or the highest value of the pixel
+   * type if the histogram is empty */
+  inline TInputPixel GetMinimum()
+    { return m_Min; }
+
+  /** the highest value in the histogram, or the lowest value of the pixel
+   * type if the histogram is empty */
+  inline TInputPixel GetMaximum()
+    { return m_Max; }
+
+  static inline bool useVectorBasedAlgorithm()
+    { return true; }
+
+  // only the blocks of bins changed since the histogram was identical to
+  // the reference are copied
+  inline void RestoreFrom( const MorphologicalGradientBitmapHistogram & reference )
+    {
+    m_Vector.CopyBlocks( reference.m_Vector, m_Changes );
+    m_Changes.CopyBitmap( reference.m_Bitmap, m_Bitmap );
+    m_Min = reference.m_Min;
+    m_Max = reference.m_Max;
+    m_Changes.Clear();
+    }
+
+  inline void MergeChanges( const MorphologicalGradientBitmapHistogram & other )
+    { m_Changes.Merge( other.m_Changes ); }
+
+  /** Empty the histogram. Only the non empty bins are cleared. */
+  inline void Reset()
+    {
+    while( !m_Bitmap.IsEmpty() )
+      {
+      const unsigned long bin = m_Bitmap.First();
+      m_Vector.ClearBin( bin );
+      m_Bitmap.Clear( bin );
+      }
+    m_Changes.Clear();
+    this->UpdateExtrema();
+    }
+
+  // the width of the counters is fixed at compile time: the filter checks
+  // the kernel against GetCountLimit() before running
+  inline void SetMaximumCount( unsigned long ) {}
+
+  static inline unsigned long GetCountLimit()
+    { return HistogramCounterArray< TCounter >::GetCountLimit(); }
+
+  // only the non empty bins of other are visited, so the cost depends on
+  // the number of distinct values in other, not on the number of bins
+  inline void AddHistogram( const MorphologicalGradientBitmapHistogram & other )
+    {
+    unsigned long bin = 0;
+    if( !other.m_Bitmap.IsEmpty() )
+      {
+      bin = other.m_Bitmap.First();
+      do
+        {
+        m_Changes.Set( bin );
+        if( m_Vector.AddToBin( bin, other.m_Vector[ bin ] ) == other.m_Vector[ bin ] )
+          { m_Bitmap.Set( bin ); }
+        }
+      while( other.m_Bitmap.Next( bin ) );
+      }
+    this->UpdateExtrema();
+    }
+
+  inline void SubtractHistogram( const MorphologicalGradientBitmapHistogram & other )
+    {
+    unsigned long bin = 0;
+    if( !other.m_Bitmap.IsEmpty() )
+      {
+      bin = other.m_Bitmap.First();
+      do
+        {
+        m_Changes.Set( bin );
+        if( m_Vector.SubtractFromBin( bin, other.m_Vector[ bin ] ) == 0 )
+          { m_Bitmap.Clear( bin ); }
+        }
+      while( other.m_Bitmap.Next( bin ) );
+      }
+    this->UpdateExtrema();
     }
 
-  std::vector<unsigned long> m_Vector;
+  HistogramCounterArray< TCounter > m_Vector;
+  HistogramOccupancyBitmap m_Bitmap;
+  HistogramChangedBlocks m_Changes;
   TInputPixel m_Min;
   TInputPixel m_Max;
-  unsigned long m_Count;
+
+private:
+  inline void UpdateExtrema()
+    {
+    if( m_Bitmap.IsEmpty() )
+      {
+      m_Max = NumericTraits< TInputPixel >::NonpositiveMin();
+      m_Min = NumericTraits< TInputPixel >::max();
+      }
+    else
+      {
+      m_Max = static_cast< TInputPixel >( NumericTraits< TInputPixel >::NonpositiveMin() + m_Bitmap.Last() );
+      m_Min = static_cast< TInputPixel >( NumericTraits< TInputPixel >::NonpositiveMin() + m_Bitmap.First() );
+      }
+    }
+};
 
 
+/** \class MorphologicalGradientHistogramTraits
+ * \brief select the histogram implementation for a pixel type at compile time
+ *
+ * The map based histogram is used by default, the vector based one for
+ * the 8 bits types and bool, and the bitmap based one for the 16 bits
+ * types.
+ */
+template <class TInputPixel>
+struct MorphologicalGradientHistogramTraits
+{
+  typedef MorphologicalGradientMapHistogram< TInputPixel > HistogramType;
+};
 
+template <>
+struct MorphologicalGradientHistogramTraits< bool >
+{
+  typedef MorphologicalGradientVectorHistogram< bool > HistogramType;
+};
 
+template <>
+struct MorphologicalGradientHistogramTraits< char >
+{
+  typedef MorphologicalGradientVectorHistogram< char > HistogramType;
 };
+
+template <>
+struct MorphologicalGradientHistogramTraits< unsigned char >
+{
+  typedef MorphologicalGradientVectorHistogram< unsigned char > HistogramType;
+};
+
+template <>
+struct MorphologicalGradientHistogramTraits< signed char >
+{
+  typedef MorphologicalGradientVectorHistogram< signed char > HistogramType;
+};
+
+template <>
+struct MorphologicalGradientHistogramTraits< unsigned short >
+{
+  typedef MorphologicalGradientBitmapHistogram< unsigned short > HistogramType;
+};
+
+template <>
+struct MorphologicalGradientHistogramTraits< signed short >
+{
+  typedef MorphologicalGradientBitmapHistogram< signed short > HistogramType;
+};
+
+
+/** \class MorphologicalGradientHistogram
+ * \brief the histogram used by the moving histogram morphological gradient
+ *
+ * The implementation is selected by MorphologicalGradientHistogramTraits.
+ */
+template <class TInputPixel>
+class MorphologicalGradientHistogram :
+    public MorphologicalGradientHistogramTraits< TInputPixel >::HistogramType
+{
+public:
+  MorphologicalGradientHistogram * Clone()
+    { return new MorphologicalGradientHistogram( *this ); }
+};
+
 } // end namespace Function
 
 /**
@@ -260,6 +576,14 @@ protected:
   MovingHistogramMorphologicalGradientImageFilter() {};
   ~MovingHistogramMorphologicalGradientImageFilter() {};
 
+  /** needed to pass the maximum count of the bins to the histogram object */
+  virtual HistogramType * NewHistogram( int threadId )
+    {
+    HistogramType * histogram = Superclass::NewHistogram( threadId );
+    histogram->SetMaximumCount( this->m_MaximumHistogramCount );
+    return histogram;
+    }
+
 
 private:
   MovingHistogramMorphologicalGradientImageFilter(const Self&); //purposely not implemented
@@ -18,112 +18,49 @@
 #define __itkMovingHistogramMorphologyImageFilter_h
 
 #include "itkMovingHistogramImageFilter.h"
-#include <list>
 #include <map>
-#include "itkOffsetLexicographicCompare.h"
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include "itkHistogramOccupancyBitmap.h"
+#include "itkHistogramChangedBlocks.h"
+#include "itkHistogramCounterArray.h"
 
 namespace itk {
 
 namespace Function {
+
+/** \class MorphologyMapHistogram
+ * \brief map based histogram, usable with any pixel type
+ */
 template <class TInputPixel, class TCompare>
-class MorphologyHistogram
+class MorphologyMapHistogram
 {
 public:
-  MorphologyHistogram()
+  MorphologyMapHistogram()
     {
-    if( useVectorBasedAlgorithm() )
-      { initVector(); }
+    m_BoundaryCount = 0;
     }
-  ~MorphologyHistogram(){}
+  ~MorphologyMapHistogram(){}
 
-  MorphologyHistogram * Clone()
-    {
-    MorphologyHistogram * result = new MorphologyHistogram();
-    result->m_Map = this->m_Map;
-    result->m_Vector = this->m_Vector;
-    result->m_CurrentValue = this->m_CurrentValue;
-    result->m_Compare = this->m_Compare;
-    result->m_Direction = this->m_Direction;
-    result->m_Boundary = this->m_Boundary;
-    return result;
-    }
-
-  // define the method required by the functor and dispatch to the specialized methods
+  MorphologyMapHistogram * Clone()
+    { return new MorphologyMapHistogram( *this ); }
 
+  typedef typename std::map< TInputPixel, unsigned long, TCompare > MapType;
 
   inline void AddBoundary()
-    {
-    if( useVectorBasedAlgorithm() )
-      { AddBoundaryVector(); }
-    else
-      { AddBoundaryMap(); }
-    }
+    { m_BoundaryCount++; }
 
   inline void RemoveBoundary()
-    {
-    if( useVectorBasedAlgorithm() )
-      { RemoveBoundaryVector(); }
-    else
-      { RemoveBoundaryMap(); }
-    }
+    { m_BoundaryCount--; }
 
   inline void AddPixel( const TInputPixel &p )
-    {
-    if( useVectorBasedAlgorithm() )
-      { AddPixelVector( p ); }
-    else
-      { AddPixelMap( p ); }
-    }
-
-  inline void RemovePixel( const TInputPixel &p )
-    {
-    if( useVectorBasedAlgorithm() )
-      { RemovePixelVector( p ); }
-    else
-      { RemovePixelMap( p ); }
-    }
-
-  inline TInputPixel GetValue( const TInputPixel & )
-    {
-    if( useVectorBasedAlgorithm() )
-      { return GetValueVector(); }
-    else
-      { return GetValueMap(); }
-    }
-
-
-  inline static bool useVectorBasedAlgorithm()
-    {
-    // bool, short and char are acceptable for vector based algorithm: they do not require
-    // too much memory. Other types are not usable with that algorithm
-    return typeid(TInputPixel) == typeid(unsigned char)
-        || typeid(TInputPixel) == typeid(signed char)
-        || typeid(TInputPixel) == typeid(unsigned short)
-        || typeid(TInputPixel) == typeid(signed short)
-        || typeid(TInputPixel) == typeid(bool);
-    }
-
-
-
-  //
-  // the map based algorithm
-  //
-
-  typedef typename std::map< TInputPixel, unsigned long, TCompare > MapType;
-
-  inline void AddBoundaryMap()
-    { m_Map[ m_Boundary ]++; }
-
-  inline void RemoveBoundaryMap()
-    { m_Map[ m_Boundary ]--; }
-
-  inline void AddPixelMap( const TInputPixel &p )
     { m_Map[ p ]++; }
 
-  inline void RemovePixelMap( const TInputPixel &p )
+  inline void RemovePixel( const TInputPixel &p )
     { m_Map[ p ]--; }
 
-  inline TInputPixel GetValueMap()
+  inline TInputPixel GetValue( const TInputPixel & )
     {
     // clean the map
     typename MapType::iterator mapIt = m_Map.begin();
@@ -148,22 +85,77 @@ public:
       }
 
     // and return the value
-    return m_Map.begin()->first;
+    if( m_Map.empty() )
+      { return m_Boundary; }
+    const TInputPixel & value = m_Map.begin()->first;
+    if( m_BoundaryCount > 0 && m_Compare( m_Boundary, value ) )
+      { return m_Boundary; }
+    return value;
     }
 
-  MapType m_Map;
+  inline static bool useVectorBasedAlgorithm()
+    { return false; }
+
+  // the map is small compared to the number of values added and removed
+  // along a line, so it is simply copied
+  inline void RestoreFrom( const MorphologyMapHistogram & reference )
+    {
+    m_Map = reference.m_Map;
+    m_BoundaryCount = reference.m_BoundaryCount;
+    }
+
+  inline void MergeChanges( const MorphologyMapHistogram & ) {}
+
+  /** Empty the histogram. */
+  inline void Reset()
+    {
+    m_Map.clear();
+    m_BoundaryCount = 0;
+    }
+
+  // the counters of the map are not stored in a fixed size array
+  inline void SetMaximumCount( unsigned long ) {}
 
+  static inline unsigned long GetCountLimit()
+    { return NumericTraits< unsigned long >::max(); }
 
+  inline void AddHistogram( const MorphologyMapHistogram & other )
+    {
+    for( typename MapType::const_iterator it=other.m_Map.begin(); it!=other.m_Map.end(); it++ )
+      { m_Map[ it->first ] += it->second; }
+    m_BoundaryCount += other.m_BoundaryCount;
+    }
 
+  inline void SubtractHistogram( const MorphologyMapHistogram & other )
+    {
+    for( typename MapType::const_iterator it=other.m_Map.begin(); it!=other.m_Map.end(); it++ )
+      { m_Map[ it->first ] -= it->second; }
+    m_BoundaryCount -= other.m_BoundaryCount;
+    }
 
-  //
-  // the vector based algorithm
-  //
+  void SetBoundary( const TInputPixel & val )
+    { m_Boundary = val; }
 
-  inline void initVector()
+  MapType m_Map;
+  TCompare m_Compare;
+  // the boundary pixels are only counted: they are compared to the
+  // extremum of the map in GetValue()
+  unsigned long m_BoundaryCount;
+  TInputPixel m_Boundary;
+};
+
+
+/** \class MorphologyVectorHistogram
+ * \brief vector based histogram, for the pixel types with a small
+ * number of values (8 bits and bool)
+ */
+template <class TInputPixel, class TCompare, class TCounter = unsigned int>
+class MorphologyVectorHistogram
+{
+public:
+  MorphologyVectorHistogram()
     {
-    // initialize members need for the vector based algorithm
-    m_Vector.resize( static_cast<int>( NumericTraits< TInputPixel >::max() - NumericTraits< TInputPixel >::NonpositiveMin() + 1 ), 0 );
+    m_Vector.Initialize( static_cast<int>( NumericTraits< TInputPixel >::max() - NumericTraits< TInputPixel >::NonpositiveMin() + 1 ) );
     if( m_Compare( NumericTraits< TInputPixel >::max(), NumericTraits< TInputPixel >::NonpositiveMin() ) )
       {
       m_CurrentValue = NumericTraits< TInputPixel >::NonpositiveMin();
@@ -174,46 +166,533 @@ public:
       m_CurrentValue = NumericTraits< TInputPixel >::max();
       m_Direction = 1;
       }
+    m_EndValue = m_CurrentValue;
+    m_BoundaryCount = 0;
     }
-  
+  ~MorphologyVectorHistogram(){}
 
-  inline void AddBoundaryVector()
-    { AddPixelVector( m_Boundary ); }
+  MorphologyVectorHistogram * Clone()
+    { return new MorphologyVectorHistogram( *this ); }
 
-  inline void RemoveBoundaryVector()
-    { RemovePixelVector( m_Boundary ); }
+  inline void AddBoundary()
+    { m_BoundaryCount++; }
 
-  inline void AddPixelVector( const TInputPixel &p )
+  inline void RemoveBoundary()
+    { m_BoundaryCount--; }
+
+  inline void AddPixel( const TInputPixel &p )
     {
-    m_Vector[ static_cast<int>( p - NumericTraits< TInputPixel >::NonpositiveMin() ) ]++;
+    m_Vector.Increment( static_cast<int>( p - NumericTraits< TInputPixel >::NonpositiveMin() ) );
     if( m_Compare( p, m_CurrentValue ) )
       { m_CurrentValue = p; }
     }
 
-  inline void RemovePixelVector( const TInputPixel &p )
+  inline void RemovePixel( const TInputPixel &p )
+    {
+    m_Vector.Decrement( static_cast<int>( p - NumericTraits< TInputPixel >::NonpositiveMin() ) );
+    // the histogram is empty when the kernel contains only boundary pixels:
+    // stop at the least preferred value in that case
+    while( m_Vector[ static_cast<int>( m_CurrentValue - NumericTraits< TInputPixel >::NonpositiveMin() ) ] == 0
+           && m_CurrentValue != m_EndValue )
+      { m_CurrentValue += m_Direction; }
+    }
+
+  inline TInputPixel GetValue( const TInputPixel & )
+    {
+    if( m_BoundaryCount > 0 && m_Compare( m_Boundary, m_CurrentValue ) )
+      { return m_Boundary; }
+    return m_CurrentValue;
+    }
+
+  inline static bool useVectorBasedAlgorithm()
+    { return true; }
+
+  // the vector is small, copy it without allocation
+  inline void RestoreFrom( const MorphologyVectorHistogram & reference )
+    {
+    m_Vector = reference.m_Vector;
+    m_CurrentValue = reference.m_CurrentValue;
+    m_BoundaryCount = reference.m_BoundaryCount;
+    }
+
+  inline void MergeChanges( const MorphologyVectorHistogram & ) {}
+
+  /** Empty the histogram. The vector is small: it is fully cleared. */
+  inline void Reset()
+    {
+    m_Vector.Clear();
+    m_CurrentValue = m_EndValue;
+    m_BoundaryCount = 0;
+    }
+
+  // the width of the counters is fixed at compile time: the filter checks
+  // the kernel against GetCountLimit() before running
+  inline void SetMaximumCount( unsigned long ) {}
+
+  static inline unsigned long GetCountLimit()
+    { return HistogramCounterArray< TCounter >::GetCountLimit(); }
+
+  inline void AddHistogram( const MorphologyVectorHistogram & other )
+    {
+    m_Vector.Add( other.m_Vector );
+    m_BoundaryCount += other.m_BoundaryCount;
+    // the current value of an empty histogram is never preferred
+    if( m_Compare( other.m_CurrentValue, m_CurrentValue ) )
+      { m_CurrentValue = other.m_CurrentValue; }
+    }
+
+  inline void SubtractHistogram( const MorphologyVectorHistogram & other )
     {
-    m_Vector[ static_cast<int>( p - NumericTraits< TInputPixel >::NonpositiveMin() ) ]--;
-    while( m_Vector[ static_cast<int>( m_CurrentValue - NumericTraits< TInputPixel >::NonpositiveMin() ) ] == 0 )
+    m_Vector.Subtract( other.m_Vector );
+    m_BoundaryCount -= other.m_BoundaryCount;
+    while( m_Vector[ static_cast<int>( m_CurrentValue - NumericTraits< TInputPixel >::NonpositiveMin() ) ] == 0
+           && m_CurrentValue != m_EndValue )
       { m_CurrentValue += m_Direction; }
     }
 
-  inline TInputPixel GetValueVector()
-    { return m_CurrentValue; }
+  void SetBoundary( const TInputPixel & val )
+    { m_Boundary = val; }
 
-  std::vector<unsigned long> m_Vector;
+  HistogramCounterArray< TCounter > m_Vector;
   TInputPixel m_CurrentValue;
+  TInputPixel m_EndValue;
   TCompare m_Compare;
   signed int m_Direction;
+  unsigned long m_BoundaryCount;
+  TInputPixel m_Boundary;
+};
+
+
+/** \class MorphologyBitmapHistogram
+ * \brief vector based histogram with a hierarchical occupancy bitmap
+ *
+ * The plain vector based algorithm scans the empty bins one by one
+ * when the current extremum is removed from the histogram, which is
+ * very slow for 16 bits images where the histogram has 65536 bins
+ * and is mostly empty. This histogram keeps the non empty bins in a
+ * HistogramOccupancyBitmap and finds the new extremum with a few bit
+ * scans. The extremum is updated incrementally: it is only searched
+ * when the bin of the current extremum becomes empty.
+ */
+template <class TInputPixel, class TCompare, class TCounter = unsigned int>
+class MorphologyBitmapHistogram
+{
+public:
+  MorphologyBitmapHistogram()
+    {
+    m_Vector.Initialize( static_cast<int>( NumericTraits< TInputPixel >::max() - NumericTraits< TInputPixel >::NonpositiveMin() + 1 ) );
+    m_Bitmap.Initialize( m_Vector.size() );
+    m_Changes.Initialize( m_Vector.size() );
+    // when the highest value is the preferred one, the extremum is the last
+    // non empty bin
+    m_UseLast = m_Compare( NumericTraits< TInputPixel >::max(), NumericTraits< TInputPixel >::NonpositiveMin() );
+    m_CurrentValue = InitialValue();
+    m_BoundaryCount = 0;
+    }
+  ~MorphologyBitmapHistogram(){}
+
+  MorphologyBitmapHistogram * Clone()
+    { return new MorphologyBitmapHistogram( *this ); }
+
+  inline void AddBoundary()
+    { m_BoundaryCount++; }
+
+  inline void RemoveBoundary()
+    { m_BoundaryCount--; }
+
+  inline void AddPixel( const TInputPixel &p )
+    {
+    const unsigned long bin = static_cast<unsigned long>( p - NumericTraits< TInputPixel >::NonpositiveMin() );
+    m_Changes.Set( bin );
+    if( m_Vector.Increment( bin ) == 1 )
+      { m_Bitmap.Set( bin ); }
+    if( m_Compare( p, m_CurrentValue ) )
+      { m_CurrentValue = p; }
+    }
+
+  inline void RemovePixel( const TInputPixel &p )
+    {
+    const unsigned long bin = static_cast<unsigned long>( p - NumericTraits< TInputPixel >::NonpositiveMin() );
+    m_Changes.Set( bin );
+    if( m_Vector.Decrement( bin ) == 0 )
+      {
+      m_Bitmap.Clear( bin );
+      // the extremum has to be searched only if its bin is now empty
+      if( p == m_CurrentValue )
+        {
+        if( m_Bitmap.IsEmpty() )
+          { m_CurrentValue = InitialValue(); }
+        else
+          {
+          const unsigned long newBin = m_UseLast ? m_Bitmap.Last() : m_Bitmap.First();
+          m_CurrentValue = static_cast< TInputPixel >( NumericTraits< TInputPixel >::NonpositiveMin() + newBin );
+          }
+        }
+      }
+    }
+
+  inline TInputPixel GetValue( const TInputPixel & )
+    {
+    if( m_BoundaryCount > 0 && m_Compare( m_Boundary, m_CurrentValue ) )
+      { return m_Boundary; }
+    return m_CurrentValue;
+    }
+
+  inline static bool useVectorBasedAlgorithm()
+    { return true; }
+
+  // only the blocks of bins changed since the histogram was identical to
+  // the reference are copied
+  inline void RestoreFrom( const MorphologyBitmapHistogram & reference )
+    {
+    m_Vector.CopyBlocks( reference.m_Vector, m_Changes );
+    m_Changes.CopyBitmap( reference.m_Bitmap, m_Bitmap );
+    m_CurrentValue = reference.m_CurrentValue;
+    m_BoundaryCount = reference.m_BoundaryCount;
+    m_Changes.Clear();
+    }
+
+  inline void MergeChanges( const MorphologyBitmapHistogram & other )
+    { m_Changes.Merge( other.m_Changes ); }
 
+  /** Empty the histogram. Only the non empty bins are cleared. */
+  inline void Reset()
+    {
+    while( !m_Bitmap.IsEmpty() )
+      {
+      const unsigned long bin = m_Bitmap.First();
+      m_Vector.ClearBin( bin );
+      m_Bitmap.Clear( bin );
+      }
+    m_Changes.Clear();
+    m_CurrentValue = InitialValue();
+    m_BoundaryCount = 0;
+    }
+
+  // the width of the counters is fixed at compile time: the filter checks
+  // the kernel against GetCountLimit() before running
+  inline void SetMaximumCount( unsigned long ) {}
 
+  static inline unsigned long GetCountLimit()
+    { return HistogramCounterArray< TCounter >::GetCountLimit(); }
 
-  // accessor for boundary value
+  // only the non empty bins of other are visited, so the cost depends on
+  // the number of distinct values in other, not on the number of bins
+  inline void AddHistogram( const MorphologyBitmapHistogram & other )
+    {
+    unsigned long bin = 0;
+    if( !other.m_Bitmap.IsEmpty() )
+      {
+      bin = other.m_Bitmap.First();
+      do
+        {
+        m_Changes.Set( bin );
+        if( m_Vector.AddToBin( bin, other.m_Vector[ bin ] ) == other.m_Vector[ bin ] )
+          { m_Bitmap.Set( bin ); }
+        }
+      while( other.m_Bitmap.Next( bin ) );
+      }
+    m_BoundaryCount += other.m_BoundaryCount;
+    if( m_Compare( other.m_CurrentValue, m_CurrentValue ) )
+      { m_CurrentValue = other.m_CurrentValue; }
+    }
+
+  inline void SubtractHistogram( const MorphologyBitmapHistogram & other )
+    {
+    unsigned long bin = 0;
+    if( !other.m_Bitmap.IsEmpty() )
+      {
+      bin = other.m_Bitmap.First();
+      do
+        {
+        m_Changes.Set( bin );
+        if( m_Vector.SubtractFromBin( bin, other.m_Vector[ bin ] ) == 0 )
+          { m_Bitmap.Clear( bin ); }
+        }
+      while( other.m_Bitmap.Next( bin ) );
+      }
+    m_BoundaryCount -= other.m_BoundaryCount;
+    if( m_Bitmap.IsEmpty() )
+      { m_CurrentValue = InitialValue(); }
+    else
+      {
+      const unsigned long newBin = m_UseLast ? m_Bitmap.Last() : m_Bitmap.First();
+      m_CurrentValue = static_cast< TInputPixel >( NumericTraits< TInputPixel >::NonpositiveMin() + newBin );
+      }
+    }
 
   void SetBoundary( const TInputPixel & val )
     { m_Boundary = val; }
 
+  /** the value which is replaced by any pixel added to the histogram */
+  inline TInputPixel InitialValue() const
+    {
+    if( m_UseLast )
+      { return NumericTraits< TInputPixel >::NonpositiveMin(); }
+    return NumericTraits< TInputPixel >::max();
+    }
+
+  HistogramCounterArray< TCounter > m_Vector;
+  HistogramOccupancyBitmap m_Bitmap;
+  HistogramChangedBlocks m_Changes;
+  TInputPixel m_CurrentValue;
+  TCompare m_Compare;
+  bool m_UseLast;
+  unsigned long m_BoundaryCount;
   TInputPixel m_Boundary;
 };
+
+
+
+/** \class MorphologyHeapHistogram
+ * \brief heap based histogram with lazy deletion, for the real pixel types
+ *
+ * The map based histogram allocates a node for each new value, and the
+ * real images have a lot of different values. This histogram stores the
+ * added values in a binary heap in a contiguous vector, ordered so the
+ * preferred value is on top. A removed value is pushed in a second heap,
+ * and is only removed from the first heap when it reaches the top of
+ * both. The two heaps are compacted when the removed values are more
+ * numerous than the valid ones, so their size stays proportional to the
+ * size of the kernel.
+ */
+template <class TInputPixel, class TCompare>
+class MorphologyHeapHistogram
+{
+public:
+  MorphologyHeapHistogram()
+    {
+    m_BoundaryCount = 0;
+    }
+  ~MorphologyHeapHistogram(){}
+
+  MorphologyHeapHistogram * Clone()
+    { return new MorphologyHeapHistogram( *this ); }
+
+  /** the heaps are ordered with the reverse comparison, to get the
+   * preferred value on top */
+  struct HeapCompare
+    {
+    inline bool operator()( const TInputPixel & a, const TInputPixel & b ) const
+      { return m_Compare( b, a ); }
+    TCompare m_Compare;
+    };
+
+  typedef typename std::vector< TInputPixel > HeapType;
+
+  inline void AddBoundary()
+    { m_BoundaryCount++; }
+
+  inline void RemoveBoundary()
+    { m_BoundaryCount--; }
+
+  inline void AddPixel( const TInputPixel &p )
+    {
+    m_Heap.push_back( p );
+    std::push_heap( m_Heap.begin(), m_Heap.end(), m_HeapCompare );
+    }
+
+  inline void RemovePixel( const TInputPixel &p )
+    {
+    m_Removed.push_back( p );
+    std::push_heap( m_Removed.begin(), m_Removed.end(), m_HeapCompare );
+    if( 2 * m_Removed.size() > m_Heap.size() + 64 )
+      { Compact(); }
+    }
+
+  inline TInputPixel GetValue( const TInputPixel & )
+    {
+    // drop the removed values from the top of the heap
+    while( !m_Removed.empty() && !m_HeapCompare( m_Removed.front(), m_Heap.front() ) )
+      {
+      std::pop_heap( m_Heap.begin(), m_Heap.end(), m_HeapCompare );
+      m_Heap.pop_back();
+      std::pop_heap( m_Removed.begin(), m_Removed.end(), m_HeapCompare );
+      m_Removed.pop_back();
+      }
+
+    if( m_Heap.empty() )
+      { return m_Boundary; }
+    const TInputPixel & value = m_Heap.front();
+    if( m_BoundaryCount > 0 && m_HeapCompare.m_Compare( m_Boundary, value ) )
+      { return m_Boundary; }
+    return value;
+    }
+
+  inline static bool useVectorBasedAlgorithm()
+    { return false; }
+
+  // the heaps are small and contiguous: they are simply copied, without
+  // allocation once the capacity is large enough
+  inline void RestoreFrom( const MorphologyHeapHistogram & reference )
+    {
+    m_Heap = reference.m_Heap;
+    m_Removed = reference.m_Removed;
+    m_BoundaryCount = reference.m_BoundaryCount;
+    }
+
+  inline void MergeChanges( const MorphologyHeapHistogram & ) {}
+
+  /** Empty the histogram, keeping the memory of the heaps. */
+  inline void Reset()
+    {
+    m_Heap.clear();
+    m_Removed.clear();
+    m_BoundaryCount = 0;
+    }
+
+  static inline unsigned long GetCountLimit()
+    { return NumericTraits< unsigned long >::max(); }
+
+  inline void SetMaximumCount( unsigned long maximumCount )
+    {
+    m_Heap.reserve( 2 * maximumCount + 64 );
+    m_Removed.reserve( maximumCount + 64 );
+    }
+
+  // the valid values are the values of the first heap minus the values of
+  // the second one
+  inline void AddHistogram( const MorphologyHeapHistogram & other )
+    {
+    PushAll( other.m_Heap, m_Heap );
+    PushAll( other.m_Removed, m_Removed );
+    m_BoundaryCount += other.m_BoundaryCount;
+    }
+
+  inline void SubtractHistogram( const MorphologyHeapHistogram & other )
+    {
+    PushAll( other.m_Heap, m_Removed );
+    PushAll( other.m_Removed, m_Heap );
+    m_BoundaryCount -= other.m_BoundaryCount;
+    if( 2 * m_Removed.size() > m_Heap.size() + 64 )
+      { Compact(); }
+    }
+
+  inline void PushAll( const HeapType & values, HeapType & heap )
+    {
+    for( typename HeapType::const_iterator it=values.begin(); it!=values.end(); it++ )
+      {
+      heap.push_back( *it );
+      std::push_heap( heap.begin(), heap.end(), m_HeapCompare );
+      }
+    }
+
+  void SetBoundary( const TInputPixel & val )
+    { m_Boundary = val; }
+
+  /** remove the values of the second heap from the first one */
+  void Compact()
+    {
+    // the two heaps are sorted with the same order, so the values are
+    // removed in a single pass
+    std::sort( m_Heap.begin(), m_Heap.end(), m_HeapCompare );
+    std::sort( m_Removed.begin(), m_Removed.end(), m_HeapCompare );
+    m_Buffer.clear();
+    std::set_difference( m_Heap.begin(), m_Heap.end(), m_Removed.begin(), m_Removed.end(),
+                         std::back_inserter( m_Buffer ), m_HeapCompare );
+    // a sorted vector is a valid heap, but with the preferred value at the
+    // end: reverse it
+    m_Heap.assign( m_Buffer.rbegin(), m_Buffer.rend() );
+    m_Removed.clear();
+    }
+
+  HeapType m_Heap;
+  HeapType m_Removed;
+  HeapType m_Buffer;
+  HeapCompare m_HeapCompare;
+  unsigned long m_BoundaryCount;
+  TInputPixel m_Boundary;
+};
+
+
+/** \class MorphologyHistogramTraits
+ * \brief select the histogram implementation for a pixel type at compile time
+ *
+ * The map based histogram is used by default. The 8 bits types and bool
+ * use the vector based histogram, and the 16 bits types use the bitmap
+ * based one: the linear scan of the vector based histogram is too slow on
+ * 65536 bins. The real types use the heap based histogram.
+ *
+ * TCounter is the type of the counters of the vector and bitmap based
+ * histograms. It is ignored by the other ones.
+ */
+template <class TInputPixel, class TCompare, class TCounter = unsigned int>
+struct MorphologyHistogramTraits
+{
+  typedef MorphologyMapHistogram< TInputPixel, TCompare > HistogramType;
+};
+
+template <class TCompare, class TCounter>
+struct MorphologyHistogramTraits< bool, TCompare, TCounter >
+{
+  typedef MorphologyVectorHistogram< bool, TCompare, TCounter > HistogramType;
+};
+
+template <class TCompare, class TCounter>
+struct MorphologyHistogramTraits< char, TCompare, TCounter >
+{
+  typedef MorphologyVectorHistogram< char, TCompare, TCounter > HistogramType;
+};
+
+template <class TCompare, class TCounter>
+struct MorphologyHistogramTraits< unsigned char, TCompare, TCounter >
+{
+  typedef MorphologyVectorHistogram< unsigned char, TCompare, TCounter > HistogramType;
+};
+
+template <class TCompare, class TCounter>
+struct MorphologyHistogramTraits< signed char, TCompare, TCounter >
+{
+  typedef MorphologyVectorHistogram< signed char, TCompare, TCounter > HistogramType;
+};
+
+template <class TCompare, class TCounter>
+struct MorphologyHistogramTraits< unsigned short, TCompare, TCounter >
+{
+  typedef MorphologyBitmapHistogram< unsigned short, TCompare, TCounter > HistogramType;
+};
+
+template <class TCompare, class TCounter>
+struct MorphologyHistogramTraits< signed short, TCompare, TCounter >
+{
+  typedef MorphologyBitmapHistogram< signed short, TCompare, TCounter > HistogramType;
+};
+
+template <class TCompare, class TCounter>
+struct MorphologyHistogramTraits< float, TCompare, TCounter >
+{
+  typedef MorphologyHeapHistogram< float, TCompare > HistogramType;
+};
+
+template <class TCompare, class TCounter>
+struct MorphologyHistogramTraits< double, TCompare, TCounter >
+{
+  typedef MorphologyHeapHistogram< double, TCompare > HistogramType;
+};
+
+
+/** \class MorphologyHistogram
+ * \brief the histogram used by the moving histogram dilation and erosion
+ *
+ * The implementation is selected by MorphologyHistogramTraits, so there
+ * is no runtime dispatch in the per pixel methods, and only the storage
+ * of the selected implementation is allocated.
+ *
+ * All the implementations only count the boundary pixels, and compare
+ * the boundary value to the extremum of the other pixels in GetValue().
+ *
+ * TCounter is the type of the counters, when the implementation has
+ * counters in a fixed size array.
+ */
+template <class TInputPixel, class TCompare, class TCounter = unsigned int>
+class MorphologyHistogram :
+    public MorphologyHistogramTraits< TInputPixel, TCompare, TCounter >::HistogramType
+{
+public:
+  MorphologyHistogram * Clone()
+    { return new MorphologyHistogram( *this ); }
+};
+
 } // end namespace Function
 
 
@@ -271,9 +750,7 @@ public:
   /** n-dimensional Kernel radius. */
   typedef typename KernelType::SizeType RadiusType ;
 
-  typedef typename std::list< OffsetType > OffsetListType;
-
-  typedef typename std::map< OffsetType, OffsetListType, typename Functor::OffsetLexicographicCompare<ImageDimension> > OffsetMapType;
+  typedef typename Superclass::OffsetListType OffsetListType;
 
   /** Set/Get the boundary value. */
   itkSetMacro(Boundary, PixelType);
@@ -295,7 +772,7 @@ protected:
 //                               int threadId) ;
 
   /** needed to pass the boundary value to the histogram object */
-  virtual THistogram * NewHistogram();
+  virtual THistogram * NewHistogram( int threadId );
 
   PixelType m_Boundary;
 
@@ -30,16 +30,22 @@ MovingHistogramMorphologyImageFilter<TInputImage, TOutputImage, TKernel, THistog
   // default m_boundary should be set by subclasses. Just provide a default
   // value to always get the same behavior if it is not done
   m_Boundary = itk::NumericTraits< PixelType >::Zero;
+
+  // the 8 bits histograms are cheap to copy and to update: moving several
+  // lines together hides the latency of the updates
+  if( sizeof( PixelType ) == 1 && THistogram::useVectorBasedAlgorithm() )
+    { this->m_NumberOfLockStepLines = 4; }
 }
 
 
 template<class TInputImage, class TOutputImage, class TKernel, class THistogram>
 THistogram *
 MovingHistogramMorphologyImageFilter<TInputImage, TOutputImage, TKernel, THistogram>
-::NewHistogram()
+::NewHistogram( int threadId )
 {
-  THistogram * histogram = Superclass::NewHistogram();
+  THistogram * histogram = Superclass::NewHistogram( threadId );
   histogram->SetBoundary( m_Boundary );
+  histogram->SetMaximumCount( this->m_MaximumHistogramCount );
   return histogram;
 }
 
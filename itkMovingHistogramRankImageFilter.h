@@ -0,0 +1,455 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkMovingHistogramRankImageFilter.h,v $
+  Language:  C++
+  Date:      $Date: 2006/04/24 12:00:00 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkMovingHistogramRankImageFilter_h
+#define __itkMovingHistogramRankImageFilter_h
+
+#include "itkMovingHistogramImageFilter.h"
+#include <map>
+#include "itkHistogramChangedBlocks.h"
+#include "itkHistogramCounterArray.h"
+
+namespace itk {
+
+namespace Function {
+
+/** \class RankMapHistogram
+ * \brief map based histogram, usable with any pixel type
+ *
+ * The rank is searched by walking the map from its nearest end, so the
+ * cost of a query is linear in the number of distinct values in the
+ * histogram.
+ */
+template <class TInputPixel>
+class RankMapHistogram
+{
+public:
+  RankMapHistogram()
+    {
+    m_Rank = 0.5;
+    m_Entries = 0;
+    }
+  ~RankMapHistogram(){}
+
+  RankMapHistogram * Clone()
+    { return new RankMapHistogram( *this ); }
+
+  typedef typename std::map< TInputPixel, unsigned long > MapType;
+
+  inline void AddBoundary() {}
+
+  inline void RemoveBoundary() {}
+
+  inline void AddPixel( const TInputPixel &p )
+    {
+    m_Map[ p ]++;
+    m_Entries++;
+    }
+
+  inline void RemovePixel( const TInputPixel &p )
+    {
+    typename MapType::iterator mapIt = m_Map.find( p );
+    if( --mapIt->second == 0 )
+      { m_Map.erase( mapIt ); }
+    m_Entries--;
+    }
+
+  inline TInputPixel GetValue( const TInputPixel & )
+    {
+    if( m_Entries == 0 )
+      { return NumericTraits< TInputPixel >::Zero; }
+    const unsigned long target = GetTarget( m_Rank, m_Entries );
+    unsigned long count = 0;
+    if( target <= m_Entries / 2 )
+      {
+      typename MapType::const_iterator mapIt = m_Map.begin();
+      for( ; count + mapIt->second < target; mapIt++ )
+        { count += mapIt->second; }
+      return mapIt->first;
+      }
+    // count from the end: the target is the (m_Entries - target + 1)th
+    // highest value
+    typename MapType::const_reverse_iterator mapIt = m_Map.rbegin();
+    for( ; count + mapIt->second <= m_Entries - target; mapIt++ )
+      { count += mapIt->second; }
+    return mapIt->first;
+    }
+
+  static inline bool useVectorBasedAlgorithm()
+    { return false; }
+
+  // the map is small compared to the number of values added and removed
+  // along a line, so it is simply copied
+  inline void RestoreFrom( const RankMapHistogram & reference )
+    {
+    m_Map = reference.m_Map;
+    m_Entries = reference.m_Entries;
+    }
+
+  inline void MergeChanges( const RankMapHistogram & ) {}
+
+  /** Empty the histogram. */
+  inline void Reset()
+    {
+    m_Map.clear();
+    m_Entries = 0;
+    }
+
+  // the counters of the map are not stored in a fixed size array
+  inline void SetMaximumCount( unsigned long ) {}
+
+  static inline unsigned long GetCountLimit()
+    { return NumericTraits< unsigned long >::max(); }
+
+  inline void AddHistogram( const RankMapHistogram & other )
+    {
+    for( typename MapType::const_iterator it=other.m_Map.begin(); it!=other.m_Map.end(); it++ )
+      { m_Map[ it->first ] += it->second; }
+    m_Entries += other.m_Entries;
+    }
+
+  inline void SubtractHistogram( const RankMapHistogram & other )
+    {
+    for( typename MapType::const_iterator it=other.m_Map.begin(); it!=other.m_Map.end(); it++ )
+      {
+      typename MapType::iterator mapIt = m_Map.find( it->first );
+      mapIt->second -= it->second;
+      if( mapIt->second == 0 )
+        { m_Map.erase( mapIt ); }
+      }
+    m_Entries -= other.m_Entries;
+    }
+
+  void SetRank( float rank )
+    { m_Rank = rank; }
+
+  /** the position, starting at 1, of the value of the given rank in the
+   * sorted list of the entries values. rank 0 is the lowest value and
+   * rank 1 the highest one. */
+  static inline unsigned long GetTarget( float rank, unsigned long entries )
+    { return static_cast< unsigned long >( rank * ( entries - 1 ) ) + 1; }
+
+  MapType m_Map;
+  float m_Rank;
+  unsigned long m_Entries;
+};
+
+
+/** \class RankFenwickHistogram
+ * \brief vector based histogram with logarithmic rank queries, for the
+ * 8 and 16 bits pixel types
+ *
+ * A cumulative scan of the bins is too slow for the 16 bits types, which
+ * have 65536 bins. The counts are stored in a Fenwick tree (binary indexed
+ * tree): the node i holds the number of entries in the bins
+ * ] i - lowbit(i), i ], where lowbit(i) is the lowest bit set in i. Adding
+ * or removing a pixel updates the log2(n) nodes covering its bin, and the
+ * value of a given rank is found by a binary descent in the tree, in
+ * log2(n) steps too.
+ *
+ * A node never holds more entries than the histogram, so the nodes are
+ * stored in a HistogramCounterArray, and the nodes modified since the
+ * last call of RestoreFrom() are recorded in a HistogramChangedBlocks.
+ * The tree is linear in the counts, so two histograms are added or
+ * subtracted node by node.
+ */
+template <class TInputPixel, class TCounter = unsigned int>
+class RankFenwickHistogram
+{
+public:
+  RankFenwickHistogram()
+    {
+    m_NumberOfBins = static_cast<unsigned long>( NumericTraits< TInputPixel >::max() - NumericTraits< TInputPixel >::NonpositiveMin() + 1 );
+    // the node 0 is not used
+    m_Tree.Initialize( m_NumberOfBins + 1 );
+    m_Changes.Initialize( m_NumberOfBins + 1 );
+    // the first step of the binary descent
+    m_TopStep = 1;
+    while( 2 * m_TopStep <= m_NumberOfBins )
+      { m_TopStep *= 2; }
+    m_Rank = 0.5;
+    m_Entries = 0;
+    }
+  ~RankFenwickHistogram(){}
+
+  RankFenwickHistogram * Clone()
+    { return new RankFenwickHistogram( *this ); }
+
+  inline void AddBoundary() {}
+
+  inline void RemoveBoundary() {}
+
+  inline void AddPixel( const TInputPixel &p )
+    {
+    for( unsigned long node = GetBin( p ) + 1; node <= m_NumberOfBins; node += node & ( ~node + 1 ) )
+      {
+      m_Tree.Increment( node );
+      m_Changes.Set( node );
+      }
+    m_Entries++;
+    }
+
+  inline void RemovePixel( const TInputPixel &p )
+    {
+    for( unsigned long node = GetBin( p ) + 1; node <= m_NumberOfBins; node += node & ( ~node + 1 ) )
+      {
+      m_Tree.Decrement( node );
+      m_Changes.Set( node );
+      }
+    m_Entries--;
+    }
+
+  inline TInputPixel GetValue( const TInputPixel & )
+    {
+    if( m_Entries == 0 )
+      { return NumericTraits< TInputPixel >::Zero; }
+    // search the last node with a cumulated count lower than the target;
+    // the next bin is the one of the target
+    unsigned long remaining = RankMapHistogram< TInputPixel >::GetTarget( m_Rank, m_Entries );
+    unsigned long node = 0;
+    for( unsigned long step = m_TopStep; step > 0; step >>= 1 )
+      {
+      const unsigned long next = node + step;
+      if( next <= m_NumberOfBins && m_Tree[ next ] < remaining )
+        {
+        node = next;
+        remaining -= m_Tree[ next ];
+        }
+      }
+    return static_cast< TInputPixel >( NumericTraits< TInputPixel >::NonpositiveMin() + static_cast< long >( node ) );
+    }
+
+  inline static bool useVectorBasedAlgorithm()
+    { return true; }
+
+  // only the blocks of nodes changed since the histogram was identical to
+  // the reference are copied
+  inline void RestoreFrom( const RankFenwickHistogram & reference )
+    {
+    m_Tree.CopyBlocks( reference.m_Tree, m_Changes );
+    m_Entries = reference.m_Entries;
+    m_Changes.Clear();
+    }
+
+  inline void MergeChanges( const RankFenwickHistogram & other )
+    { m_Changes.Merge( other.m_Changes ); }
+
+  /** Empty the histogram. Only the non null nodes are cleared: the nodes
+   * covering only empty bins are null, so the search stops there. The
+   * roots are the nodes of the decomposition of the whole range. */
+  inline void Reset()
+    {
+    for( unsigned long node = m_NumberOfBins; node > 0; node -= node & ( ~node + 1 ) )
+      { ClearNode( node, node & ( ~node + 1 ) ); }
+    m_Changes.Clear();
+    m_Entries = 0;
+    }
+
+  /** clear the node which covers ] node - width, node ], and its
+   * children node - 1, node - 2, ..., node - width / 2 */
+  inline void ClearNode( unsigned long node, unsigned long width )
+    {
+    if( m_Tree[ node ] == 0 )
+      { return; }
+    m_Tree.ClearBin( node );
+    for( unsigned long step = width / 2; step > 0; step >>= 1 )
+      { ClearNode( node - step, step ); }
+    }
+
+  // the width of the counters is fixed at compile time: the filter checks
+  // the kernel against GetCountLimit() before running
+  inline void SetMaximumCount( unsigned long ) {}
+
+  static inline unsigned long GetCountLimit()
+    { return HistogramCounterArray< TCounter >::GetCountLimit(); }
+
+  inline void AddHistogram( const RankFenwickHistogram & other )
+    {
+    m_Tree.Add( other.m_Tree );
+    m_Changes.SetAll();
+    m_Entries += other.m_Entries;
+    }
+
+  inline void SubtractHistogram( const RankFenwickHistogram & other )
+    {
+    m_Tree.Subtract( other.m_Tree );
+    m_Changes.SetAll();
+    m_Entries -= other.m_Entries;
+    }
+
+  void SetRank( float rank )
+    { m_Rank = rank; }
+
+  static inline unsigned long GetBin( const TInputPixel & p )
+    { return static_cast<unsigned long>( p - NumericTraits< TInputPixel >::NonpositiveMin() ); }
+
+  HistogramCounterArray< TCounter > m_Tree;
+  HistogramChangedBlocks m_Changes;
+  unsigned long m_NumberOfBins;
+  unsigned long m_TopStep;
+  float m_Rank;
+  unsigned long m_Entries;
+};
+
+
+/** \class RankHistogramTraits
+ * \brief select the histogram implementation for a pixel type at compile time
+ *
+ * The map based histogram is used by default, and the Fenwick tree for
+ * the 8 and 16 bits types.
+ */
+template <class TInputPixel>
+struct RankHistogramTraits
+{
+  typedef RankMapHistogram< TInputPixel > HistogramType;
+};
+
+template <>
+struct RankHistogramTraits< char >
+{
+  typedef RankFenwickHistogram< char > HistogramType;
+};
+
+template <>
+struct RankHistogramTraits< unsigned char >
+{
+  typedef RankFenwickHistogram< unsigned char > HistogramType;
+};
+
+template <>
+struct RankHistogramTraits< signed char >
+{
+  typedef RankFenwickHistogram< signed char > HistogramType;
+};
+
+template <>
+struct RankHistogramTraits< unsigned short >
+{
+  typedef RankFenwickHistogram< unsigned short > HistogramType;
+};
+
+template <>
+struct RankHistogramTraits< signed short >
+{
+  typedef RankFenwickHistogram< signed short > HistogramType;
+};
+
+
+/** \class RankHistogram
+ * \brief the histogram used by the moving histogram rank filter
+ *
+ * The implementation is selected by RankHistogramTraits.
+ */
+template <class TInputPixel>
+class RankHistogram :
+    public RankHistogramTraits< TInputPixel >::HistogramType
+{
+public:
+  RankHistogram * Clone()
+    { return new RankHistogram( *this ); }
+};
+
+} // end namespace Function
+
+
+
+/**
+ * \class MovingHistogramRankImageFilter
+ * \brief Rank filter of a greyscale image
+ *
+ * Each output pixel is the value of the given rank in the neighborhood
+ * defined by the kernel: rank 0 is the lowest value (an erosion), rank 1
+ * the highest value (a dilation), and rank 0.5 the median. The pixels
+ * outside the image are ignored.
+ *
+ * The 8 and 16 bits pixel types use a Fenwick tree, so a rank query has
+ * a logarithmic cost in the number of possible values.
+ *
+ * \sa MovingHistogramImageFilter, MovingHistogramDilateImageFilter, MovingHistogramErodeImageFilter
+ * \ingroup ImageEnhancement  MathematicalMorphologyImageFilters
+ */
+
+template<class TInputImage, class TOutputImage, class TKernel>
+class ITK_EXPORT MovingHistogramRankImageFilter :
+    public MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel,
+      typename  Function::RankHistogram< typename TInputImage::PixelType > >
+{
+public:
+  /** Standard class typedefs. */
+  typedef MovingHistogramRankImageFilter Self;
+  typedef MovingHistogramImageFilter<TInputImage, TOutputImage, TKernel,
+      typename  Function::RankHistogram< typename TInputImage::PixelType > >  Superclass;
+  typedef SmartPointer<Self>        Pointer;
+  typedef SmartPointer<const Self>  ConstPointer;
+
+  /** Standard New method. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(MovingHistogramRankImageFilter,
+               MovingHistogramImageFilter);
+
+  /** Image related typedefs. */
+  typedef TInputImage InputImageType;
+  typedef TOutputImage OutputImageType;
+  typedef typename TInputImage::RegionType RegionType ;
+  typedef typename TInputImage::SizeType SizeType ;
+  typedef typename TInputImage::IndexType IndexType ;
+  typedef typename TInputImage::PixelType PixelType ;
+  typedef typename TInputImage::OffsetType OffsetType ;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+  typedef typename TOutputImage::PixelType OutputPixelType ;
+
+  typedef typename Function::RankHistogram< PixelType > HistogramType;
+
+  /** Image related typedefs. */
+  itkStaticConstMacro(ImageDimension, unsigned int,
+                      TInputImage::ImageDimension);
+
+  /** Set/Get the rank, between 0 (the lowest value) and 1 (the highest
+   * value). Default is 0.5, the median. */
+  itkSetClampMacro(Rank, float, 0.0, 1.0);
+  itkGetMacro(Rank, float);
+
+  /** Return true if the vector based algorithm is used, and
+   * false if the map based algorithm is used */
+  static bool GetUseVectorBasedAlgorithm()
+    { return HistogramType::useVectorBasedAlgorithm(); }
+
+protected:
+  MovingHistogramRankImageFilter();
+  ~MovingHistogramRankImageFilter() {};
+  void PrintSelf(std::ostream& os, Indent indent) const;
+
+  /** needed to pass the rank and the maximum count of the bins to the
+   * histogram object */
+  virtual HistogramType * NewHistogram( int threadId );
+
+  float m_Rank;
+
+private:
+  MovingHistogramRankImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+} ; // end of class
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkMovingHistogramRankImageFilter.txx"
+#endif
+
+#endif
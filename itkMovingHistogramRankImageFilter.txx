@@ -0,0 +1,56 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkMovingHistogramRankImageFilter.txx,v $
+  Language:  C++
+  Date:      $Date: 2006/04/24 12:00:00 $
+  Version:   $Revision: 1.1 $
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkMovingHistogramRankImageFilter_txx
+#define __itkMovingHistogramRankImageFilter_txx
+
+#include "itkMovingHistogramRankImageFilter.h"
+
+
+namespace itk {
+
+template<class TInputImage, class TOutputImage, class TKernel>
+MovingHistogramRankImageFilter<TInputImage, TOutputImage, TKernel>
+::MovingHistogramRankImageFilter()
+{
+  m_Rank = 0.5;
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel>
+typename MovingHistogramRankImageFilter<TInputImage, TOutputImage, TKernel>::HistogramType *
+MovingHistogramRankImageFilter<TInputImage, TOutputImage, TKernel>
+::NewHistogram( int threadId )
+{
+  HistogramType * histogram = Superclass::NewHistogram( threadId );
+  histogram->SetRank( m_Rank );
+  histogram->SetMaximumCount( this->m_MaximumHistogramCount );
+  return histogram;
+}
+
+
+template<class TInputImage, class TOutputImage, class TKernel>
+void
+MovingHistogramRankImageFilter<TInputImage, TOutputImage, TKernel>
+::PrintSelf(std::ostream &os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Rank: " << m_Rank << std::endl;
+}
+
+}// end namespace itk
+#endif
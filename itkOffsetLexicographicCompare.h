@@ -33,6 +33,35 @@ public:
     return false;
     }
 };
+
+/** \class OffsetMemoryOrderCompare
+ * \brief Order Offset instances in the order of the pixels in memory.
+ *
+ * The last dimension is compared first, so a list of offsets sorted with
+ * this functor is also sorted by increasing linear offset in an image
+ * buffer, whatever the size of the buffer.
+ */
+template<unsigned int VOffsetDimension>
+class OffsetMemoryOrderCompare
+{
+public:
+  bool operator()(Offset<VOffsetDimension> const& l,
+                  Offset<VOffsetDimension> const& r) const
+    {
+    for(int i=VOffsetDimension-1; i >= 0; --i)
+      {
+      if(l.m_Offset[i] < r.m_Offset[i])
+        {
+        return true;
+        }
+      else if(l.m_Offset[i] > r.m_Offset[i])
+        {
+        return false;
+        }
+      }
+    return false;
+    }
+};
 }
 
 }
@@ -15,7 +15,7 @@ template <class TImage, class TBres, class TLine>
 int computeStartEnd(const typename TImage::IndexType StartIndex,
 		    const TLine line,
 		    const float tol,
-		    const typename TBres::OffsetArray LineOffsets,
+		    const typename TBres::OffsetArray & LineOffsets,
 		    const typename TImage::RegionType AllImage, 
 		    unsigned &start,
 		    unsigned &end);
@@ -25,7 +25,7 @@ int fillLineBuffer(typename TImage::ConstPointer input,
 		   const typename TImage::IndexType StartIndex,
 		   const TLine line,
 		   const float tol,
-		   const typename TBres::OffsetArray LineOffsets,
+		   const typename TBres::OffsetArray & LineOffsets,
 		   const typename TImage::RegionType AllImage, 
 		   typename TImage::PixelType * inbuffer,
 		   unsigned &start,
@@ -34,11 +34,24 @@ int fillLineBuffer(typename TImage::ConstPointer input,
 template <class TImage, class TBres>
 void copyLineToImage(const typename TImage::Pointer output,
 		     const typename TImage::IndexType StartIndex,
-		     const typename TBres::OffsetArray LineOffsets,
+		     const typename TBres::OffsetArray & LineOffsets,
 		     const typename TImage::PixelType * outbuffer,
 		     const unsigned start,
 		     const unsigned end);
 
+// same as copyLineToImage, but only the pixels inside Region are
+// written, with a conversion to the pixel type of the output. Used to
+// write the last pass of a decomposition directly in the output of
+// the filter.
+template <class TImage, class TBres, class TOutputImage>
+void copyLineToRegion(TOutputImage * output,
+		      const typename TOutputImage::RegionType Region,
+		      const typename TImage::IndexType StartIndex,
+		      const typename TBres::OffsetArray & LineOffsets,
+		      const typename TImage::PixelType * outbuffer,
+		      const unsigned start,
+		      const unsigned end);
+
 // This returns a face with a normal between +/- 45 degrees of the
 // line. The face is enlarged so that AllImage is entirely filled by
 // lines starting from every pixel in the face. This means that some
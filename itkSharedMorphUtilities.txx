@@ -64,7 +64,7 @@ template <class TImage, class TBres, class TLine>
 int computeStartEnd(const typename TImage::IndexType StartIndex,
 		    const TLine line,
 		    const float tol,
-		    const typename TBres::OffsetArray LineOffsets,
+		    const typename TBres::OffsetArray & LineOffsets,
 		    const typename TImage::RegionType AllImage, 
 		    unsigned &start,
 		    unsigned &end)
@@ -232,7 +232,7 @@ int computeStartEnd(const typename TImage::IndexType StartIndex,
 template <class TImage, class TBres>
 void copyLineToImage(const typename TImage::Pointer output,
 		     const typename TImage::IndexType StartIndex,
-		     const typename TBres::OffsetArray LineOffsets,
+		     const typename TBres::OffsetArray & LineOffsets,
 		     const typename TImage::PixelType * outbuffer,
 		     const unsigned start,
 		     const unsigned end)
@@ -252,6 +252,37 @@ void copyLineToImage(const typename TImage::Pointer output,
 }
 
 
+template <class TImage, class TBres, class TOutputImage>
+void copyLineToRegion(TOutputImage * output,
+		      const typename TOutputImage::RegionType Region,
+		      const typename TImage::IndexType StartIndex,
+		      const typename TBres::OffsetArray & LineOffsets,
+		      const typename TImage::PixelType * outbuffer,
+		      const unsigned start,
+		      const unsigned end)
+{
+  typedef typename TOutputImage::PixelType OutputPixelType;
+  // the coordinates are monotonic along a line, so the pixels inside
+  // the region are contiguous
+  bool inside = false;
+  unsigned size = end - start + 1;
+  for (unsigned i = 0; i <size; i++)
+    {
+    assert(start + i < LineOffsets.size());
+    typename TImage::IndexType I = StartIndex + LineOffsets[start + i];
+    if (Region.IsInside(I))
+      {
+      output->SetPixel(I, static_cast<OutputPixelType>(outbuffer[i+1]));  //compat
+      inside = true;
+      }
+    else if (inside)
+      {
+      break;
+      }
+    }
+}
+
+
 template <class TInputImage, class TLine>
 typename TInputImage::RegionType
 mkEnlargedFace(const typename TInputImage::ConstPointer input,
@@ -400,7 +431,7 @@ int fillLineBuffer(typename TImage::ConstPointer input,
 		   const typename TImage::IndexType StartIndex,
 		   const TLine line,  // unit vector
 		   const float tol,
-		   const typename TBres::OffsetArray LineOffsets,
+		   const typename TBres::OffsetArray & LineOffsets,
 		   const typename TImage::RegionType AllImage, 
 		   typename TImage::PixelType * inbuffer,
 		   unsigned &start,
@@ -17,14 +17,14 @@ public:
 };
 
 
-template<class TImage, class TKernel>
+template<class TImage, class TKernel, class TOutputImage = TImage>
 class  ITK_EXPORT vHGWDilateImageFilter :
-    public vHGWErodeDilateImageFilter<TImage, TKernel, MaxFunctor<typename TImage::PixelType> >
+    public vHGWErodeDilateImageFilter<TImage, TKernel, MaxFunctor<typename TImage::PixelType>, TOutputImage >
 
 {
 public:
   typedef vHGWDilateImageFilter Self;
-  typedef vHGWErodeDilateImageFilter<TImage, TKernel, MaxFunctor<typename TImage::PixelType> > Superclass;
+  typedef vHGWErodeDilateImageFilter<TImage, TKernel, MaxFunctor<typename TImage::PixelType>, TOutputImage > Superclass;
 
   /** Runtime information support. */
   itkTypeMacro(vHGWDilateImageFilter, 
@@ -4,6 +4,7 @@
 #include "itkImageToImageFilter.h"
 #include "itkProgressReporter.h"
 #include "itkBresenhamLine.h"
+#include "itkMorphologyScratchArena.h"
 
 namespace itk {
 
@@ -15,17 +16,19 @@ namespace itk {
  * The SetBoundary facility isn't necessary for operation of the
  * anchor method but is included for compatability with other
  * morphology classes in itk.
+ * The last pass of the decomposition is written directly in the
+ * output, with a conversion to the pixel type of TOutputImage.
 
 **/
 template<class TImage, class TKernel, 
-	 class TFunction1>
+	 class TFunction1, class TOutputImage = TImage>
 class ITK_EXPORT vHGWErodeDilateImageFilter :
-    public ImageToImageFilter<TImage, TImage>
+    public ImageToImageFilter<TImage, TOutputImage>
 {
 public:
   /** Standard class typedefs. */
   typedef vHGWErodeDilateImageFilter Self;
-  typedef ImageToImageFilter<TImage, TImage>
+  typedef ImageToImageFilter<TImage, TOutputImage>
   Superclass;
   typedef SmartPointer<Self>        Pointer;
   typedef SmartPointer<const Self>  ConstPointer;
@@ -42,11 +45,15 @@ public:
   typedef typename TImage::IndexType         IndexType;
   typedef typename TImage::SizeType          SizeType;
 
+  typedef TOutputImage OutputImageType;
+  typedef typename OutputImageType::RegionType     OutputImageRegionType;
+  typedef typename OutputImageType::PixelType      OutputImagePixelType;
+
   /** ImageDimension constants */
   itkStaticConstMacro(InputImageDimension, unsigned int,
                       TImage::ImageDimension);
   itkStaticConstMacro(OutputImageDimension, unsigned int,
-                      TImage::ImageDimension);
+                      TOutputImage::ImageDimension);
 
   /** Standard New method. */
   itkNewMacro(Self);
@@ -65,14 +72,24 @@ public:
   void SetBoundary( const InputImagePixelType value );
   itkGetMacro(Boundary, InputImagePixelType);
 
+  /** Free the internal image and the line buffers kept between the
+   * updates. They are allocated again by the next update. */
+  void ReleaseScratchMemory()
+    {
+    m_Scratch.Release();
+    }
+
 
 protected:
   vHGWErodeDilateImageFilter();
   ~vHGWErodeDilateImageFilter() {};
   void PrintSelf(std::ostream& os, Indent indent) const;
 
+  /** Make room for the working memory of the threads */
+  void BeforeThreadedGenerateData();
+
   /** Multi-thread version GenerateData. */
-  void  ThreadedGenerateData (const InputImageRegionType& outputRegionForThread,
+  void  ThreadedGenerateData (const OutputImageRegionType& outputRegionForThread,
                               int threadId) ;
 
   /** GrayscaleMorphologicalOpeningImageFilter need to make sure they request enough of an
@@ -93,6 +110,9 @@ private:
   bool m_KernelSet;
   typedef BresenhamLine<TImage::ImageDimension> BresType;
 
+  // the internal image and the line buffers of the threads
+  MorphologyScratchArena<TImage, 3> m_Scratch;
+
 
 } ; // end of class
 
@@ -3,32 +3,39 @@
 #define __itkvHGWErodeDilateImageFilter_txx
 
 #include "itkvHGWErodeDilateImageFilter.h"
-#include "itkImageRegionIterator.h"
 //#include "itkNeighborhoodAlgorithm.h"
 
 #include "itkvHGWUtilities.h"
 
 namespace itk {
 
-template <class TImage, class TKernel, class TFunction1>
-vHGWErodeDilateImageFilter<TImage, TKernel, TFunction1>
+template <class TImage, class TKernel, class TFunction1, class TOutputImage>
+vHGWErodeDilateImageFilter<TImage, TKernel, TFunction1, TOutputImage>
 ::vHGWErodeDilateImageFilter()
 {
   m_KernelSet = false;
 }
 
-template <class TImage, class TKernel, class TFunction1>
+template <class TImage, class TKernel, class TFunction1, class TOutputImage>
 void
-vHGWErodeDilateImageFilter<TImage, TKernel, TFunction1>
+vHGWErodeDilateImageFilter<TImage, TKernel, TFunction1, TOutputImage>
 ::SetBoundary(const InputImagePixelType value)
 {
   m_Boundary = value;
 }
 
-template <class TImage, class TKernel, class TFunction1>
+template <class TImage, class TKernel, class TFunction1, class TOutputImage>
 void
-vHGWErodeDilateImageFilter<TImage, TKernel, TFunction1>
-::ThreadedGenerateData (const InputImageRegionType& outputRegionForThread,
+vHGWErodeDilateImageFilter<TImage, TKernel, TFunction1, TOutputImage>
+::BeforeThreadedGenerateData()
+{
+  m_Scratch.SetNumberOfThreads(this->GetNumberOfThreads());
+}
+
+template <class TImage, class TKernel, class TFunction1, class TOutputImage>
+void
+vHGWErodeDilateImageFilter<TImage, TKernel, TFunction1, TOutputImage>
+::ThreadedGenerateData (const OutputImageRegionType& outputRegionForThread,
 			int threadId)
 {
 
@@ -51,7 +58,7 @@ vHGWErodeDilateImageFilter<TImage, TKernel, TFunction1>
   // will improve cache performance when working along non raster
   // directions.
 
-  ProgressReporter progress(this, threadId, m_Kernel.GetLines().size() + 1);
+  ProgressReporter progress(this, threadId, m_Kernel.GetLines().size());
 
   InputImageConstPointer input = this->GetInput();
 
@@ -60,14 +67,8 @@ vHGWErodeDilateImageFilter<TImage, TKernel, TFunction1>
 //   IReg.PadByRadius( m_Kernel.GetRadius() );
   IReg.Crop( this->GetInput()->GetRequestedRegion() );
 
-   // allocate an internal buffer
-  typename InputImageType::Pointer internalbuffer = InputImageType::New();
-  internalbuffer->SetRegions(IReg);
-  internalbuffer->Allocate();
-  InputImagePointer output = internalbuffer;
-
   // get the region size
-  InputImageRegionType OReg = outputRegionForThread;
+  OutputImageRegionType OReg = outputRegionForThread;
   // maximum buffer length is sum of dimensions
   unsigned int bufflength = 0;
   for (unsigned i = 0; i<TImage::ImageDimension; i++)
@@ -78,17 +79,27 @@ vHGWErodeDilateImageFilter<TImage, TKernel, TFunction1>
   // compat
   bufflength += 2;
 
-  InputImagePixelType * buffer = new InputImagePixelType[bufflength];
-  InputImagePixelType * forward = new InputImagePixelType[bufflength];
-  InputImagePixelType * reverse = new InputImagePixelType[bufflength];
+  InputImagePixelType * buffer = m_Scratch.GetLine(threadId, 0, bufflength);
+  InputImagePixelType * forward = m_Scratch.GetLine(threadId, 1, bufflength);
+  InputImagePixelType * reverse = m_Scratch.GetLine(threadId, 2, bufflength);
   // iterate over all the structuring elements
   typename KernelType::DecompType decomposition = m_Kernel.GetLines();
   BresType BresLine;
 
+  // all the passes but the last one are done in the internal buffer.
+  // The internal buffer and the line buffers are kept between the
+  // updates: they are only allocated when the region grows
+  InputImagePointer internalbuffer;
+  if (decomposition.size() > 1)
+    {
+    internalbuffer = m_Scratch.GetImage(threadId, IReg);
+    }
+
   for (unsigned i = 0; i < decomposition.size(); i++)
     {
     typename KernelType::LType ThisLine = decomposition[i];
-    typename BresType::OffsetArray TheseOffsets = BresLine.buildLine(ThisLine, bufflength);
+    typename BresType::LineConstPointer TheseLine = BresLine.buildLine(ThisLine, bufflength);
+    const typename BresType::OffsetArray & TheseOffsets = TheseLine->GetValue();
     unsigned int SELength = getLinePixels<typename KernelType::LType>(ThisLine);
     // want lines to be odd
     if (!(SELength%2))
@@ -96,45 +107,44 @@ vHGWErodeDilateImageFilter<TImage, TKernel, TFunction1>
 
     InputImageRegionType BigFace = mkEnlargedFace<InputImageType, typename KernelType::LType>(input, IReg, ThisLine);
 
-    doFace<TImage, BresType, TFunction1, 
-      typename KernelType::LType>(input, output, m_Boundary, ThisLine,  
-				  TheseOffsets, SELength,
-				  buffer, forward, 
-				  reverse, IReg, BigFace);
+    if (i + 1 < decomposition.size())
+      {
+      doFace<TImage, BresType, TFunction1, 
+	typename KernelType::LType, TImage>(input, internalbuffer, IReg, m_Boundary, ThisLine,  
+					    TheseOffsets, SELength,
+					    buffer, forward, 
+					    reverse, IReg, BigFace);
     
-    // after the first pass the input will be taken from the output
-    input = internalbuffer;
+      // after the first pass the input will be taken from the output
+      input = internalbuffer;
+      }
+    else
+      {
+      // the last pass writes the pixels of the region of the thread
+      // directly in the output
+      doFace<TImage, BresType, TFunction1, 
+	typename KernelType::LType, TOutputImage>(input, this->GetOutput(), OReg, m_Boundary, ThisLine,  
+						  TheseOffsets, SELength,
+						  buffer, forward, 
+						  reverse, IReg, BigFace);
+      }
     progress.CompletedPixel();
     }
-
-  // copy internal buffer to output
-  typedef typename itk::ImageRegionIterator<InputImageType> IterType;
-  IterType oit(this->GetOutput(), OReg);
-  IterType iit(internalbuffer, OReg);
-  for (oit.GoToBegin(), iit.GoToBegin(); !oit.IsAtEnd(); ++oit, ++iit)
-    {
-    oit.Set(iit.Get());
-    }
-  progress.CompletedPixel();
-
-  delete [] buffer;
-  delete [] forward;
-  delete [] reverse;
 }
 
 
-template<class TImage, class TKernel, class TFunction1>
+template<class TImage, class TKernel, class TFunction1, class TOutputImage>
 void
-vHGWErodeDilateImageFilter<TImage, TKernel, TFunction1>
+vHGWErodeDilateImageFilter<TImage, TKernel, TFunction1, TOutputImage>
 ::PrintSelf(std::ostream &os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
 }
 
 
-template<class TImage, class TKernel, class TFunction1>
+template<class TImage, class TKernel, class TFunction1, class TOutputImage>
 void
-vHGWErodeDilateImageFilter<TImage, TKernel, TFunction1>
+vHGWErodeDilateImageFilter<TImage, TKernel, TFunction1, TOutputImage>
 ::GenerateInputRequestedRegion()
 {
   // call the superclass' implementation of this method
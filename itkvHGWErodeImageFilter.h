@@ -17,14 +17,14 @@ public:
 };
 
 
-template<class TImage, class TKernel>
+template<class TImage, class TKernel, class TOutputImage = TImage>
 class  ITK_EXPORT vHGWErodeImageFilter :
-    public vHGWErodeDilateImageFilter<TImage, TKernel, MinFunctor<typename TImage::PixelType> >
+    public vHGWErodeDilateImageFilter<TImage, TKernel, MinFunctor<typename TImage::PixelType>, TOutputImage >
 
 {
 public:
   typedef vHGWErodeImageFilter Self;
-  typedef vHGWErodeDilateImageFilter<TImage, TKernel, MinFunctor<typename TImage::PixelType> > Superclass;
+  typedef vHGWErodeDilateImageFilter<TImage, TKernel, MinFunctor<typename TImage::PixelType>, TOutputImage > Superclass;
 
   /** Runtime information support. */
   itkTypeMacro(vHGWErodeImageFilter, 
@@ -22,7 +22,7 @@ int fillLineBuffer(typename TImage::ConstPointer input,
 		   typename TImage::PixelType border,
 		   const TLine line,  // unit vector
 		   const float tol,
-		   const typename TBres::OffsetArray LineOffsets,
+		   const typename TBres::OffsetArray & LineOffsets,
 		   const typename TImage::RegionType AllImage,
 		   const unsigned int KernLen,
 		   typename TImage::PixelType * pixbuffer,
@@ -39,12 +39,14 @@ void fillForwardExt(PixelType *pixbuffer, PixelType *fExtBuffer,
 		    const unsigned int KernLen, unsigned len);
 #endif
 
-template <class TImage, class TBres, class TFunction, class TLine>
+// only the pixels of output inside OutputRegion are written
+template <class TImage, class TBres, class TFunction, class TLine, class TOutputImage>
 void doFace(typename TImage::ConstPointer input,
-	    typename TImage::Pointer output,
+	    TOutputImage * output,
+	    const typename TOutputImage::RegionType OutputRegion,
 	    typename TImage::PixelType border,
 	    TLine line,
-	    const typename TBres::OffsetArray LineOffsets,
+	    const typename TBres::OffsetArray & LineOffsets,
 	    const unsigned int KernLen,
 	    typename TImage::PixelType * pixbuffer,
 	    typename TImage::PixelType * fExtBuffer,	      
@@ -24,7 +24,7 @@ int fillLineBuffer(typename TImage::ConstPointer input,
 		   const typename TImage::IndexType StartIndex,
 		   const TLine line,  // unit vector
 		   const float tol,
-		   const typename TBres::OffsetArray LineOffsets,
+		   const typename TBres::OffsetArray & LineOffsets,
 		   const typename TImage::RegionType AllImage,
 		   const unsigned int KernLen,
 		   typename TImage::PixelType * pixbuffer,
@@ -81,7 +81,7 @@ template <class TImage, class TBres, class TFunction, class TLine>
 void doFace(typename TImage::ConstPointer input,
 	    typename TImage::Pointer output,
 	    TLine line,
-	    const typename TBres::OffsetArray LineOffsets,
+	    const typename TBres::OffsetArray & LineOffsets,
 	    const unsigned int KernLen,
 	    typename TImage::PixelType * pixbuffer,
 	    typename TImage::PixelType * fExtBuffer,	      
@@ -322,12 +322,13 @@ void fillReverseExt(PixelType *pixbuffer, PixelType *rExtBuffer,
 
 }
 
-template <class TImage, class TBres, class TFunction, class TLine>
+template <class TImage, class TBres, class TFunction, class TLine, class TOutputImage>
 void doFace(typename TImage::ConstPointer input,
-	    typename TImage::Pointer output,
+	    TOutputImage * output,
+	    const typename TOutputImage::RegionType OutputRegion,
 	    typename TImage::PixelType border,
 	    TLine line,
-	    const typename TBres::OffsetArray LineOffsets,
+	    const typename TBres::OffsetArray & LineOffsets,
 	    const unsigned int KernLen,
 	    typename TImage::PixelType * pixbuffer,
 	    typename TImage::PixelType * fExtBuffer,	      
@@ -422,7 +423,7 @@ void doFace(typename TImage::ConstPointer input,
 	  pixbuffer[j]=rExtBuffer[j-KernLen/2];
 	  }
 	}
-      copyLineToImage<TImage, TBres>(output, Ind, LineOffsets, pixbuffer, start, end);
+      copyLineToRegion<TImage, TBres, TOutputImage>(output, OutputRegion, Ind, LineOffsets, pixbuffer, start, end);
       
       }
     ++it;
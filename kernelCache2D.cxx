@@ -0,0 +1,122 @@
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkGrayscaleDilateImageFilter.h"
+#include "itkMovingHistogramDilateImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkFlatStructuringElement.h"
+#include "itkSimpleFilterWatcher.h"
+
+
+template< class TImage >
+bool SameImages( const TImage * image1, const TImage * image2 )
+{
+  typedef itk::ImageRegionConstIterator< TImage > IteratorType;
+  IteratorType it1( image1, image1->GetBufferedRegion() );
+  IteratorType it2( image2, image2->GetBufferedRegion() );
+  for( it1.GoToBegin(), it2.GoToBegin(); !it1.IsAtEnd(); ++it1, ++it2 )
+    {
+    if( it1.Get() != it2.Get() )
+      { return false; }
+    }
+  return true;
+}
+
+
+int main(int, char * argv[])
+{
+  const int dim = 2;
+  typedef unsigned char PType;
+  typedef itk::Image< PType, dim >    IType;
+  
+  // read the input image
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+  
+  typedef itk::FlatStructuringElement<dim> SRType;
+  SRType::RadiusType radius;
+  radius.Fill( 4 );
+  SRType kernel = SRType::Box( radius );
+  
+  // the second filter finds the preprocessed kernel of the first one in
+  // the cache
+  typedef itk::MovingHistogramDilateImageFilter< IType, IType, SRType > DilateType;
+  DilateType::Pointer dilate = DilateType::New();
+  dilate->SetInput( reader->GetOutput() );
+  dilate->SetKernel( kernel );
+  
+  itk::SimpleFilterWatcher watcher(dilate, "dilate");
+
+  DilateType::Pointer dilate2 = DilateType::New();
+  dilate2->SetInput( reader->GetOutput() );
+  dilate2->SetKernel( kernel );
+
+  itk::SimpleFilterWatcher watcher2(dilate2, "dilate2");
+
+  typedef itk::ImageFileWriter< IType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( dilate->GetOutput() );
+  writer->SetFileName( argv[2] );
+  writer->Update();
+
+  dilate2->Update();
+  if( !SameImages( dilate->GetOutput(), dilate2->GetOutput() ) )
+    {
+    std::cerr << "the dilations with a cached kernel differ" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // fill the cache with other kernels, so the kernel of the filters is
+  // evicted, and set it again: it is preprocessed again, and the filters
+  // which still hold the evicted entry still work
+  DilateType::Pointer other = DilateType::New();
+  for( int i=1; i<=80; i++ )
+    {
+    SRType::RadiusType otherRadius;
+    otherRadius[0] = i;
+    otherRadius[1] = 1;
+    other->SetKernel( SRType::Box( otherRadius ) );
+    }
+  dilate->Modified();
+  dilate->Update();
+  dilate2->SetKernel( kernel );
+  dilate2->Update();
+  if( !SameImages( dilate->GetOutput(), dilate2->GetOutput() ) )
+    {
+    std::cerr << "the dilations after an eviction differ" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // the anchor and vHGW filters share the Bresenham lines of the
+  // decomposition of the polygon, which has some diagonal lines
+  radius.Fill( 7 );
+  SRType poly = SRType::Poly( radius, 4 );
+
+  typedef itk::GrayscaleDilateImageFilter< IType, IType, SRType > GrayscaleDilateType;
+  GrayscaleDilateType::Pointer anchor = GrayscaleDilateType::New();
+  anchor->SetInput( reader->GetOutput() );
+  anchor->SetKernel( poly );
+  anchor->SetAlgorithm( GrayscaleDilateType::ANCHOR );
+  anchor->Update();
+
+  GrayscaleDilateType::Pointer anchor2 = GrayscaleDilateType::New();
+  anchor2->SetInput( reader->GetOutput() );
+  anchor2->SetKernel( poly );
+  anchor2->SetAlgorithm( GrayscaleDilateType::ANCHOR );
+  anchor2->Update();
+
+  GrayscaleDilateType::Pointer vhgw = GrayscaleDilateType::New();
+  vhgw->SetInput( reader->GetOutput() );
+  vhgw->SetKernel( poly );
+  vhgw->SetAlgorithm( GrayscaleDilateType::VHGW );
+  vhgw->Update();
+
+  if( !SameImages( anchor->GetOutput(), anchor2->GetOutput() )
+      || !SameImages( anchor->GetOutput(), vhgw->GetOutput() ) )
+    {
+    std::cerr << "the dilations with cached lines differ" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return 0;
+}
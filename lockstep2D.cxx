@@ -0,0 +1,61 @@
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkMovingHistogramDilateImageFilter.h"
+#include "itkMovingHistogramErodeImageFilter.h"
+#include "itkFlatStructuringElement.h"
+#include "itkSimpleFilterWatcher.h"
+
+
+int main(int, char * argv[])
+{
+  const int dim = 2;
+  typedef unsigned char PType;
+  typedef itk::Image< PType, dim >    IType;
+  
+  // read the input image
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+  
+  typedef itk::FlatStructuringElement<dim> SRType;
+  SRType::RadiusType radius;
+  radius.Fill( 4 );
+  SRType kernel = SRType::Box( radius );
+  
+  typedef itk::MovingHistogramDilateImageFilter< IType, IType, SRType > DilateType;
+  DilateType::Pointer dilate = DilateType::New();
+  dilate->SetInput( reader->GetOutput() );
+  dilate->SetKernel( kernel );
+  
+  itk::SimpleFilterWatcher watcher(dilate, "dilate");
+
+  typedef itk::MovingHistogramErodeImageFilter< IType, IType, SRType > ErodeType;
+  ErodeType::Pointer erode = ErodeType::New();
+  erode->SetInput( reader->GetOutput() );
+  erode->SetKernel( kernel );
+  
+  itk::SimpleFilterWatcher watcher2(erode, "erode");
+
+  typedef itk::ImageFileWriter< IType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+
+  // one line at a time
+  dilate->SetNumberOfLockStepLines( 1 );
+  writer->SetInput( dilate->GetOutput() );
+  writer->SetFileName( argv[2] );
+  writer->Update();
+
+  // a number of lines which doesn't divide the size of the regions of
+  // the threads
+  dilate->SetNumberOfLockStepLines( 3 );
+  writer->SetFileName( argv[3] );
+  writer->Update();
+
+  erode->SetNumberOfLockStepLines( 5 );
+  writer->SetInput( erode->GetOutput() );
+  writer->SetFileName( argv[4] );
+  writer->Update();
+
+  return 0;
+}
+
@@ -0,0 +1,105 @@
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkBinaryThresholdImageFilter.h"
+#include "itkMaskedMovingHistogramDilateImageFilter.h"
+#include "itkMaskedMovingHistogramErodeImageFilter.h"
+#include "itkGrayscaleDilateImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkFlatStructuringElement.h"
+#include "itkSimpleFilterWatcher.h"
+
+
+int main(int, char * argv[])
+{
+  const int dim = 2;
+  typedef unsigned char PType;
+  typedef itk::Image< PType, dim >    IType;
+  
+  // read the input image
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+  
+  // a mask containing all the pixels, and a mask containing only the
+  // bright ones
+  typedef itk::BinaryThresholdImageFilter< IType, IType > ThresholdType;
+  ThresholdType::Pointer fullMask = ThresholdType::New();
+  fullMask->SetInput( reader->GetOutput() );
+  fullMask->SetLowerThreshold( 0 );
+  fullMask->SetUpperThreshold( 255 );
+
+  ThresholdType::Pointer mask = ThresholdType::New();
+  mask->SetInput( reader->GetOutput() );
+  mask->SetLowerThreshold( 100 );
+  mask->SetUpperThreshold( 255 );
+
+  typedef itk::FlatStructuringElement<dim> SRType;
+  SRType::RadiusType radius;
+  radius.Fill( 4 );
+  SRType kernel = SRType::Box( radius );
+  
+  typedef itk::MaskedMovingHistogramDilateImageFilter< IType, IType, IType, SRType > DilateType;
+  DilateType::Pointer dilate = DilateType::New();
+  dilate->SetInput( reader->GetOutput() );
+  dilate->SetMaskImage( fullMask->GetOutput() );
+  dilate->SetKernel( kernel );
+  
+  itk::SimpleFilterWatcher watcher(dilate, "dilate");
+
+  typedef itk::MaskedMovingHistogramErodeImageFilter< IType, IType, IType, SRType > ErodeType;
+  ErodeType::Pointer erode = ErodeType::New();
+  erode->SetInput( reader->GetOutput() );
+  erode->SetMaskImage( fullMask->GetOutput() );
+  erode->SetKernel( kernel );
+  
+  itk::SimpleFilterWatcher watcher2(erode, "erode");
+
+  typedef itk::ImageFileWriter< IType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+
+  // with a full mask, the result is the one of the unmasked filters
+  writer->SetInput( dilate->GetOutput() );
+  writer->SetFileName( argv[2] );
+  writer->Update();
+
+  writer->SetInput( erode->GetOutput() );
+  writer->SetFileName( argv[3] );
+  writer->Update();
+
+  // only the bright pixels
+  dilate->SetMaskImage( mask->GetOutput() );
+  writer->SetInput( dilate->GetOutput() );
+  writer->SetFileName( argv[4] );
+  writer->Update();
+
+  // the pixels outside the mask are darker than the ones in the mask, so
+  // the masked dilation must be the unmasked one in the mask, and the fill
+  // value outside
+  typedef itk::GrayscaleDilateImageFilter< IType, IType, SRType > BasicDilateType;
+  BasicDilateType::Pointer basicDilate = BasicDilateType::New();
+  basicDilate->SetInput( reader->GetOutput() );
+  basicDilate->SetKernel( kernel );
+  basicDilate->SetAlgorithm( BasicDilateType::BASIC );
+  basicDilate->Update();
+
+  typedef itk::ImageRegionConstIterator< IType > IteratorType;
+  const IType::RegionType region = dilate->GetOutput()->GetBufferedRegion();
+  IteratorType maskedIt( dilate->GetOutput(), region );
+  IteratorType basicIt( basicDilate->GetOutput(), region );
+  IteratorType maskIt( mask->GetOutput(), region );
+  for( ; !maskedIt.IsAtEnd(); ++maskedIt, ++basicIt, ++maskIt )
+    {
+    PType expected = dilate->GetFillValue();
+    if( maskIt.Get() == dilate->GetMaskValue() )
+      { expected = basicIt.Get(); }
+    if( maskedIt.Get() != expected )
+      {
+      std::cerr << "wrong masked dilation: " << (int)maskedIt.Get()
+                << " instead of " << (int)expected << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return 0;
+}
+
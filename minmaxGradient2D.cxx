@@ -0,0 +1,50 @@
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkMovingHistogramMinMaxGradientImageFilter.h"
+#include "itkFlatStructuringElement.h"
+#include "itkSimpleFilterWatcher.h"
+
+
+int main(int, char * argv[])
+{
+  const int dim = 2;
+  typedef unsigned char PType;
+  typedef itk::Image< PType, dim >    IType;
+  
+  // read the input image
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+  
+  typedef itk::FlatStructuringElement<dim> SRType;
+  SRType::RadiusType radius;
+  radius.Fill( 4 );
+  SRType kernel = SRType::Box( radius );
+  
+  typedef itk::MovingHistogramMinMaxGradientImageFilter< IType, IType, SRType > FilterType;
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( reader->GetOutput() );
+  filter->SetKernel( kernel );
+  
+  itk::SimpleFilterWatcher watcher(filter, "filter");
+
+  filter->Update();
+
+  typedef itk::ImageFileWriter< IType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+
+  writer->SetInput( filter->GetMinimumOutput() );
+  writer->SetFileName( argv[2] );
+  writer->Update();
+
+  writer->SetInput( filter->GetMaximumOutput() );
+  writer->SetFileName( argv[3] );
+  writer->Update();
+
+  writer->SetInput( filter->GetGradientOutput() );
+  writer->SetFileName( argv[4] );
+  writer->Update();
+
+  return 0;
+}
+
@@ -0,0 +1,92 @@
+#include "itkImageFileReader.h"
+#include "itkMovingHistogramDilateImageFilter.h"
+#include "itkColumnHistogramDilateImageFilter.h"
+#include "itkNeighborhood.h"
+#include "itkTimeProbe.h"
+#include <vector>
+#include "itkMultiThreader.h"
+
+// compare the moving histogram and the column histogram algorithms on
+// rectangular kernels, to calibrate the selection of the column algorithm
+// in GrayscaleDilateImageFilter and GrayscaleErodeImageFilter
+int main(int, char * argv[])
+{
+  itk::MultiThreader::SetGlobalMaximumNumberOfThreads(1);
+
+  const int dim = 2;
+  typedef unsigned char PType;
+  typedef itk::Image< PType, dim >    IType;
+  
+  // read the input image
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+  
+  // a neighborhood is never decomposed, like a rectangle read from an image
+  typedef itk::Neighborhood<bool, dim> SRType;
+  SRType kernel;
+  
+  typedef itk::MovingHistogramDilateImageFilter< IType, IType, SRType > HDilateType;
+  HDilateType::Pointer hdilate = HDilateType::New();
+  hdilate->SetInput( reader->GetOutput() );
+  
+  typedef itk::ColumnHistogramDilateImageFilter< IType, IType, SRType > CDilateType;
+  CDilateType::Pointer cdilate = CDilateType::New();
+  cdilate->SetInput( reader->GetOutput() );
+  
+  reader->Update();
+  
+  std::vector< int > radiusList;
+  for( int s=1; s<=10; s++)
+    { radiusList.push_back( s ); }
+  for( int s=12; s<=30; s+=2)
+    { radiusList.push_back( s ); }
+  radiusList.push_back( 40 );
+  radiusList.push_back( 50 );
+  
+  std::cout << "#radius" << "\t" 
+            << "rep" << "\t" 
+            << "total" << "\t" 
+            << "hnb" << "\t" 
+            << "hd" << "\t" 
+            << "cd" << std::endl;
+
+  for( std::vector< int >::iterator it=radiusList.begin(); it !=radiusList.end() ; it++)
+    {
+    itk::TimeProbe hdtime;
+    itk::TimeProbe cdtime;
+
+    kernel.SetRadius( *it );
+    for( SRType::Iterator kit=kernel.Begin(); kit!=kernel.End(); kit++ )
+      {
+      *kit = true;
+      }
+  
+    hdilate->SetKernel( kernel );
+    cdilate->SetKernel( kernel );
+
+    int nbOfRepeats = 5;
+
+    for( int i=0; i<nbOfRepeats; i++ )
+      {
+      hdtime.Start();
+      hdilate->Update();
+      hdtime.Stop();
+      hdilate->Modified();
+      cdtime.Start();
+      cdilate->Update();
+      cdtime.Stop();
+      cdilate->Modified();
+      }
+      
+    std::cout << *it << "\t" 
+              << nbOfRepeats << "\t" 
+              << (*it*2+1)*(*it*2+1) << "\t" 
+              << hdilate->GetPixelsPerTranslation() << "\t" 
+              << hdtime.GetMeanTime() << "\t" 
+              << cdtime.GetMeanTime() << std::endl;
+    }
+  
+  
+  return 0;
+}
@@ -0,0 +1,111 @@
+#include "itkImageFileReader.h"
+#include "itkMovingHistogramDilateImageFilter.h"
+#include "itkMovingHistogramErodeImageFilter.h"
+#include "itkFlatStructuringElement.h"
+#include "itkTimeProbe.h"
+#include <vector>
+#include "itkMultiThreader.h"
+
+int main(int, char * argv[])
+{
+  itk::MultiThreader::SetGlobalMaximumNumberOfThreads(1);
+
+  const int dim = 2;
+  typedef float PType;
+  typedef itk::Image< PType, dim >    IType;
+
+  // read the input image
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+
+  typedef itk::FlatStructuringElement< dim > SRType;
+
+  typedef itk::MovingHistogramDilateImageFilter< IType, IType, SRType > HDilateType;
+  HDilateType::Pointer hdilate = HDilateType::New();
+  hdilate->SetInput( reader->GetOutput() );
+
+  typedef itk::MovingHistogramErodeImageFilter< IType, IType, SRType > HErodeType;
+  HErodeType::Pointer herode = HErodeType::New();
+  herode->SetInput( reader->GetOutput() );
+
+  // the map based histogram, previously used for the real types, as
+  // reference
+  typedef itk::MovingHistogramMorphologyImageFilter< IType, IType, SRType, itk::Function::MorphologyMapHistogram< PType, std::greater< PType > > > MDilateType;
+  MDilateType::Pointer mdilate = MDilateType::New();
+  mdilate->SetInput( reader->GetOutput() );
+  mdilate->SetBoundary( itk::NumericTraits< PType >::NonpositiveMin() );
+
+  typedef itk::MovingHistogramMorphologyImageFilter< IType, IType, SRType, itk::Function::MorphologyMapHistogram< PType, std::less< PType > > > MErodeType;
+  MErodeType::Pointer merode = MErodeType::New();
+  merode->SetInput( reader->GetOutput() );
+  merode->SetBoundary( itk::NumericTraits< PType >::max() );
+
+  reader->Update();
+
+  std::vector< int > radiusList;
+  for( int s=1; s<=10; s++)
+    { radiusList.push_back( s ); }
+  for( int s=15; s<=30; s+=5)
+    { radiusList.push_back( s ); }
+
+  std::cout << "#radius" << "\t"
+            << "rep" << "\t"
+            << "md" << "\t"
+            << "hd" << "\t"
+            << "me" << "\t"
+            << "he" << std::endl;
+
+  for( std::vector< int >::iterator it=radiusList.begin(); it !=radiusList.end() ; it++)
+    {
+    itk::TimeProbe mdtime;
+    itk::TimeProbe hdtime;
+    itk::TimeProbe metime;
+    itk::TimeProbe hetime;
+
+    SRType::RadiusType rad;
+    rad.Fill( *it );
+    SRType kernel = SRType::Ball( rad );
+
+    mdilate->SetKernel( kernel );
+    hdilate->SetKernel( kernel );
+    merode->SetKernel( kernel );
+    herode->SetKernel( kernel );
+
+    int nbOfRepeats = 5;
+
+    for( int i=0; i<nbOfRepeats; i++ )
+      {
+      mdtime.Start();
+      mdilate->Update();
+      mdtime.Stop();
+      mdilate->Modified();
+
+      hdtime.Start();
+      hdilate->Update();
+      hdtime.Stop();
+      hdilate->Modified();
+
+      metime.Start();
+      merode->Update();
+      metime.Stop();
+      merode->Modified();
+
+      hetime.Start();
+      herode->Update();
+      hetime.Stop();
+      herode->Modified();
+      }
+
+    std::cout << *it << "\t"
+              << nbOfRepeats << "\t"
+              << mdtime.GetMeanTime() << "\t"
+              << hdtime.GetMeanTime() << "\t"
+              << metime.GetMeanTime() << "\t"
+              << hetime.GetMeanTime() << std::endl;
+    }
+
+
+  return 0;
+}
+
@@ -0,0 +1,119 @@
+#include "itkImageFileReader.h"
+#include "itkShiftScaleImageFilter.h"
+#include "itkMovingHistogramDilateImageFilter.h"
+#include "itkMovingHistogramErodeImageFilter.h"
+#include "itkFlatStructuringElement.h"
+#include "itkTimeProbe.h"
+#include <vector>
+#include "itkMultiThreader.h"
+
+int main(int, char * argv[])
+{
+  itk::MultiThreader::SetGlobalMaximumNumberOfThreads(1);
+
+  const int dim = 2;
+  typedef unsigned short PType;
+  typedef itk::Image< PType, dim >    IType;
+
+  // read the input image
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+
+  // spread the 8 bits values over the full 16 bits range, to get a sparse
+  // histogram like the ones of the real 12 or 16 bits images
+  typedef itk::ShiftScaleImageFilter< IType, IType > ScaleType;
+  ScaleType::Pointer scale = ScaleType::New();
+  scale->SetInput( reader->GetOutput() );
+  scale->SetScale( 257 );
+
+  typedef itk::FlatStructuringElement< dim > SRType;
+
+  typedef itk::MovingHistogramDilateImageFilter< IType, IType, SRType > HDilateType;
+  HDilateType::Pointer hdilate = HDilateType::New();
+  hdilate->SetInput( scale->GetOutput() );
+
+  typedef itk::MovingHistogramErodeImageFilter< IType, IType, SRType > HErodeType;
+  HErodeType::Pointer herode = HErodeType::New();
+  herode->SetInput( scale->GetOutput() );
+
+  // the vector based histogram, with a linear scan of the empty bins, as
+  // reference
+  typedef itk::MovingHistogramMorphologyImageFilter< IType, IType, SRType, itk::Function::MorphologyVectorHistogram< PType, std::greater< PType > > > LDilateType;
+  LDilateType::Pointer ldilate = LDilateType::New();
+  ldilate->SetInput( scale->GetOutput() );
+  ldilate->SetBoundary( itk::NumericTraits< PType >::NonpositiveMin() );
+
+  typedef itk::MovingHistogramMorphologyImageFilter< IType, IType, SRType, itk::Function::MorphologyVectorHistogram< PType, std::less< PType > > > LErodeType;
+  LErodeType::Pointer lerode = LErodeType::New();
+  lerode->SetInput( scale->GetOutput() );
+  lerode->SetBoundary( itk::NumericTraits< PType >::max() );
+
+  scale->Update();
+
+  std::vector< int > radiusList;
+  for( int s=1; s<=10; s++)
+    { radiusList.push_back( s ); }
+  for( int s=15; s<=30; s+=5)
+    { radiusList.push_back( s ); }
+
+  std::cout << "#radius" << "\t"
+            << "rep" << "\t"
+            << "ld" << "\t"
+            << "hd" << "\t"
+            << "le" << "\t"
+            << "he" << std::endl;
+
+  for( std::vector< int >::iterator it=radiusList.begin(); it !=radiusList.end() ; it++)
+    {
+    itk::TimeProbe ldtime;
+    itk::TimeProbe hdtime;
+    itk::TimeProbe letime;
+    itk::TimeProbe hetime;
+
+    SRType::RadiusType rad;
+    rad.Fill( *it );
+    SRType kernel = SRType::Ball( rad );
+
+    ldilate->SetKernel( kernel );
+    hdilate->SetKernel( kernel );
+    lerode->SetKernel( kernel );
+    herode->SetKernel( kernel );
+
+    int nbOfRepeats = 5;
+
+    for( int i=0; i<nbOfRepeats; i++ )
+      {
+      ldtime.Start();
+      ldilate->Update();
+      ldtime.Stop();
+      ldilate->Modified();
+
+      hdtime.Start();
+      hdilate->Update();
+      hdtime.Stop();
+      hdilate->Modified();
+
+      letime.Start();
+      lerode->Update();
+      letime.Stop();
+      lerode->Modified();
+
+      hetime.Start();
+      herode->Update();
+      hetime.Stop();
+      herode->Modified();
+      }
+
+    std::cout << *it << "\t"
+              << nbOfRepeats << "\t"
+              << ldtime.GetMeanTime() << "\t"
+              << hdtime.GetMeanTime() << "\t"
+              << letime.GetMeanTime() << "\t"
+              << hetime.GetMeanTime() << std::endl;
+    }
+
+
+  return 0;
+}
+
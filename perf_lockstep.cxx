@@ -0,0 +1,66 @@
+#include "itkImageFileReader.h"
+#include "itkMovingHistogramDilateImageFilter.h"
+#include "itkFlatStructuringElement.h"
+#include "itkTimeProbe.h"
+#include <vector>
+#include "itkMultiThreader.h"
+
+int main(int, char * argv[])
+{
+  itk::MultiThreader::SetGlobalMaximumNumberOfThreads(1);
+
+  const int dim = 2;
+  typedef unsigned char PType;
+  typedef itk::Image< PType, dim >    IType;
+
+  // read the input image
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+  reader->Update();
+
+  typedef itk::FlatStructuringElement< dim > SRType;
+
+  typedef itk::MovingHistogramDilateImageFilter< IType, IType, SRType > DilateType;
+  DilateType::Pointer dilate = DilateType::New();
+  dilate->SetInput( reader->GetOutput() );
+
+  std::vector< unsigned int > linesList;
+  linesList.push_back( 1 );
+  linesList.push_back( 2 );
+  linesList.push_back( 4 );
+  linesList.push_back( 8 );
+
+  std::cout << "#radius" << "\t"
+            << "rep";
+  for( std::vector< unsigned int >::iterator lit=linesList.begin(); lit!=linesList.end(); lit++ )
+    { std::cout << "\t" << "l" << *lit; }
+  std::cout << std::endl;
+
+  for( int r=1; r<=20; r++ )
+    {
+    SRType::RadiusType rad;
+    rad.Fill( r );
+    dilate->SetKernel( SRType::Ball( rad ) );
+
+    int nbOfRepeats = 5;
+    std::cout << r << "\t" << nbOfRepeats;
+
+    for( std::vector< unsigned int >::iterator lit=linesList.begin(); lit!=linesList.end(); lit++ )
+      {
+      itk::TimeProbe time;
+      dilate->SetNumberOfLockStepLines( *lit );
+      for( int i=0; i<nbOfRepeats; i++ )
+        {
+        time.Start();
+        dilate->Update();
+        time.Stop();
+        dilate->Modified();
+        }
+      std::cout << "\t" << time.GetMeanTime();
+      }
+    std::cout << std::endl;
+    }
+
+  return 0;
+}
@@ -0,0 +1,103 @@
+#include "itkImageFileReader.h"
+#include "itkShiftScaleImageFilter.h"
+#include "itkMovingHistogramDilateImageFilter.h"
+#include "itkMovingHistogramRankImageFilter.h"
+#include "itkFlatStructuringElement.h"
+#include "itkTimeProbe.h"
+#include <vector>
+#include "itkMultiThreader.h"
+
+int main(int, char * argv[])
+{
+  itk::MultiThreader::SetGlobalMaximumNumberOfThreads(1);
+
+  const int dim = 2;
+  typedef unsigned short PType;
+  typedef itk::Image< PType, dim >    IType;
+
+  // read the input image
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+
+  // spread the 8 bits values over the full 16 bits range
+  typedef itk::ShiftScaleImageFilter< IType, IType > ScaleType;
+  ScaleType::Pointer scale = ScaleType::New();
+  scale->SetInput( reader->GetOutput() );
+  scale->SetScale( 257 );
+
+  typedef itk::FlatStructuringElement< dim > SRType;
+
+  typedef itk::MovingHistogramDilateImageFilter< IType, IType, SRType > DilateType;
+  DilateType::Pointer dilate = DilateType::New();
+  dilate->SetInput( scale->GetOutput() );
+
+  // the Fenwick tree based median
+  typedef itk::MovingHistogramRankImageFilter< IType, IType, SRType > RankType;
+  RankType::Pointer median = RankType::New();
+  median->SetInput( scale->GetOutput() );
+  median->SetRank( 0.5 );
+
+  // the map based median, as reference
+  typedef itk::MovingHistogramImageFilter< IType, IType, SRType, itk::Function::RankMapHistogram< PType > > MapRankType;
+  MapRankType::Pointer mmedian = MapRankType::New();
+  mmedian->SetInput( scale->GetOutput() );
+
+  scale->Update();
+
+  std::vector< int > radiusList;
+  for( int s=1; s<=10; s++)
+    { radiusList.push_back( s ); }
+  for( int s=15; s<=30; s+=5)
+    { radiusList.push_back( s ); }
+
+  std::cout << "#radius" << "\t"
+            << "rep" << "\t"
+            << "d" << "\t"
+            << "med" << "\t"
+            << "mmed" << std::endl;
+
+  for( std::vector< int >::iterator it=radiusList.begin(); it !=radiusList.end() ; it++)
+    {
+    itk::TimeProbe dtime;
+    itk::TimeProbe medtime;
+    itk::TimeProbe mmedtime;
+
+    SRType::RadiusType rad;
+    rad.Fill( *it );
+    SRType kernel = SRType::Ball( rad );
+
+    dilate->SetKernel( kernel );
+    median->SetKernel( kernel );
+    mmedian->SetKernel( kernel );
+
+    int nbOfRepeats = 5;
+
+    for( int i=0; i<nbOfRepeats; i++ )
+      {
+      dtime.Start();
+      dilate->Update();
+      dtime.Stop();
+      dilate->Modified();
+
+      medtime.Start();
+      median->Update();
+      medtime.Stop();
+      median->Modified();
+
+      mmedtime.Start();
+      mmedian->Update();
+      mmedtime.Stop();
+      mmedian->Modified();
+      }
+
+    std::cout << *it << "\t"
+              << nbOfRepeats << "\t"
+              << dtime.GetMeanTime() << "\t"
+              << medtime.GetMeanTime() << "\t"
+              << mmedtime.GetMeanTime() << std::endl;
+    }
+
+
+  return 0;
+}
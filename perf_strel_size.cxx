@@ -7,6 +7,8 @@
 #include "itkMovingHistogramMorphologicalGradientImageFilter.h"
 #include "itkMorphologicalGradientImageFilter.h"
 #include "itkNeighborhood.h"
+#include "itkGrayscaleDilateImageFilter.h"
+#include "itkFlatStructuringElement.h"
 #include "itkTimeProbe.h"
 #include <vector>
 #include "itkMultiThreader.h"
@@ -103,6 +105,72 @@ int main(int, char * argv[])
               << hdtime.GetMeanTime() << std::endl;
     }
   
+  // the balls and the annulus can't be decomposed: compare the moving
+  // histogram and the chords, to check the choice made by
+  // GrayscaleDilateImageFilter::SetKernel()
+  typedef itk::FlatStructuringElement< dim > FlatSRType;
+  typedef itk::GrayscaleDilateImageFilter< IType, IType, FlatSRType > GDilateType;
+  GDilateType::Pointer gdilate = GDilateType::New();
+  gdilate->SetInput( reader->GetOutput() );
+  // only used to get the number of pixels per translation
+  typedef itk::MovingHistogramDilateImageFilter< IType, IType, FlatSRType > FHDilateType;
+  FHDilateType::Pointer fhdilate = FHDilateType::New();
+
+  std::cout << std::endl;
+  std::cout << "#shape" << "\t" 
+            << "radius" << "\t" 
+            << "hnb" << "\t" 
+            << "cost" << "\t" 
+            << "algo" << "\t" 
+            << "hd" << "\t" 
+            << "cd" << std::endl;
+
+  for( int shape=0; shape<2; shape++ )
+    {
+    for( std::vector< int >::iterator it=radiusList.begin(); it !=radiusList.end() ; it++)
+      {
+      if( *it == 0 )
+        { continue; }
+      itk::TimeProbe hdtime;
+      itk::TimeProbe cdtime;
+
+      FlatSRType::RadiusType radius;
+      radius.Fill( *it );
+      FlatSRType fkernel;
+      if( shape == 0 )
+        { fkernel = FlatSRType::Ball( radius ); }
+      else
+        { fkernel = FlatSRType::Annulus( radius ); }
+
+      gdilate->SetKernel( fkernel );
+      // the algorithm selected by SetKernel()
+      int algo = gdilate->GetAlgorithm();
+
+      int nbOfRepeats = 5;
+      for( int i=0; i<nbOfRepeats; i++ )
+        {
+        gdilate->SetAlgorithm( GDilateType::HISTO );
+        hdtime.Start();
+        gdilate->Update();
+        hdtime.Stop();
+        gdilate->Modified();
+        gdilate->SetAlgorithm( GDilateType::CHORD );
+        cdtime.Start();
+        gdilate->Update();
+        cdtime.Stop();
+        gdilate->Modified();
+        }
+
+      fhdilate->SetKernel( fkernel );
+      std::cout << ( shape == 0 ? "ball" : "annulus" ) << "\t" 
+                << *it << "\t" 
+                << fhdilate->GetPixelsPerTranslation() << "\t" 
+                << GDilateType::ChordFilterType::EstimateCost( fkernel ) << "\t" 
+                << algo << "\t" 
+                << hdtime.GetMeanTime() << "\t" 
+                << cdtime.GetMeanTime() << std::endl;
+      }
+    }
   
   return 0;
 }
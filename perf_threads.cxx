@@ -7,7 +7,9 @@
 #include "itkTimeProbe.h"
 #include <vector>
 #include "itkFlatStructuringElement.h"
+#include "itkMultiThreader.h"
 #include <iomanip>
+#include <algorithm>
 
 int main(int, char * argv[])
 {
@@ -30,6 +32,12 @@ int main(int, char * argv[])
   hdilate->SetInput( reader->GetOutput() );
   hdilate->SetKernel( kernel );
   
+  // the same, with the static split of the output region
+  HDilateType::Pointer shdilate = HDilateType::New();
+  shdilate->SetInput( reader->GetOutput() );
+  shdilate->SetKernel( kernel );
+  shdilate->WorkStealingOff();
+  
   typedef itk::BasicDilateImageFilter< IType, IType, SRType > DilateType;
   DilateType::Pointer dilate = DilateType::New();
   dilate->SetInput( reader->GetOutput() );
@@ -56,18 +64,28 @@ int main(int, char * argv[])
   std::cout << "#nb" << "\t" 
             << "d" << "\t" 
             << "hd" << "\t"
+            << "shd" << "\t"
             << "ad" << "\t"
-            << "vhd" << std::endl;
+            << "vhd" << "\t"
+            << "hd_speedup" << "\t"
+            << "shd_speedup" << std::endl;
+
+  // the time with one thread, to compute the speedups
+  double htime1 = 0;
+  double shtime1 = 0;
 
-  for( int t=1; t<=10; t++ )
+  const int nbOfThreads = std::max( itk::MultiThreader::GetGlobalDefaultNumberOfThreads(), 10 );
+  for( int t=1; t<=nbOfThreads; t++ )
     {
     itk::TimeProbe time;
     itk::TimeProbe htime;
+    itk::TimeProbe shtime;
     itk::TimeProbe vhtime;
     itk::TimeProbe atime;
   
     dilate->SetNumberOfThreads( t );
     hdilate->SetNumberOfThreads( t );
+    shdilate->SetNumberOfThreads( t );
     vhdilate->SetNumberOfThreads( t );
     adilate->SetNumberOfThreads( t );
     
@@ -81,6 +99,10 @@ int main(int, char * argv[])
       hdilate->Update();
       htime.Stop();
       
+      shtime.Start();
+      shdilate->Update();
+      shtime.Stop();
+      
       vhtime.Start();
       vhdilate->Update();
       vhtime.Stop();
@@ -91,15 +113,25 @@ int main(int, char * argv[])
       
       dilate->Modified();
       hdilate->Modified();
+      shdilate->Modified();
       vhdilate->Modified();
       adilate->Modified();
       }
       
+    if( t == 1 )
+      {
+      htime1 = htime.GetMeanTime();
+      shtime1 = shtime.GetMeanTime();
+      }
+      
     std::cout << std::setprecision(3) << t << "\t" 
               << time.GetMeanTime() << "\t"
               << htime.GetMeanTime() << "\t"
+              << shtime.GetMeanTime() << "\t"
               << atime.GetMeanTime() << "\t"
-              << vhtime.GetMeanTime() << std::endl;
+              << vhtime.GetMeanTime() << "\t"
+              << htime1 / htime.GetMeanTime() << "\t"
+              << shtime1 / shtime.GetMeanTime() << std::endl;
     }
   
   
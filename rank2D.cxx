@@ -0,0 +1,86 @@
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkMovingHistogramRankImageFilter.h"
+#include "itkFlatStructuringElement.h"
+#include "itkSimpleFilterWatcher.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include <vector>
+#include <algorithm>
+
+
+int main(int, char * argv[])
+{
+  const int dim = 2;
+  typedef unsigned char PType;
+  typedef itk::Image< PType, dim >    IType;
+  
+  // read the input image
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+  
+  typedef itk::FlatStructuringElement<dim> SRType;
+  SRType::RadiusType radius;
+  radius.Fill( 4 );
+  SRType kernel = SRType::Box( radius );
+  
+  typedef itk::MovingHistogramRankImageFilter< IType, IType, SRType > RankType;
+  RankType::Pointer rank = RankType::New();
+  rank->SetInput( reader->GetOutput() );
+  rank->SetKernel( kernel );
+  
+  itk::SimpleFilterWatcher watcher(rank, "filter");
+
+  typedef itk::ImageFileWriter< IType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( rank->GetOutput() );
+
+  // the lowest value is the erosion
+  rank->SetRank( 0.0 );
+  writer->SetFileName( argv[2] );
+  writer->Update();
+
+  // the highest value is the dilation
+  rank->SetRank( 1.0 );
+  writer->SetFileName( argv[3] );
+  writer->Update();
+
+  // the median
+  rank->SetRank( 0.5 );
+  writer->SetFileName( argv[4] );
+  writer->Update();
+
+  // compare the median with a brute force median of the same kernel; the
+  // pixels outside the image are ignored
+  const IType * input = reader->GetOutput();
+  const IType * output = rank->GetOutput();
+  const IType::RegionType region = input->GetLargestPossibleRegion();
+  std::vector< PType > values;
+  typedef itk::ImageRegionConstIteratorWithIndex< IType > IteratorType;
+  IteratorType it( output, region );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    values.clear();
+    IType::IndexType idx;
+    for( idx[1] = it.GetIndex()[1] - radius[1]; idx[1] <= it.GetIndex()[1] + (long)radius[1]; idx[1]++ )
+      {
+      for( idx[0] = it.GetIndex()[0] - radius[0]; idx[0] <= it.GetIndex()[0] + (long)radius[0]; idx[0]++ )
+        {
+        if( region.IsInside( idx ) )
+          { values.push_back( input->GetPixel( idx ) ); }
+        }
+      }
+    // the same target as the rank histograms
+    const unsigned long target = static_cast< unsigned long >( 0.5f * ( values.size() - 1 ) );
+    std::nth_element( values.begin(), values.begin() + target, values.end() );
+    if( it.Get() != values[ target ] )
+      {
+      std::cerr << "wrong median at " << it.GetIndex() << ": " << (int)it.Get()
+                << " instead of " << (int)values[ target ] << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return 0;
+}
+
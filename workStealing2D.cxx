@@ -0,0 +1,115 @@
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkCastImageFilter.h"
+#include "itkMovingHistogramDilateImageFilter.h"
+#include "itkMovingHistogramRankImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkFlatStructuringElement.h"
+#include "itkSimpleFilterWatcher.h"
+
+
+// compare the outputs of a filter computed with and without work stealing.
+// The filter is updated twice in each mode, so the histograms of the
+// second run are the ones of the pool, copied from an histogram reset
+// after the first run.
+template< class TFilter >
+bool SameOutputsWithWorkStealing( TFilter * filter )
+{
+  typedef typename TFilter::OutputImageType ImageType;
+  filter->SetNumberOfThreads( 4 );
+
+  filter->WorkStealingOff();
+  filter->Update();
+  filter->Modified();
+  filter->Update();
+  typename ImageType::Pointer reference = filter->GetOutput();
+  reference->DisconnectPipeline();
+
+  filter->WorkStealingOn();
+  filter->Update();
+  filter->Modified();
+  filter->Update();
+
+  typedef itk::ImageRegionConstIterator< ImageType > IteratorType;
+  IteratorType refIt( reference, reference->GetBufferedRegion() );
+  IteratorType it( filter->GetOutput(), filter->GetOutput()->GetBufferedRegion() );
+  for( refIt.GoToBegin(), it.GoToBegin(); !refIt.IsAtEnd(); ++refIt, ++it )
+    {
+    if( refIt.Get() != it.Get() )
+      { return false; }
+    }
+  return true;
+}
+
+
+int main(int, char * argv[])
+{
+  const int dim = 2;
+  typedef unsigned char PType;
+  typedef itk::Image< PType, dim >    IType;
+  
+  // read the input image
+  typedef itk::ImageFileReader< IType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+  
+  typedef itk::FlatStructuringElement<dim> SRType;
+  SRType::RadiusType radius;
+  radius.Fill( 4 );
+  SRType kernel = SRType::Box( radius );
+  
+  typedef itk::MovingHistogramDilateImageFilter< IType, IType, SRType > DilateType;
+  DilateType::Pointer dilate = DilateType::New();
+  dilate->SetInput( reader->GetOutput() );
+  dilate->SetKernel( kernel );
+  
+  itk::SimpleFilterWatcher watcher(dilate, "dilate");
+
+  if( !SameOutputsWithWorkStealing( dilate.GetPointer() ) )
+    {
+    std::cerr << "the dilations with and without work stealing differ" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  typedef itk::ImageFileWriter< IType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( dilate->GetOutput() );
+  writer->SetFileName( argv[2] );
+  writer->Update();
+
+  // the median uses a Fenwick tree, which only copies the changed blocks
+  typedef itk::MovingHistogramRankImageFilter< IType, IType, SRType > RankType;
+  RankType::Pointer rank = RankType::New();
+  rank->SetInput( reader->GetOutput() );
+  rank->SetKernel( kernel );
+  rank->SetRank( 0.5 );
+  
+  itk::SimpleFilterWatcher watcher2(rank, "rank");
+
+  if( !SameOutputsWithWorkStealing( rank.GetPointer() ) )
+    {
+    std::cerr << "the medians with and without work stealing differ" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // 16 bits pixels use the bitmap histogram
+  typedef itk::Image< unsigned short, dim > UShortImageType;
+  typedef itk::CastImageFilter< IType, UShortImageType > CastType;
+  CastType::Pointer cast = CastType::New();
+  cast->SetInput( reader->GetOutput() );
+
+  typedef itk::MovingHistogramDilateImageFilter< UShortImageType, UShortImageType, SRType > UShortDilateType;
+  UShortDilateType::Pointer ushortDilate = UShortDilateType::New();
+  ushortDilate->SetInput( cast->GetOutput() );
+  ushortDilate->SetKernel( kernel );
+
+  itk::SimpleFilterWatcher watcher3(ushortDilate, "ushortDilate");
+
+  if( !SameOutputsWithWorkStealing( ushortDilate.GetPointer() ) )
+    {
+    std::cerr << "the 16 bits dilations with and without work stealing differ" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return 0;
+}